@@ -0,0 +1,215 @@
+# Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+#                    Technische Universitaet Braunschweig, Germany
+#                    www.tu-braunschweig.de/en/eis
+#
+# Use of this source code is governed by an MIT-style
+# license that can be found in the LICENSE file or at
+# https://opensource.org/licenses/MIT
+#
+"""
+ISS throughput benchmark
+
+Builds and runs each workload (apps/<workload>, yololite: small fixed net nets/bench) for each
+hardware configuration CLUSTERSxUNITSxLANES in release mode without GUI. The apps are compiled for
+their geometry (VPRO_CFG), each configuration is a separate build (own build directory, CLUSTERS /
+UNITS / LANES make variables), LANES has to be 2 (lane mask encoding). The ISS prints one summary
+line at exit (--benchmark, #SIM_BENCHMARK: simulated cycles, host wall time, cycles / s, peak RSS),
+collected into a JSON result file. Optionally compared against a stored baseline:
+- cycles / s may drop, peak RSS may grow by the relative tolerance
+- simulated cycles have to match (timing of the simulated hardware changed otherwise)
+Baselines are only comparable on the same host (and load).
+
+--check-threads: determinism check of the parallel cluster ticking, each workload and configuration
+runs with and without --cluster-threads, the result digests (#SIM_DIGEST: output data, simulated
+time, lane statistics, local memories) have to match.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+
+APPS_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+WORKLOADS = ["fir", "fft", "conv2dadd", "indirect_addressing", "yololite"]
+
+SUMMARY = re.compile(r"#SIM_BENCHMARK: (\{.*\})")
+DIGEST = re.compile(r"#SIM_DIGEST: ([0-9a-f]+)")
+
+
+def parse_config(config):
+    clusters, units, lanes = (int(v) for v in config.split("x"))
+    if lanes != 2:
+        sys.exit("%s: the lane mask encodes exactly 2 lanes" % config)
+    return clusters, units, lanes
+
+
+def command(workload, config, sim_args=""):
+    clusters, units, lanes = parse_config(config)
+    hw = ["CLUSTERS=%d" % clusters, "UNITS=%d" % units, "LANES=%d" % lanes,
+          "SIM_ARGS=" + " ".join(["--benchmark"] + sim_args.split())]
+    if workload == "yololite":
+        # own build dirs per configuration, netgen output depends on the configuration
+        blob = os.path.join(APPS_DIR, "yololite/nets/bench/generated/eisvblob.bin")
+        if os.path.exists(blob):
+            os.remove(blob)
+        return ["make", "-C", os.path.join(APPS_DIR, "yololite"), "sim_bench",
+                "BUILD_SIM=sim/build_bench_" + config,
+                "BUILD_NETGEN=netgen/build_bench_" + config] + hw
+    return ["make", "-C", os.path.join(APPS_DIR, workload), "console",
+            "build_release=build_bench_" + config] + hw
+
+
+def run(workload, config, log_dir, sim_args="", suffix=""):
+    log_file = os.path.join(log_dir, "%s_%s%s.log" % (workload, config, suffix))
+    with open(log_file, "w") as log:
+        status = subprocess.run(command(workload, config, sim_args), stdout=log,
+                                stderr=subprocess.STDOUT, text=True).returncode
+    summary = None
+    with open(log_file, errors="replace") as log:
+        for line in log:
+            match = SUMMARY.search(line)
+            if match:
+                summary = json.loads(match.group(1))
+    if summary is None:
+        print("  %-20s %-8s FAILED (exit %d, no summary, see %s)" % (workload, config, status,
+                                                                     log_file))
+        return {"workload": workload, "config": config, "status": "failed"}
+    summary.update({"workload": workload, "config": config, "status": "ok"})
+    print("  %-20s %-8s %14.0f cycles %10.3f s %12.0f cycles/s %10d kB" % (
+        workload, config, summary["risc_cycles"], summary["host_s"], summary["cycles_per_s"],
+        summary["peak_rss_kb"]))
+    return summary
+
+
+def digest(workload, config, log_dir, sim_args, suffix):
+    run(workload, config, log_dir, sim_args + " --state-digest", suffix)
+    log_file = os.path.join(log_dir, "%s_%s%s.log" % (workload, config, suffix))
+    with open(log_file, errors="replace") as log:
+        for line in log:
+            match = DIGEST.search(line)
+            if match:
+                return match.group(1)
+    return None
+
+
+def check_threads(workloads, configs, log_dir):
+    # sequential and parallel cluster ticking have to give the identical result
+    print("Determinism check --cluster-threads:")
+    failures = 0
+    for workload in workloads:
+        for config in configs:
+            sequential = digest(workload, config, log_dir, "", "_digest")
+            threaded = digest(workload, config, log_dir, "--cluster-threads", "_digest_threads")
+            ok = sequential is not None and sequential == threaded
+            failures += not ok
+            print("  %-20s %-8s %s %s %s" % (workload, config, sequential, threaded,
+                                            "ok" if ok else "MISMATCH"))
+    return failures
+
+
+def best_of(results):
+    # shortest host time of the repetitions, highest RSS
+    ok = [r for r in results if r["status"] == "ok"]
+    if not ok:
+        return results[-1]
+    best = dict(min(ok, key=lambda r: r["host_s"]))
+    best["peak_rss_kb"] = max(r["peak_rss_kb"] for r in ok)
+    best["repetitions"] = len(ok)
+    return best
+
+
+def git_revision():
+    try:
+        return subprocess.run(["git", "-C", APPS_DIR, "rev-parse", "--short", "HEAD"],
+                              capture_output=True, text=True).stdout.strip()
+    except OSError:
+        return ""
+
+
+def compare(results, baseline, tolerance):
+    reference = {(r["workload"], r["config"]): r for r in baseline["results"]}
+    failures = 0
+    print("Comparison against baseline (%s, %s), tolerance %.1f%%:" % (
+        baseline.get("host", "?"), baseline.get("revision", "?"), 100 * tolerance))
+    for result in results:
+        key = (result["workload"], result["config"])
+        ref = reference.get(key)
+        if ref is None or ref["status"] != "ok":
+            print("  %-20s %-8s no baseline" % key)
+            continue
+        if result["status"] != "ok":
+            print("  %-20s %-8s FAILED" % key)
+            failures += 1
+            continue
+        speed = result["cycles_per_s"] / ref["cycles_per_s"] - 1
+        rss = result["peak_rss_kb"] / ref["peak_rss_kb"] - 1
+        verdict = []
+        if result["risc_cycles"] != ref["risc_cycles"]:
+            verdict.append("simulated cycles %.0f -> %.0f" % (ref["risc_cycles"],
+                                                              result["risc_cycles"]))
+        if speed < -tolerance:
+            verdict.append("slower")
+        if rss > tolerance:
+            verdict.append("more memory")
+        failures += len(verdict) > 0
+        print("  %-20s %-8s cycles/s %+7.1f%%  peak RSS %+7.1f%%  %s" % (
+            key + (100 * speed, 100 * rss, ", ".join(verdict) if verdict else "ok")))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--configs", nargs="+", default=["1x1x2", "2x2x2", "4x4x2", "8x8x2"],
+                        help="hardware configurations CLUSTERSxUNITSxLANES")
+    parser.add_argument("--workloads", nargs="+", default=WORKLOADS, choices=WORKLOADS)
+    parser.add_argument("--repeat", type=int, default=1,
+                        help="runs per workload and configuration, the fastest one is kept")
+    parser.add_argument("--output", default="results.json", help="result file (JSON)")
+    parser.add_argument("--baseline", default="baseline.json", help="baseline file (JSON)")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="relative tolerance of cycles / s and peak RSS")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="store the results as new baseline instead of comparing")
+    parser.add_argument("--log-dir", default="logs", help="build and simulation output")
+    parser.add_argument("--check-threads", action="store_true",
+                        help="only compare the results with and without --cluster-threads")
+    args = parser.parse_args()
+
+    os.makedirs(args.log_dir, exist_ok=True)
+    if args.check_threads:
+        return 1 if check_threads(args.workloads, args.configs, args.log_dir) else 0
+    results = []
+    for workload in args.workloads:
+        for config in args.configs:
+            parse_config(config)
+            results.append(best_of([run(workload, config, args.log_dir)
+                                    for _ in range(args.repeat)]))
+
+    report = {
+        "host": platform.node(),
+        "machine": platform.machine(),
+        "revision": git_revision(),
+        "date": datetime.datetime.now().isoformat(timespec="seconds"),
+        "results": results,
+    }
+    output = args.baseline if args.update_baseline else args.output
+    with open(output, "w") as file:
+        json.dump(report, file, indent=2)
+    print("Results in %s" % output)
+
+    failed = sum(r["status"] != "ok" for r in results)
+    if args.update_baseline or not os.path.exists(args.baseline):
+        return 1 if failed else 0
+    with open(args.baseline) as file:
+        baseline = json.load(file)
+    return 1 if compare(results, baseline, args.tolerance) or failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
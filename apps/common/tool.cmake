@@ -0,0 +1,103 @@
+# Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+#                    Technische Universitaet Braunschweig, Germany
+#                    www.tu-braunschweig.de/en/eis
+# 
+# Use of this source code is governed by an MIT-style
+# license that can be found in the LICENSE file or at
+# https://opensource.org/licenses/MIT
+# 
+#
+# common CMAKE part of the ISS tools (apps/replay, apps/microbench), included by their CMakeLists.txt
+#   paths relative to the including tool directory (apps/<tool>)
+#   includes libs (sim, aux)
+#   defines executable (sim) from the tool's main.cpp
+#
+
+#############################################################################################
+# Compiler FLAGS
+#############################################################################################
+macro(use_cxx11)
+    if (CMAKE_VERSION VERSION_LESS "3.1")
+        if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=gnu++20")
+        endif ()
+    else ()
+        set(CMAKE_CXX_STANDARD 20)
+    endif ()
+endmacro(use_cxx11)
+use_cxx11()
+set(GFLAG -std=c++2a)
+
+set(CMAKE_CXX_FLAGS "-Wall -Wextra -Wno-unused-parameter")
+set(CMAKE_CXX_FLAGS_DEBUG "-g")
+set(CMAKE_CXX_FLAGS_RELEASE "-O3")
+
+#############################################################################################
+# Paths and Files
+#############################################################################################
+# libs
+set(VPRO_SIMULATOR_LIB_dir "${CMAKE_CURRENT_SOURCE_DIR}/../../iss_lib")
+set(VPRO_AUX_LIB_dir "${CMAKE_CURRENT_SOURCE_DIR}/../../common_lib")
+
+# check paths (cmake fails if this file is not found)
+file(SIZE ${CMAKE_CURRENT_SOURCE_DIR}/../../common_lib/vpro.h vpro_common_include_file)
+
+set(PlainIncludeDirs
+        ${CMAKE_CURRENT_SOURCE_DIR}/../../iss_lib/
+        ${CMAKE_CURRENT_SOURCE_DIR}/../../common_lib/
+        )
+
+#############################################################################################
+# Definitions
+#############################################################################################
+# set HW config via defines
+if(NOT DEFINED CLUSTERS)
+    set(CLUSTERS 1)
+endif(NOT DEFINED CLUSTERS)
+if(NOT DEFINED UNITS)
+    set(UNITS 1)
+endif(NOT DEFINED UNITS)
+if(NOT DEFINED LANES)
+    set(LANES 2)
+endif(NOT DEFINED LANES)
+if(NOT DEFINED SCRIPTED)
+    set(SCRIPTED 1)
+endif(NOT DEFINED SCRIPTED)
+if(NOT DEFINED ISS_STANDALONE)
+    set(ISS_STANDALONE 1)
+endif(NOT DEFINED ISS_STANDALONE)
+if(NOT DEFINED SIMULATION)
+    set(SIMULATION 1)
+endif(NOT DEFINED SIMULATION)
+
+message(STATUS "using CLUSTERS=${CLUSTERS}")
+message(STATUS "using UNITS=${UNITS}")
+message(STATUS "using LANES=${LANES}")
+message(STATUS "using COMMENT=${PROJECT}")
+message(STATUS "using SCRIPTED=${SCRIPTED}")
+message(STATUS "using ISS_STANDALONE=${ISS_STANDALONE}")
+
+set(module sim)
+
+#############################################################################################
+# Executable (Standalone Sim App) or Library (Virtual Prototype App)
+#############################################################################################
+if (ISS_STANDALONE EQUAL 1)
+    add_executable(${module} main.cpp)
+else()
+    add_library(${module} SHARED main.cpp)
+endif ()
+
+target_compile_definitions(${module} PUBLIC -DNUM_VECTORLANES=${LANES} -DNUM_VU_PER_CLUSTER=${UNITS} -DNUM_CLUSTERS=${CLUSTERS})
+add_definitions(-DSCRIPTED=${SCRIPTED} -DSTAT_COMMENT=\"${PROJECT}\" -DSIMULATION=${SIMULATION} -DISS_STANDALONE=${ISS_STANDALONE})
+#target_compile_definitions(${module} PUBLIC SCRIPTED=${SCRIPTED} NUM_VU_PER_CLUSTER=${UNITS} NUM_CLUSTERS=${CLUSTERS} STAT_COMMENT=\"${PROJECT}\" SIMULATION=${SIMULATION} ISS_STANDALONE=${ISS_STANDALONE})
+
+# include dirs for libs
+target_include_directories(${module} PUBLIC ${PlainIncludeDirs})
+target_link_libraries(${module} VPRO_SIMULATOR_LIB)
+target_link_libraries(${module} VPRO_AUX_LIB)
+
+# includes VPRO_SIMULATOR_LIB library
+# after compile_definitions to include them there!
+add_subdirectory(${VPRO_SIMULATOR_LIB_dir} ${CMAKE_CURRENT_BINARY_DIR}/VPRO_SIMULATOR_LIB)
+add_subdirectory(${VPRO_AUX_LIB_dir} ${CMAKE_CURRENT_BINARY_DIR}/VPRO_AUX_LIB)
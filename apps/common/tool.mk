@@ -0,0 +1,73 @@
+# Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+#                    Technische Universitaet Braunschweig, Germany
+#                    www.tu-braunschweig.de/en/eis
+#
+# Use of this source code is governed by an MIT-style
+# license that can be found in the LICENSE file or at
+# https://opensource.org/licenses/MIT
+#
+# Common part of the ISS tool Makefiles (apps/replay, apps/microbench), included after the tool's
+# variables (APP_NAME, SIM_CLPARAMS) and help target
+# The tools load / store no data: no init / exit scripts and cfgs (the ISS warns that they are missing)
+
+#-------------------------------------------------------------------------------
+# Hardware definitions
+#-------------------------------------------------------------------------------
+# VPRO
+CLUSTERS	?= 2
+UNITS		?= 2
+LANES		?= 2
+# DCMA
+NR_RAMS		?= 8
+LINE_SIZE	?= 4096
+RAM_SIZE	?= 524288
+ASSOCIATIVITY	?= 4
+
+#-------------------------------------------------------------------------------
+# Application definitions
+#-------------------------------------------------------------------------------
+build ?= build
+build_release ?= build_release
+
+current_dir = $(shell pwd)
+PROJECT_NAME ?= $(current_dir)
+
+# pass configuration as parameters to cmake script
+ISS_FLAGS=-DCLUSTERS=${CLUSTERS} -DUNITS=${UNITS} -DLANES=${LANES} -DPROJECT=${PROJECT_NAME}
+ISS_FLAGS += -DNR_RAMS=${NR_RAMS} -DLINE_SIZE=${LINE_SIZE} -DASSOCIATIVITY=${ASSOCIATIVITY} -DRAM_SIZE=${RAM_SIZE}
+ISS_FLAGS += -DAPP_NAME=${APP_NAME} -DREPO_DIR=${REPO_DIR} -DISS_STANDALONE=1
+
+#-------------------------------------------------------------------------------
+# Simulator (ISS) Targets
+#-------------------------------------------------------------------------------
+.PHONY: dir sim release console
+dir:
+	mkdir -p ${build}
+	mkdir -p ${build_release}
+
+sim: dir
+	cmake -B ${build} ${ISS_FLAGS}
+	@$(MAKE) -s  -C ${build} sim -j
+	cd ${build} && ./sim ${SIM_CLPARAMS}
+
+release: dir
+	cmake -B ${build_release} -Wno-dev -DCMAKE_BUILD_TYPE=Release ${ISS_FLAGS}
+	$(MAKE) -s  -C ${build_release} sim -j
+	cd ${build_release} && ./sim ${SIM_CLPARAMS}
+
+console: dir
+	cmake -B ${build_release} -Wno-dev -DCMAKE_BUILD_TYPE=Release ${ISS_FLAGS}
+	$(MAKE) -s  -C ${build_release} sim -j
+	cd ${build_release} && ./sim --windowless ${SIM_CLPARAMS}
+
+#-------------------------------------------------------------------------------
+# Clean-up
+#-------------------------------------------------------------------------------
+.PHONY: clean
+clean:
+	@echo "\n\tCleaning up Simulator workspace..."
+	rm -rf ${build}
+	rm -rf ${build_release}*
+
+#-------------------------------------------------------------------------------
+# eof
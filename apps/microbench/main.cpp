@@ -0,0 +1,542 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+// ########################################################
+// # microbenchmarks of the ISS components                #
+// #                                                      #
+// # host ns and heap allocations per simulated element   #
+// # of the simulator building blocks, isolated from the  #
+// # application and the other clock domains             #
+// ########################################################
+//
+// ./sim --windowless [--filter=<part of the benchmark name>]
+//
+// fixed workloads (seeded), each run REPETITIONS times after one warm up, fastest run reported.
+// allocations: calls of the global operator new (Qt containers allocate by malloc, not counted)
+
+#include <vpro.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core_wrapper.h"
+#include "model/architecture/Cache.h"
+#include "model/architecture/Cluster.h"
+#include "model/architecture/DCMA.h"
+#include "model/architecture/DMA.h"
+#include "model/architecture/NonBlockingMainMemory.h"
+#include "model/architecture/RegisterFile.h"
+#include "model/architecture/bram.h"
+#include "model/architecture/unit/VectorLane.h"
+#include "model/architecture/unit/VectorUnit.h"
+#include "model/commands/CommandDMA.h"
+#include "model/commands/CommandVPRO.h"
+#include "simulator/ISS.h"
+
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+constexpr int REPETITIONS = 5;
+constexpr uint32_t SEED = 42;
+
+std::string filter;
+
+/**
+ * runs a fixed workload, prints host ns and allocations per simulated element
+ * @param element unit of the simulated elements
+ * @param body workload, returns the number of simulated elements
+ */
+void bench(const std::string& name, const char* element, const std::function<uint64_t()>& body) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+    body();  // warm up (first touch of memories, lazily created state)
+    double best_ns = 0;
+    uint64_t elements = 0;
+    uint64_t allocs = 0;
+    for (int r = 0; r < REPETITIONS; r++) {
+        uint64_t allocs_before = allocations.load(std::memory_order_relaxed);
+        auto begin = std::chrono::steady_clock::now();
+        elements = body();
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - begin)
+                        .count();
+        allocs += allocations.load(std::memory_order_relaxed) - allocs_before;
+        if (r == 0 || ns < best_ns) best_ns = ns;
+    }
+    if (elements == 0) {
+        printf_error("  %-32s no elements simulated!\n", name.c_str());
+        return;
+    }
+    printf("  %-32s %10" PRIu64 " %-12s %12.2f %12.3f\n",
+        name.c_str(),
+        elements,
+        element,
+        best_ns / double(elements),
+        double(allocs) / double(elements * REPETITIONS));
+}
+
+// ---------------------------------------------------------------------------------------------
+// VPRO lanes (ticked by their unit, like Cluster::tickVPRO)
+// ---------------------------------------------------------------------------------------------
+constexpr uint32_t X_END = 7, Y_END = 7;  // 8x8 elements per command
+constexpr int VPRO_COMMANDS = 64;
+
+addr_field_t addr(uint32_t offset, uint32_t alpha, uint32_t beta) {
+    addr_field_t field;
+    field.sel = SRC_SEL_ADDR;
+    field.offset = offset;
+    field.alpha = alpha;
+    field.beta = beta;
+    return field;
+}
+
+// small immediate (< 64, gamma part of the 3D immediate)
+addr_field_t imm(uint32_t value) {
+    addr_field_t field;
+    field.sel = SRC_SEL_IMM;
+    field.gamma = value & 0x3f;
+    return field;
+}
+
+// chaining source / indirect address (chain id in gamma, e.g. store from L0)
+addr_field_t chain(uint8_t sel, uint32_t id = 0) {
+    addr_field_t field;
+    field.sel = sel;
+    field.gamma = id;
+    field.chain_left = (sel == SRC_SEL_LEFT) || (sel == SRC_SEL_INDIRECT_LEFT);
+    field.chain_right = (sel == SRC_SEL_RIGHT) || (sel == SRC_SEL_INDIRECT_RIGHT);
+    field.chain_ls = (sel == SRC_SEL_LS) || (sel == SRC_SEL_INDIRECT_LS);
+    return field;
+}
+
+// as ISS::gen_io_vpro_command
+std::shared_ptr<CommandVPRO> vproCommand(uint32_t id_mask,
+    uint32_t func,
+    bool is_chain,
+    addr_field_t dst,
+    addr_field_t src1,
+    addr_field_t src2,
+    uint32_t x_end = X_END,
+    uint32_t y_end = Y_END) {
+    auto command = std::make_shared<CommandVPRO>();
+    command->id_mask = id_mask;
+    command->fu_sel = (func >> 4) & 0b11;
+    command->func = func & 0b1111;
+    command->is_chain = is_chain;
+    command->blocking = false;
+    command->flag_update = false;
+    command->dst = dst;
+    command->src1 = src1;
+    command->src2 = src2;
+    command->x_end = x_end;
+    command->y_end = y_end;
+    command->z_end = 0;
+    command->load_offset = 0;
+    command->updateType();
+    return command;
+}
+
+// lane elements of a command (each selected lane processes all x/y/z elements)
+uint64_t laneElements(const CommandVPRO& command) {
+    uint64_t lanes = 0;
+    if (command.isLS()) {
+        lanes = 1;
+    } else {
+        for (uint32_t l = 0; l < VPRO_CFG::LANES; l++) {
+            lanes += (command.id_mask >> l) & 1u;
+        }
+    }
+    return lanes * (command.x_end + 1) * (command.y_end + 1) * (command.z_end + 1);
+}
+
+/**
+ * feeds the commands (copied by the unit, as from Cluster::sendCMD) into the queue of the unit,
+ * ticks the unit until all are done
+ */
+uint64_t runUnit(
+    Unit::IVectorUnit& unit, const std::vector<std::shared_ptr<CommandVPRO>>& commands) {
+    uint64_t elements = 0;
+    uint64_t cycles = 0;
+    size_t next = 0;
+    while (next < commands.size() || unit.isBusy()) {
+        while (next < commands.size() && !unit.isCmdQueueFull()) {
+            if (!unit.trySendCMD(commands[next])) break;
+            elements += laneElements(*commands[next]);
+            next++;
+        }
+        unit.tick();
+        unit.update();
+        if (++cycles > 1000000) {
+            printf_error("  unit did not finish the commands (chaining?)\n");
+            return 0;
+        }
+    }
+    return elements;
+}
+
+void benchLanes(Unit::IVectorUnit& unit) {
+    const uint32_t all = (1u << VPRO_CFG::LANES) - 1;
+    std::mt19937 rng(SEED);
+
+    // defined register file / local memory content (no uninitialized access)
+    for (uint32_t l = 0; l < VPRO_CFG::LANES; l++) {
+        for (uint32_t a = 0; a < VPRO_CFG::RF_SIZE; a++) {
+            unit.getLanes()[l]->regFile.set_rf_data(int(a), rng() & 0xffffff);
+        }
+    }
+    for (uint32_t a = 0; a < 512; a++) {
+        unit.writeLocalMemoryData(a, rng() & 0xffff);
+    }
+    // offsets for indirect addressing (scatter into the register file)
+    constexpr uint32_t OFFSETS = 1024;
+    for (uint32_t a = 0; a < 64; a++) {
+        unit.writeLocalMemoryData(OFFSETS + a, rng() % VPRO_CFG::RF_SIZE);
+    }
+
+    auto repeat = [](std::initializer_list<std::shared_ptr<CommandVPRO>> group) {
+        std::vector<std::shared_ptr<CommandVPRO>> commands;
+        for (int c = 0; c < VPRO_COMMANDS; c++) {
+            commands.insert(commands.end(), group.begin(), group.end());
+        }
+        return commands;
+    };
+
+    auto add = repeat({vproCommand(all, FUNC_ADD, false, addr(0, 1, 8), addr(0, 1, 8), imm(3))});
+    auto mull = repeat(
+        {vproCommand(all, FUNC_MULL, false, addr(128, 1, 8), addr(0, 1, 8), addr(64, 1, 8))});
+    auto mac = repeat(
+        {vproCommand(all, FUNC_MACL, false, addr(128, 0, 0), addr(0, 1, 8), addr(64, 1, 8))});
+    auto shift = repeat(
+        {vproCommand(all, FUNC_SHIFT_AR, false, addr(128, 1, 8), addr(0, 1, 8), imm(2))});
+    auto load = repeat({vproCommand(LS, FUNC_LOAD, true, addr(0, 0, 0), addr(0, 1, 8), imm(0)),
+        vproCommand(all, FUNC_ADD, false, addr(0, 1, 8), chain(SRC_SEL_LS), imm(0))});
+    auto store = repeat({vproCommand(L0, FUNC_ADD, true, addr(0, 1, 8), addr(0, 1, 8), imm(0)),
+        vproCommand(LS, FUNC_STORE, false, chain(SRC_SEL_LEFT, 0), addr(256, 1, 8), imm(0))});
+    auto indirect = repeat(
+        {vproCommand(LS, FUNC_LOAD, true, addr(0, 0, 0), addr(OFFSETS, 1, 0), imm(0), 63, 0),
+            vproCommand(L0, FUNC_ADD, false, chain(SRC_SEL_INDIRECT_LS), imm(0), imm(5), 63, 0)});
+
+    bench("lane add (ALU)", "lane elem", [&]() { return runUnit(unit, add); });
+    bench("lane mull (ALU)", "lane elem", [&]() { return runUnit(unit, mull); });
+    bench("lane macl (ALU, accu)", "lane elem", [&]() { return runUnit(unit, mac); });
+    bench("lane shift_ar (special)", "lane elem", [&]() { return runUnit(unit, shift); });
+    bench("ls load -> lane add", "lane elem", [&]() { return runUnit(unit, load); });
+    bench("lane add -> ls store", "lane elem", [&]() { return runUnit(unit, store); });
+    bench("ls load -> indirect dst", "lane elem", [&]() { return runUnit(unit, indirect); });
+}
+
+// ---------------------------------------------------------------------------------------------
+// register file, bram
+// ---------------------------------------------------------------------------------------------
+constexpr int ACCESSES = 1 << 16;
+
+void benchRegisterFile() {
+    RegisterFile::Register rf(0, 0, 0, VPRO_CFG::RF_SIZE, false);
+    std::mt19937 rng(SEED);
+    for (uint32_t a = 0; a < VPRO_CFG::RF_SIZE; a++) {
+        rf.set_rf_data(int(a), rng() & 0xffffff);
+    }
+    std::vector<uint32_t> read_addr(ACCESSES), write_addr(ACCESSES), data(ACCESSES);
+    for (int i = 0; i < ACCESSES; i++) {
+        read_addr[i] = rng() % VPRO_CFG::RF_SIZE;
+        write_addr[i] = rng() % VPRO_CFG::RF_SIZE;
+        data[i] = rng() & 0xffffff;
+    }
+
+    // one lane cycle: read operand, write result (_nxt, update)
+    volatile uint32_t sink = 0;
+    bench("register file read + write", "access", [&]() {
+        uint32_t sum = 0;
+        for (int i = 0; i < ACCESSES; i++) {
+            sum += rf.get_rf_data(int(read_addr[i]));
+            rf.set_rf_data_nxt(int(write_addr[i]), data[i]);
+            rf.update();
+        }
+        sink = sum;
+        return uint64_t(ACCESSES);
+    });
+}
+
+void benchBram() {
+    constexpr uint32_t word_length = 2;  // dma data word, as in Cache
+    Bram bram(VPRO_CFG::DCMA_BRAM_SIZE, word_length);
+    std::mt19937 rng(SEED);
+    std::vector<uint32_t> addrs(ACCESSES);
+    for (auto& a : addrs) {
+        a = rng() % (VPRO_CFG::DCMA_BRAM_SIZE / word_length);
+    }
+
+    uint8_t data[word_length]{};
+    bench("bram write", "word", [&]() {
+        for (int i = 0; i < ACCESSES; i++) {
+            data[0] = uint8_t(i);
+            bram.write(addrs[i], data);
+        }
+        return uint64_t(ACCESSES);
+    });
+    volatile uint8_t sink = 0;
+    bench("bram read", "word", [&]() {
+        uint8_t sum = 0;
+        for (int i = 0; i < ACCESSES; i++) {
+            bram.read(addrs[i], data);
+            sum += data[0];
+        }
+        sink = sum;
+        return uint64_t(ACCESSES);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------
+// DCMA cache (own instance on an own main memory)
+// ---------------------------------------------------------------------------------------------
+void benchCache() {
+    NonBlockingMainMemory memory(uint64_t(64) << 20);
+    Cache cache(core_,
+        VPRO_CFG::DCMA_LINE_SIZE,
+        VPRO_CFG::DCMA_ASSOCIATIVITY,
+        VPRO_CFG::DCMA_NR_BRAMS,
+        VPRO_CFG::DCMA_BRAM_SIZE,
+        &memory);
+
+    // dma word accesses: sequential runs with jumps into a working set of twice the cache size,
+    // every 4th access writes (dirty lines are written back on replacement)
+    const uint32_t working_set =
+        std::min<uint32_t>(2 * VPRO_CFG::DCMA_NR_BRAMS * VPRO_CFG::DCMA_BRAM_SIZE, 32u << 20);
+    std::mt19937 rng(SEED);
+    std::vector<uint32_t> addrs(ACCESSES);
+    uint32_t a = 0;
+    for (auto& access : addrs) {
+        a = (rng() % 4 == 0) ? (rng() % working_set) & ~1u : (a + 2) % working_set;
+        access = a;
+    }
+
+    uint8_t data[2]{};
+    auto run = [&]() {
+        cache.reset();
+        for (int i = 0; i < ACCESSES; i++) {
+            if (!cache.isHit(addrs[i])) {
+                cache.dmaRequestDownloadCacheLine(addrs[i], 0);
+                while (cache.isBusy()) {
+                    cache.tick();
+                    memory.tick();
+                }
+            }
+            if (i % 4 == 0)
+                cache.dmaWriteDataHit(addrs[i], data);
+            else
+                cache.dmaReadDataHit(addrs[i], data);
+            cache.tick();
+        }
+        return uint64_t(ACCESSES);
+    };
+
+    const std::pair<Cache::ReplacementPolicy, const char*> policies[] = {{Cache::FIFO, "FIFO"},
+        {Cache::LRU, "LRU"},
+        {Cache::LFU, "LFU"},
+        {Cache::Random, "Random"},
+        {Cache::PLRU, "PLRU"}};
+    for (auto [policy, name] : policies) {
+        cache.setReplacementPolicy(policy);
+        bench(std::string("cache access (") + name + ")", "dma word", run);
+    }
+
+    // shadow tag store of the miss classification
+    cache.setMissClassification(true);
+    bench("cache access (PLRU, miss classification)", "dma word", run);
+    cache.setMissClassification(false);
+}
+
+// ---------------------------------------------------------------------------------------------
+// DMA (cluster 0 with the DCMA and main memory of the ISS)
+// ---------------------------------------------------------------------------------------------
+constexpr int DMA_COMMANDS = 16;
+
+std::shared_ptr<CommandDMA> dmaCommand(CommandDMA::TYPE type,
+    uint64_t ext_base,
+    uint32_t loc_base,
+    uint32_t x_size,
+    uint32_t y_size,
+    int32_t y_leap,
+    bool pad) {
+    auto command = std::make_shared<CommandDMA>();
+    command->type = type;
+    command->cluster_mask = 1;
+    command->unit.append(0);
+    command->ext_base = ext_base;
+    command->loc_base = loc_base;
+    command->x_size = x_size;
+    command->y_size = y_size;
+    command->y_leap = y_leap;
+    for (bool& p : command->pad) {
+        p = pad;
+    }
+    return command;
+}
+
+uint64_t runDMA(Cluster& cluster, const std::vector<std::shared_ptr<CommandDMA>>& commands) {
+    auto* bus = reinterpret_cast<NonBlockingMainMemory*>(core_->bus);
+    uint64_t elements = 0;
+    for (const auto& command : commands) {
+        cluster.dma->execute_cmd(std::make_shared<CommandDMA>(command.get()));
+        elements += uint64_t(command->x_size) * command->y_size;
+    }
+    uint64_t cycles = 0;
+    while (cluster.dma->isBusy()) {
+        cluster.dma->tick();
+        core_->dcma->tick();
+        bus->tick();
+        if (++cycles > 10000000) {
+            printf_error("  dma did not finish the commands\n");
+            return 0;
+        }
+    }
+    return elements;
+}
+
+void benchDMA(Cluster& cluster) {
+    dma_set_pad_widths(1, 1, 1, 1);
+    dma_set_pad_value(0);
+
+    std::mt19937 rng(SEED);
+    constexpr uint64_t ext_region = 1u << 20;
+    auto ext = [&]() { return 0x01000000 + (rng() % ext_region & ~uint64_t(1)); };
+
+    // 1D: 256 elements, 2D: 16x16 tile of a 64 element wide image (y_leap: gap + 1)
+    std::vector<std::shared_ptr<CommandDMA>> e2l_1d, e2l_2d, e2l_2d_pad, l2e_1d;
+    for (int c = 0; c < DMA_COMMANDS; c++) {
+        uint32_t loc = (c * 256) % (VPRO_CFG::LM_SIZE - 256);
+        e2l_1d.push_back(dmaCommand(CommandDMA::EXT_1D_TO_LOC_1D, ext(), loc, 256, 1, 1, false));
+        e2l_2d.push_back(dmaCommand(CommandDMA::EXT_2D_TO_LOC_1D, ext(), loc, 16, 16, 49, false));
+        e2l_2d_pad.push_back(
+            dmaCommand(CommandDMA::EXT_2D_TO_LOC_1D, ext(), loc, 16, 16, 49, true));
+        l2e_1d.push_back(dmaCommand(CommandDMA::LOC_1D_TO_EXT_1D, ext(), loc, 256, 1, 1, false));
+    }
+
+    bench("dma e2l 1d", "element", [&]() { return runDMA(cluster, e2l_1d); });
+    bench("dma e2l 2d", "element", [&]() { return runDMA(cluster, e2l_2d); });
+    bench("dma e2l 2d padding", "element", [&]() { return runDMA(cluster, e2l_2d_pad); });
+    bench("dma l2e 1d", "element", [&]() { return runDMA(cluster, l2e_1d); });
+}
+
+// ---------------------------------------------------------------------------------------------
+// main memory (AXI), own instance
+// ---------------------------------------------------------------------------------------------
+constexpr uint32_t INITIATORS = 4;  // transfers in flight
+constexpr int TRANSFERS = 4096;
+
+void benchMainMemory() {
+    NonBlockingMainMemory memory(uint64_t(64) << 20);
+    const uint32_t burst_length = VPRO_CFG::DCMA_LINE_SIZE / 64;  // 512 bit bus words
+    std::mt19937 rng(SEED);
+    std::vector<intptr_t> addrs(TRANSFERS);
+    for (auto& a : addrs) {
+        a = intptr_t(rng() % (32u << 20)) & ~intptr_t(VPRO_CFG::DCMA_LINE_SIZE - 1);
+    }
+    std::vector<uint8_t> buffer(INITIATORS * VPRO_CFG::DCMA_LINE_SIZE);
+
+    bench("main memory read", "bus word", [&]() {
+        for (int t = 0; t < TRANSFERS; t += INITIATORS) {
+            for (uint32_t i = 0; i < INITIATORS; i++) {
+                memory.requestReadTransfer(addrs[t + i], burst_length, i);
+            }
+            uint32_t pending = INITIATORS;
+            bool done[INITIATORS]{};
+            while (pending > 0) {
+                memory.tick();
+                for (uint32_t i = 0; i < INITIATORS; i++) {
+                    if (!done[i] && memory.isReadDataAvailable(i)) {
+                        memory.readData(&buffer[i * VPRO_CFG::DCMA_LINE_SIZE], i);
+                        done[i] = true;
+                        pending--;
+                    }
+                }
+            }
+        }
+        return uint64_t(TRANSFERS) * burst_length;
+    });
+    bench("main memory write", "bus word", [&]() {
+        for (int t = 0; t < TRANSFERS; t += INITIATORS) {
+            for (uint32_t i = 0; i < INITIATORS; i++) {
+                memory.requestWriteTransfer(
+                    addrs[t + i], &buffer[i * VPRO_CFG::DCMA_LINE_SIZE], burst_length, i);
+            }
+            uint32_t pending = INITIATORS;
+            bool done[INITIATORS]{};
+            while (pending > 0) {
+                memory.tick();
+                for (uint32_t i = 0; i < INITIATORS; i++) {
+                    if (!done[i] && memory.isWriteDataReady(i)) {
+                        done[i] = true;
+                        pending--;
+                    }
+                }
+            }
+        }
+        return uint64_t(TRANSFERS) * burst_length;
+    });
+}
+
+}  // namespace
+
+/**
+ * Main
+ */
+int main(int argc, char* argv[]) {
+    // removed from argv before sim_init, second call (simulation thread) gets the argv without it
+    int remaining = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg.rfind("--filter=", 0) == 0)
+            filter = arg.substr(9);
+        else
+            argv[remaining++] = argv[i];
+    }
+    argc = remaining;
+    argv[argc] = nullptr;
+
+    sim_init(main, argc, argv);
+
+    printf("# ISS microbenchmarks (%d repetitions, fastest, seed %u)\n", REPETITIONS, SEED);
+    printf("  %-32s %10s %-12s %12s %12s\n", "Benchmark", "Elements", "", "ns / elem",
+        "allocs / elem");
+
+    Cluster& cluster = *core_->getClusters()[0];
+    benchLanes(*cluster.getUnits()[0]);
+    benchRegisterFile();
+    benchBram();
+    benchCache();
+    benchDMA(cluster);
+    benchMainMemory();
+
+    sim_stop();
+    return 0;
+}
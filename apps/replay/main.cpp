@@ -0,0 +1,34 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+// ########################################################
+// # replay of an ISS command trace                       #
+// #                                                      #
+// # drives the simulator without the application, e.g.  #
+// # to benchmark / profile the simulator itself          #
+// ########################################################
+//
+// record: <app> --record-trace=<file> (or sim_trace_record())
+// replay: ./sim --windowless --replay-trace=<file> [hardware parameters of the recording]
+
+#include <vpro.h>
+
+/**
+ * Main
+ */
+int main(int argc, char *argv[]) {
+    sim_init(main, argc, argv);
+
+    // restores the state at the start of the recording, prints wall time and simulated cycles / s
+    int status = sim_trace_replay();
+
+    sim_stop();
+    return status == 0 ? 0 : 1;
+}
@@ -11,13 +11,13 @@
 #include "bif.h"
 
 const char* mmAddrStr(mm_addr_type addr) {
-  static char buf[32];
+  static thread_local char buf[32]; // netgen: parallel command generation
   sprintf(buf, "0x%08" PRIx64, addr);
   return buf;
 }
 
 const char* to_bin(size_t const size, void const *const ptr, char *buf) {
-  static char static_buf[256];
+  static thread_local char static_buf[256];
   if (!buf)
     buf = static_buf;
   uint64_t v = *(uint64_t *)ptr;
@@ -68,6 +68,7 @@ const char* to_char(VPRO_TYPE type) {
   case global_avgpool2d_sum_intermediates : return "global_avgpool2d_sum_intermediates";
   case global_avgpool2d_divide: return "global_avgpool2d_divide";
   case shift_store_upsample : return "shift_store_upsample";
+  case residual_add_fused   : return "residual_add_fused";
   default                   : return "unknown";
   }
   return "unknown VPRO_TYPE";
@@ -100,6 +100,7 @@ enum VPRO_TYPE : uint8_t  {
     set_masks = 24,
     reset_indices = 25,
     shift_store_upsample = 26,
+    residual_add_fused = 27,
 };
 const char* to_char(VPRO_TYPE type);
 
@@ -646,9 +647,17 @@ struct  COMMAND_SCATTER {
     uint16_t input_pixels_w{};  // input pixels in w needed for computation
     uint16_t input_pixels_h{};  // input pixels in h needed for computation
 
+    // cross-layer overlap (calcCnn): the stores of the previous layer may still be in flight when this layer starts
+    uint8_t overlap_prev_stores{false}; // command list waits for DMA before its first load that may read another layer's output
+    uint8_t stores_pending_at_end{false}; // command list ends with stores that have not been waited for (VPRO is idle)
+
+    // command list storage (command_stream.h)
+    uint8_t command_encoding{0}; // COMMAND_ENCODING: 0 = raw COMMAND_SEGMENT array, 1 = compact stream
+    uint8_t dummy3{}; // align following uint32 to 32 bit
+    uint32_t command_stream_bytes{}; // size of command_segments[] in bytes (compact: < command_segments_count * sizeof(COMMAND_SEGMENT))
 
     // < insert new fields in front of this comment / align_filler[] >
-    uint8_t align_filler[20]; // shall occupy all space up to 32-bit aligned command_segments_count
+    uint8_t align_filler[12]; // shall occupy all space up to 32-bit aligned command_segments_count
     int32_t command_segments_count{};
     COMMAND_SEGMENT command_segments[];
 
@@ -733,7 +742,17 @@ struct  COMMAND_SCATTER {
                       dynamic_shape);
       assert(offs >= 0);
       if (!legacy_compatibility) {
-        offs += sprintf(buf+offs, "command_segments_count  %d\n", command_segments_count);
+        offs += sprintf(buf+offs,
+                        "overlap_prev_stores     %d\n"
+                        "stores_pending_at_end   %d\n"
+                        "command_encoding        %d\n"
+                        "command_stream_bytes    %u\n"
+                        "command_segments_count  %d\n",
+                        overlap_prev_stores,
+                        stores_pending_at_end,
+                        command_encoding,
+                        command_stream_bytes,
+                        command_segments_count);
         assert(offs >= 0);
       }
       return buf;
@@ -742,6 +761,7 @@ struct  COMMAND_SCATTER {
   };
   static_assert(sizeof(LAYER) % 32 == 0, "Memory layout of packed struct needs to be 32-byte aligned!");
   static_assert(offsetof(LAYER, align_filler) + sizeof(LAYER::align_filler) == offsetof(LAYER, command_segments_count), "Compiler-generate padding between align_filler and command_segments_count. Please increase align_filler.");
+  static_assert(offsetof(LAYER, dummy3) + sizeof(LAYER::dummy3) == offsetof(LAYER, command_stream_bytes), "Compiler-generated padding in front of command_stream_bytes");
   // END based on cnn_struct_reduced.h g9114dd8
 
   constexpr static uint32_t net_magicword = 0xf3f67a81;
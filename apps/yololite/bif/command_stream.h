@@ -0,0 +1,196 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+#ifndef COMMAND_STREAM_H
+#define COMMAND_STREAM_H
+
+#include <algorithm>
+#include <cstring>
+#include "bif.h"
+
+// Compact encoding of a layer's command list (LAYER.command_encoding == COMMANDS_COMPACT)
+// Generated by netgen (CommandStreamWriter), decoded on the fly by the EISV runtime (CommandStreamReader)
+//
+// Most commands differ from the previous command of the same type in one or two fields (mm_addr, lm_addr, buffer).
+// A COMMAND_SEGMENT is treated as 8 little-endian 32-bit words; each record stores only the differing words.
+//
+// Record := header byte
+//   header < COMMAND_STREAM_RAW_RUN: COMMAND_SEGMENT_TYPE of the command
+//       1 byte: mask of words differing from the previous command of this type (all-zero before the first one)
+//       per set bit (LSB first): zigzag LEB128 varint of (word - previous word) mod 2^32
+//   header == COMMAND_STREAM_RAW_RUN:
+//       LEB128 varint n, zero bytes up to the next 32-byte boundary (relative to the stream start), n COMMAND_SEGMENTs
+//       Used for commands read by hardware from MM by address: DMA_BLOCK with its DMA commands, DMA loop with its base.
+//       Raw commands do not update the previous-command state.
+//
+// LAYER.command_segments_count remains the number of commands (incl. raw ones).
+
+namespace BIF {
+
+  enum COMMAND_ENCODING : uint8_t {
+    COMMANDS_RAW = 0, // COMMAND_SEGMENT[command_segments_count]
+    COMMANDS_COMPACT = 1, // byte stream of command_stream_bytes, see above
+  };
+
+  static constexpr uint8_t COMMAND_STREAM_RAW_RUN = 0xfe;
+  static constexpr int COMMAND_STREAM_TYPES = 8; // COMMAND_SEGMENT_TYPE values with delta state
+  static constexpr int COMMAND_WORDS = sizeof(COMMAND_SEGMENT) / sizeof(uint32_t);
+
+  class CommandStreamReader {
+  public:
+    CommandStreamReader(const LAYER &layer, const COMMAND_SEGMENT *segments, uint32_t seg_size) :
+      pos((const uint8_t *)segments), start((const uint8_t *)segments), remaining(seg_size),
+      compact(layer.command_encoding == COMMANDS_COMPACT) {
+      for (int t = 0; t < COMMAND_STREAM_TYPES; t++)
+        for (int w = 0; w < COMMAND_WORDS; w++)
+          prev[t][w] = 0;
+    }
+
+    // next command; nullptr after the last one
+    // decoded commands are overwritten after DECODE_SLOTS further calls
+    inline const COMMAND_SEGMENT *next() {
+      if (!remaining)
+        return nullptr;
+      remaining--;
+      index++;
+
+      if (!compact || raw_left) {
+        const COMMAND_SEGMENT *cmd = (const COMMAND_SEGMENT *)pos;
+        pos += sizeof(COMMAND_SEGMENT);
+        if (raw_left)
+          raw_left--;
+        return cmd;
+      }
+
+      uint8_t header = *pos++;
+      if (header == COMMAND_STREAM_RAW_RUN) {
+        raw_left = readVarint();
+        pos = start + ((pos - start + sizeof(COMMAND_SEGMENT) - 1) & ~(sizeof(COMMAND_SEGMENT) - 1));
+        remaining++;
+        index--;
+        return next();
+      }
+
+      uint32_t *p = prev[header & (COMMAND_STREAM_TYPES - 1)];
+      uint8_t mask = *pos++;
+      for (int w = 0; w < COMMAND_WORDS; w++) {
+        if (mask & (1u << w)) {
+          uint32_t z = readVarint();
+          p[w] += (z >> 1) ^ -(z & 1);
+        }
+      }
+      COMMAND_SEGMENT *cmd = &decoded[slot++ % DECODE_SLOTS];
+      memcpy((void *)cmd, p, sizeof(COMMAND_SEGMENT));
+      return cmd;
+    }
+
+    // skip the n commands following the current one (payload of a DMA_BLOCK, executed by hardware)
+    inline void skip(uint32_t n) {
+      pos += n * sizeof(COMMAND_SEGMENT);
+      remaining -= n;
+      index += n;
+      if (compact)
+        raw_left -= n;
+    }
+
+    // commands consumed so far (incl. skipped ones)
+    inline uint32_t consumed() const { return index; }
+
+    // current read position in MM (dcache prefetch)
+    inline const uint8_t *position() const { return pos; }
+
+  private:
+    inline uint32_t readVarint() {
+      uint32_t v = 0;
+      int shift = 0;
+      uint8_t b;
+      do {
+        b = *pos++;
+        v |= uint32_t(b & 0x7f) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      return v;
+    }
+
+    const uint8_t *pos;
+    const uint8_t *start;
+    uint32_t remaining;
+    uint32_t index{0};
+    uint32_t raw_left{0};
+    bool compact;
+
+    uint32_t prev[COMMAND_STREAM_TYPES][COMMAND_WORDS];
+    // DMA commands are fetched by address (dma_dcache_short_command): keep the last few decoded ones alive
+    static constexpr int DECODE_SLOTS = 4;
+    alignas(32) COMMAND_SEGMENT decoded[DECODE_SLOTS];
+    uint8_t slot{0};
+  };
+
+  class CommandStreamWriter {
+  public:
+    static std::vector<uint8_t> encode(const std::vector<COMMAND_SEGMENT> &cmds) {
+      std::vector<uint8_t> s;
+      uint32_t prev[COMMAND_STREAM_TYPES][COMMAND_WORDS]{};
+
+      for (size_t i = 0; i < cmds.size(); i++) {
+        const COMMAND_SEGMENT &cmd = cmds[i];
+        size_t raw = 0;
+        if (cmd.type.type == DMA_BLOCK) {
+          raw = 1 + cmd.dma.unit_mask; // block size
+        } else if (cmd.type.type == DMA_CMD && cmd.dma.direction == loop) {
+          raw = 2; // loop parameters + base command
+        }
+        assert((raw || cmd.type.type < COMMAND_STREAM_TYPES) && "COMMAND_SEGMENT_TYPE without delta state");
+
+        if (raw) {
+          raw = std::min(raw, cmds.size() - i);
+          s.push_back(COMMAND_STREAM_RAW_RUN);
+          putVarint(s, raw);
+          s.resize((s.size() + sizeof(COMMAND_SEGMENT) - 1) & ~(sizeof(COMMAND_SEGMENT) - 1), 0);
+          const uint8_t *b = (const uint8_t *)&cmds[i];
+          s.insert(s.end(), b, b + raw * sizeof(COMMAND_SEGMENT));
+          i += raw - 1;
+          continue;
+        }
+
+        uint32_t words[COMMAND_WORDS];
+        memcpy(words, &cmd, sizeof(words));
+        uint32_t *p = prev[cmd.type.type];
+        uint8_t mask = 0;
+        for (int w = 0; w < COMMAND_WORDS; w++) {
+          if (words[w] != p[w])
+            mask |= 1u << w;
+        }
+        s.push_back(cmd.type.type);
+        s.push_back(mask);
+        for (int w = 0; w < COMMAND_WORDS; w++) {
+          if (mask & (1u << w)) {
+            int32_t d = int32_t(words[w] - p[w]);
+            putVarint(s, (uint32_t(d) << 1) ^ uint32_t(d >> 31));
+            p[w] = words[w];
+          }
+        }
+      }
+      return s;
+    }
+
+  private:
+    static void putVarint(std::vector<uint8_t> &s, uint32_t v) {
+      while (v >= 0x80) {
+        s.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+      }
+      s.push_back(uint8_t(v));
+    }
+  };
+
+} // namespace BIF
+
+#endif // COMMAND_STREAM_H
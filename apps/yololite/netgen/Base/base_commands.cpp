@@ -9,6 +9,8 @@
  * 
  */
 
+#include <algorithm>
+
 // HW parameters taken from ISS
 #include "vpro_globals.h"
 #include "vpro_cmd_defs.h"
@@ -229,4 +231,105 @@ namespace CNN_LAYER {
 
     }
 
+    // calcLayer() handles these layers (partially) on the RISC-V instead of executing their command list
+    static bool executesCommandListOnly(LAYERTYPE type) {
+        switch (type) {
+            case LAYERTYPE::DYNAMIC_AXIS:
+            case LAYERTYPE::SCATTER_TO_GRID:
+            case LAYERTYPE::POINTPILLARS:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    void Layer::hoistIndependentLoads() {
+        // calcCnn() starts this layer while the final stores of the previous layer may still be in flight.
+        // Loads that can not read their MM destination (weights, inputs produced by earlier layers) are issued
+        // first; loads that may alias a pending store (MM range overlaps an output of prev_exec_layers) follow
+        // a DMA wait. Per-cluster DMA processes commands in order, so the pending stores read LM before hoisted
+        // loads overwrite it (as within double buffering).
+        overlap_prev_stores = false;
+        if (!executesCommandListOnly(getLayerType()))
+            return;
+
+        // first block: loads only, terminated by a sync that includes the DMA
+        auto first_sync = std::find_if(commands.begin(), commands.end(), [](const BIF::COMMAND_SEGMENT &c) {
+            return c.type.type != DMA_CMD;
+        });
+        if (first_sync == commands.end() || first_sync == commands.begin())
+            return;
+        if (first_sync->type.type != DMA_WAIT && first_sync->type.type != BOTH_SYNC)
+            return;
+        for (auto it = commands.begin(); it != first_sync; ++it) {
+            if (it->dma.direction != e2l1D && it->dma.direction != e2l2D)
+                return;
+        }
+
+        auto is_weight_load = [this](const BIF::COMMAND_SEGMENT &c) {
+            if (c.dma.isKernelOffset || c.dma.isBiasOffset)
+                return true;
+#ifdef COMPARABLE_CMDS
+            return false; // weight addresses are relative to getWeightsMMAddr()
+#else
+            return c.dma.mm_addr >= getWeightsMMAddr() && c.dma.mm_addr < getWeightsMMAddr() + getWeightsMMSize();
+#endif
+        };
+
+        auto may_alias_pending_store = [&](const BIF::COMMAND_SEGMENT &c) {
+            if (is_weight_load(c))
+                return false;
+            // bytes from mm_addr to the last element read (padding is not read from MM)
+            uint64_t begin = c.dma.mm_addr;
+            uint64_t end = begin + 2 * uint64_t(c.dma.x_size);
+            if (c.dma.direction == e2l2D)
+                end = begin + 2 * uint64_t(std::max<int>(c.dma.y_size, 1)) * (c.dma.x_size + c.dma.y_leap - 1);
+            for (Layer *pl: prev_exec_layers) {
+                const auto &mm = pl->out_dim.mm;
+                if (!mm.layout_known)
+                    return true;
+                if (begin < mm.base + mm.size && mm.base < end)
+                    return true;
+            }
+            return false;
+        };
+
+        auto first_dependent = std::stable_partition(commands.begin(), first_sync,
+                                                     [&](const BIF::COMMAND_SEGMENT &c) { return !may_alias_pending_store(c); });
+        if (first_dependent != first_sync) {
+            commands.insert(first_dependent, DMA_COMMANDS::DMA_DESCRIPTOR::wait());
+            cmd_cnt.sync++;
+        }
+        overlap_prev_stores = true;
+    }
+
+    void Layer::openCommandTail() {
+        // The final sync of generateCommands() only waits for the last stores; VPRO has been synced before.
+        // Drop it and let calcCnn() wait for these stores when the next layer needs them.
+        stores_pending_at_end = false;
+        if (!executesCommandListOnly(getLayerType()))
+            return;
+        if (commands.empty() || commands.back().type.type != BOTH_SYNC)
+            return;
+
+        auto rit = commands.rbegin() + 1;
+        for (; rit != commands.rend(); ++rit) {
+            const auto &c = *rit;
+            if (c.type.type == DMA_BLOCK)
+                continue;
+            if (c.type.type == DMA_CMD && c.dma.direction != e2l1D && c.dma.direction != e2l2D)
+                continue; // l2e or loop
+            break;
+        }
+        if (rit == commands.rend() || rit == commands.rbegin() + 1)
+            return;
+        // stores must follow a point where all VPRO work is complete
+        if (rit->type.type != BOTH_SYNC && rit->type.type != VPRO_WAIT)
+            return;
+
+        commands.pop_back();
+        cmd_cnt.sync--;
+        stores_pending_at_end = true;
+    }
+
 } // namespace CNN_LAYER
@@ -64,6 +64,7 @@ namespace CNN_LAYER {
         SEGMENT_SCHEDULING_ORDER scheduling_order{ITERATE_ALL_SORTED_OUTC};
         SEGMENTATION_STRATEGY segmentation_strategy{DETAILED_HEURISTIC};
         bool force_segment_dump{false};
+        bool overlap_layer_boundaries{true}; // hoist independent loads above the first DMA wait and leave the final stores in flight; only if Net::overlap_layers
     };
 
     struct segDim {
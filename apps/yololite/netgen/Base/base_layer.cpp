@@ -12,7 +12,9 @@
 // Created by gesper on 20.07.23.
 //
 
+#include <cstring>
 #include "base_layer.h"
+#include "tuning_db.h"
 
 using namespace CNN_LAYER;
 
@@ -132,6 +134,13 @@ void Layer::loadWeights(const std::string &path){
 
 // called by memory management
 void Layer::setOutputMMAddr(mm_addr_type base_addr) {
+    if (fused_into) {
+        // computed by another layer (Net::fuseLayers()) -> no segments of its own, alias its output
+        assert(fused_into->out_dim.mm.layout_known && "Layer fused into a layer instantiated later");
+        out_dim.mm = fused_into->out_dim.mm;
+        return;
+    }
+
     out_dim.mm.base = base_addr;
 
     // Set number of segments and their dimensions and main memory image of this layer's output
@@ -157,6 +166,8 @@ void Layer::setOutputMMAddr(mm_addr_type base_addr) {
 
 // tell memory management how much output space is required (may be larger than actual payload data)
 mm_size_type Layer::getOutputMMSize() {
+    if (fused_into)
+        return 0; // alias
     assert(out_dim.mm.layout_known && "getOutputSize relies on the size determined by calcOutputMemLayout(). Call setOutputMMAddr() first!");
     return out_dim.mm.size;
 }
@@ -203,6 +214,9 @@ void Layer::generateBifLayer(BIF::LAYER &bl) {
 
     bl.parallel_outchannels_per_lane = parallel_outchannels_per_lane;
     bl.parallel_inchannels_per_lane = parallel_inchannels_per_lane;
+
+    bl.overlap_prev_stores = overlap_prev_stores;
+    bl.stores_pending_at_end = stores_pending_at_end;
 }
 
 std::vector<BIF::COMMAND_SEGMENT> &Layer::generateCommandSegments() {
@@ -210,11 +224,29 @@ std::vector<BIF::COMMAND_SEGMENT> &Layer::generateCommandSegments() {
     //FIXME: this is done in generateCommands() -> refactor this
     generateSegments();
     generateCommands();
+    if (layercfg.overlap_layer_boundaries)
+        hoistIndependentLoads();
     compressCommands();
+    if (layercfg.overlap_layer_boundaries)
+        openCommandTail();
 
     return commands;
 }
 
+uint64_t Layer::tuningKey() {
+    // BIF::LAYER without everything depending on the position in net and memory layout
+    BIF::LAYER bl;
+    memset((void*)&bl, 0, sizeof(bl));
+    generateBifLayer(bl);
+    bl.number = 0;
+    bl.input.mm_base = 0;
+    bl.output.mm_base = 0;
+    bl.last_layer_using_input = 0;
+    bl.first_layer_producing_output = 0;
+    // the hardware is added by TuningDB::key (simulated HWConfig, "# hw" lines of the sim)
+    return TuningDB::hash(&bl, sizeof(bl));
+}
+
 bool Layer::sanityCheckWeightsCount(int weights_count) {
     int expected_count = expectedWeightCount();
     bool check_passed = weights_count == expected_count;
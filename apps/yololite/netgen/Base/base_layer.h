@@ -39,6 +39,9 @@
 //             Layer::computeOutputDim() // -> out_dim.(x|y)
 //             Layer::computeInputPadding() // -> padding.algo
 // 
+//     Net::generateLayerExecList()
+//     Net::fuseLayers()
+//         Layer::fuseDestLayer() // absorb the only consumer -> consumer.fused_into, removed from layer_execlist
 //     Net::designMmLayoutVpro()
 //         Layer::setOutputMMAddr() for layers
 //             Layer::setSegmentDimensions();
@@ -46,10 +49,12 @@
 //             Layer::computeDmaPadding() // padding.algo -> padding.dma
 //             Layer::setOutputMemDimensions() // -> out_dim.mm.(x|y)
 //             Layer::calcOutputMemLayout() // derive all other out_dim.mm.* fields from out_dim.mm.(x|y)
+//         Net::reuseOutputBuffers() // liveness over layer_execlist, relocates out_dim.mm
+//     Net::applyTuningDb() // measured layercfg.scheduling_order per layer (tuning_db.h)
 // 
-//     Net::generateLayerExecList()
 //     Net::generateVproBlob() // weights
 //     Net::generateEisvBlob() // program
+//         Net::generateCommandSegments() // one task per layer on a thread pool (netgen_threads)
 //         Layer::generateCommandSegments() for layers
 //             Layer::generateSegments() // -> segments[]
 //                 // map segments to lanes
@@ -67,11 +72,13 @@
 //                     Layer::store() // DMA LM->MM
 //                         dataStore() for each lane
 //                 }
+//             Layer::hoistIndependentLoads() // cross-layer overlap: independent loads first, DMA wait before loads of pending outputs
 //             Layer::compressCommands()
 //                 Layer::DmaMerger()
 //                 Layer::DmaBlockExtension()
 //                 Layer::DmaLoopExtension()
 //                 Layer::DmaClusterMixer()
+//             Layer::openCommandTail() // cross-layer overlap: final stores are waited for by the next layer
 //     Net::exportEisvBlob()
 //     Net::exportVproBlob()
 //     Net::exportLayersText()
@@ -186,6 +193,10 @@ namespace CNN_LAYER {
     // tell memory management how much output space is required (may be larger than actual payload data)
     virtual mm_size_type getOutputMMSize();
 
+    // layer fusion: compute the output of dest (this layer's only consumer) within this layer's commands
+    // returns false if dest can not be absorbed; otherwise Net::fuseLayers() sets dest->fused_into
+    virtual bool fuseDestLayer(Layer *dest) { return false; }
+
     // set quantized weights
     virtual void setWeights(std::vector<weight_t> &weights);
 
@@ -217,6 +228,15 @@ namespace CNN_LAYER {
     virtual void generateCommands();
     virtual void compressCommands();
 
+    // cross-layer overlap (layercfg.overlap_layer_boundaries), evaluated by calcCnn() via BIF::LAYER flags
+    virtual void hoistIndependentLoads(); // before compressCommands(): weight loads may run while the previous layer's stores drain
+    virtual void openCommandTail(); // after compressCommands(): drop the final sync behind pure stores
+
+    // ISS in the loop autotuning (Net::applyTuningDb()): layercfg.scheduling_order values worth measuring; empty: not tuned
+    virtual std::vector<SEGMENT_SCHEDULING_ORDER> tuningVariants() { return {}; }
+    // identical for layers with identical parameters (not mm addresses); the hw is added by TuningDB::key
+    virtual uint64_t tuningKey();
+
     virtual void load(std::vector<SEGMENT *> &segments, int seg_cnt, BUFFER &buffer) {}
     virtual void compute(std::vector<SEGMENT *> &segments, int seg_cnt, BUFFER &buffer, BUFFER &store_buffer) {}
     virtual void store(std::vector<SEGMENT *> &segments, int seg_cnt, BUFFER &buffer);
@@ -265,6 +285,7 @@ namespace CNN_LAYER {
 
     bool produces_binary_data{true};
     bool is_input_layer{false};
+    Layer *fused_into{nullptr}; // set by Net::fuseLayers(): output is computed by fused_into, output space is an alias
     bool use_dynamic_shape{false};
 
     // in the order of Net.layer_execlist
@@ -290,6 +311,9 @@ namespace CNN_LAYER {
     segDim seg;
 
     CMD_COUNT cmd_cnt;
+    std::vector<Layer *> prev_exec_layers; // predecessors in Net.layer_execlist, their final stores may be pending (overlap_layers)
+    bool overlap_prev_stores{false}; // set by hoistIndependentLoads()
+    bool stores_pending_at_end{false}; // set by openCommandTail()
 
   protected:
     std::string weights_fname;
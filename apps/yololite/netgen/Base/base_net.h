@@ -18,10 +18,17 @@
 #include <iomanip>
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <math.h>
 #include <iostream>
 #include "base_layer.h"
 #include "bif.h"
+#include "command_stream.h"
+#include "tuning_db.h"
 
 
 /*
@@ -66,12 +73,58 @@ namespace CNN_NET {
       }
     }
 
+    // Layer fusion: a layer absorbs its only consumer (Layer::fuseDestLayer()), saving the round trip of the
+    // intermediate feature map through MM. The consumer leaves layer_execlist, its output aliases the absorbing layer.
+    // Not fused: outputs the host accesses (results, sim in/out), consumers with inputs not yet computed when the
+    // absorbing layer executes, layers executed more than once
+    virtual void fuseLayers() {
+      std::map<CNN_LAYER::Layer*, int> exec_pos;
+      std::map<CNN_LAYER::Layer*, int> exec_count;
+      for (unsigned int xli = 0; xli < layer_execlist.size(); xli++) {
+        exec_pos[layers[layer_execlist[xli]]] = xli;
+        exec_count[layers[layer_execlist[xli]]]++;
+      }
+
+      std::set<CNN_LAYER::Layer*> absorbed;
+      for (unsigned int xli = 0; xli < layer_execlist.size(); xli++) {
+        CNN_LAYER::Layer *l = layers[layer_execlist[xli]];
+        if (l->dest_layers.size() != 1 || exec_count[l] != 1 || absorbed.count(l) || l->out_is_result || getSimOutputActiveLayer(*l))
+          continue;
+        CNN_LAYER::Layer *d = l->dest_layers[0];
+        if (!exec_count.count(d) || exec_count[d] != 1 || exec_pos[d] < (int)xli || d->out_is_result || getSimInputActiveLayer(*d) || getSimOutputActiveLayer(*d))
+          continue;
+
+        bool inputs_ready = true;
+        for (auto sl: d->src_layers) {
+          if (sl == l)
+            continue;
+          if (sl->is_input_layer) {
+            inputs_ready &= !sl->is_transient_input_layer(); // handshake flags are derived from executed layers
+          } else {
+            inputs_ready &= exec_count.count(sl) && exec_pos[sl] < (int)xli && !absorbed.count(sl);
+          }
+        }
+        if (!inputs_ready || !l->fuseDestLayer(d))
+          continue;
+
+        std::cout << "Layer fusion: " << d->getFullName() << " computed by " << l->getFullName() << "\n";
+        d->fused_into = l;
+        d->produces_binary_data = false;
+        absorbed.insert(d);
+      }
+
+      layer_execlist.erase(std::remove_if(layer_execlist.begin(), layer_execlist.end(),
+                                          [&](unsigned int li) { return absorbed.count(layers[li]) > 0; }),
+                           layer_execlist.end());
+    }
+
     // MM static memory layout
     // weight addresses must be known before segment generation
     // segment addresses will be computed on the fly
+    // requires layer_execlist (liveness of layer outputs)
     virtual void designMmLayoutVpro() {
       // layer output data (output of input-layer is the global cnn input)
-      // dumb linear allocation: each has its private output space
+      // dumb linear allocation first: each has its private output space -> sizes and mem layout of all layers
       mm_addr_type mm_output_addr = memlayout_static.mm_output_base;
       for (auto layer: layers) {
         // std::cout << "designMmLayoutVpro: " << layer->getFullName() << " " << layer << " .setOutputMMAddr(" << mmAddrStr(mm_output_addr) << ")\n";
@@ -79,20 +132,14 @@ namespace CNN_NET {
         layer->setOutputMMAddr(mm_output_addr); // one addr per src layer
         mm_output_addr += layer->getOutputMMSize();
       }
-      /* Ideas for space-saving memory allocation:
-         - full-blown register allocation and graph coloring approaches are probably unnecessarily complicated
-
-         - algo: three passes over all layers to keep I/O spaces together tight
-           - allocate all inputs
-           - allocate all outputs
-           - allocate buckets for all intermediate layers
-             - re-use buckets no longer required
-             - if all buckets are currently used, allocate a new bucket
-             - bucket tracks:
-               - layers using its content as input (empty list -> bucket can be re-used)
-               - maximum output size of any layer writing into this bucket
-             - input and output layers always have private spaces (overwritten/read in parallel by ARM)
-      */
+      mm_output_size_linear = mm_output_addr - memlayout_static.mm_output_base;
+      mm_output_size_reused = mm_output_size_linear;
+
+      // decoupled execution: all layer outputs are preloaded -> no reuse
+      if (reuse_mm_buffers && !run_layers_decoupled) {
+        mm_output_size_reused = reuseOutputBuffers();
+        mm_output_addr = memlayout_static.mm_output_base + mm_output_size_reused;
+      }
 
       // absolute weight addresses will be stored in command segments -> weight addresses must be known before segment generation
       // uncached .vpro data segment
@@ -108,12 +155,251 @@ namespace CNN_NET {
       }
 
       std::cout << "VPRO memory blocks: (details see init/input.cfg + exit/output.cfg)\n";
-      std::cout << "  " << mmAddrStr(memlayout_static.mm_output_base) << " .. " << mmAddrStr(mm_output_addr-1) << " (" << std::setw(10) << mm_output_addr-memlayout_static.mm_output_base << " byte): CNN input + layer outputs\n";
+      std::cout << "  " << mmAddrStr(memlayout_static.mm_output_base) << " .. " << mmAddrStr(mm_output_addr-1) << " (" << std::setw(10) << mm_output_addr-memlayout_static.mm_output_base << " byte): CNN input + layer outputs";
+      if (mm_output_size_reused != mm_output_size_linear) {
+        std::cout << " (" << mm_output_size_linear << " byte without buffer reuse)";
+      }
+      std::cout << "\n";
       std::cout << "  " << mmAddrStr(memlayout_static.mm_weights_base) << " .. " << mmAddrStr(mm_weights_addr-1) << " (" << std::setw(10) << mm_weights_addr-memlayout_static.mm_weights_base << " byte): weights\n";
 
       assert((mm_output_addr <= 0xC0000000 && mm_weights_addr <= 0xC0000000) && "ISS DMA maps addresses >= 0x40000000 to host mem (as of 2022-11-23)");
     }
 
+    // Liveness-based reuse of layer output buffers
+    // - live range of a buffer: its producer .. last consumer in layer_execlist
+    // - aliases without own output space (reshape, slice) extend the live range of their source buffer
+    // - private buffers (never reused, placed first): CNN inputs and results (accessed by the host in parallel),
+    //   outputs loaded/dumped by input.cfg/output.cfg (whole layer or single channels), layers not in layer_execlist
+    // - remaining buffers: greedy by size, best-fitting gap among the buffers with overlapping live range
+    // mm.base / channel_base of all layers are shifted to the new location (mem layout is position independent)
+    // returns size of the output region starting at mm_output_base
+    virtual mm_size_type reuseOutputBuffers() {
+      struct Buffer {
+        mm_size_type size;
+        int first; // position in layer_execlist
+        int last;
+        bool is_private;
+        mm_addr_type offs;
+      };
+
+      std::map<CNN_LAYER::Layer*, int> exec_pos; // not in map: not executed
+      for (unsigned int xli = 0; xli < layer_execlist.size(); xli++) {
+        exec_pos[layers[layer_execlist[xli]]] = xli;
+      }
+
+      // layer owning the output space of l
+      auto owner = [](CNN_LAYER::Layer *l) {
+        while (l->getOutputMMSize() == 0 && (l->fused_into || l->src_layers.size() == 1))
+          l = l->fused_into ? l->fused_into : l->src_layers[0];
+        return l;
+      };
+
+      // contents read / written by the simulator's input.cfg / output.cfg (dumped after the whole net)
+      auto simAccessed = [this](CNN_LAYER::Layer *l) {
+        if (getSimInputActiveLayer(*l) || getSimOutputActiveLayer(*l))
+          return true;
+        for (int ch = 0; ch < (int)l->out_dim.mm.channel_base.size(); ch++) {
+          if (getSimInputActiveChannel(*l, ch) || getSimOutputActiveChannel(*l, ch))
+            return true;
+        }
+        return false;
+      };
+
+      std::map<CNN_LAYER::Layer*, Buffer> buffers;
+      for (auto layer: layers) {
+        if (owner(layer) != layer || layer->getOutputMMSize() == 0)
+          continue;
+        auto pos = exec_pos.find(layer);
+        bool executed = pos != exec_pos.end();
+        buffers[layer] = Buffer{(mm_size_type)align(layer->getOutputMMSize(), 16), executed ? pos->second : 0, executed ? pos->second : 0, !executed, 0};
+      }
+
+      for (auto layer: layers) {
+        auto buf = buffers.find(owner(layer));
+        if (buf == buffers.end())
+          continue;
+        if (layer->is_input_layer || layer->out_is_result || simAccessed(layer))
+          buf->second.is_private = true;
+        // consumers; inputs of a fused layer are read by the layer it is fused into
+        auto pos = exec_pos.find(layer->fused_into ? layer->fused_into : layer);
+        if (pos == exec_pos.end())
+          continue;
+        for (auto sl: layer->src_layers) {
+          auto src = buffers.find(owner(sl));
+          if (src == buffers.end())
+            continue;
+          if (pos->second < src->second.first) // read before written (recurrent execution order)
+            src->second.is_private = true;
+          src->second.last = std::max(src->second.last, pos->second);
+        }
+      }
+
+      // private buffers in instantiation order
+      mm_addr_type private_size = 0;
+      std::vector<std::pair<CNN_LAYER::Layer*, Buffer*>> shared;
+      for (auto layer: layers) {
+        auto buf = buffers.find(layer);
+        if (buf == buffers.end())
+          continue;
+        if (buf->second.is_private) {
+          buf->second.offs = private_size;
+          private_size += buf->second.size;
+        } else {
+          shared.emplace_back(layer, &buf->second);
+        }
+      }
+
+      std::stable_sort(shared.begin(), shared.end(), [](const auto &a, const auto &b) { return a.second->size > b.second->size; });
+      mm_addr_type total_size = private_size;
+      std::vector<Buffer*> placed;
+      for (auto &sb: shared) {
+        Buffer *b = sb.second;
+        std::vector<Buffer*> live; // placed buffers with overlapping live range, by address
+        for (auto p: placed) {
+          if (p->first <= b->last && b->first <= p->last)
+            live.push_back(p);
+        }
+        std::sort(live.begin(), live.end(), [](Buffer *x, Buffer *y) { return x->offs < y->offs; });
+
+        mm_addr_type best = 0, best_gap = 0;
+        bool found = false;
+        mm_addr_type gap_start = private_size;
+        for (auto p: live) {
+          if (p->offs >= gap_start + b->size && (!found || p->offs - gap_start < best_gap)) {
+            best = gap_start;
+            best_gap = p->offs - gap_start;
+            found = true;
+          }
+          gap_start = std::max(gap_start, p->offs + p->size);
+        }
+        b->offs = found ? best : gap_start;
+        total_size = std::max(total_size, b->offs + b->size);
+        placed.push_back(b);
+      }
+
+      // relocate (aliases move with their owner)
+      std::map<CNN_LAYER::Layer*, mm_addr_type> old_base;
+      for (auto &buf: buffers) {
+        old_base[buf.first] = buf.first->out_dim.mm.base;
+      }
+      for (auto layer: layers) {
+        auto buf = buffers.find(owner(layer));
+        if (buf == buffers.end())
+          continue;
+        mm_addr_type new_base = memlayout_static.mm_output_base + buf->second.offs;
+        mm_addr_type old = old_base[buf->first];
+        layer->out_dim.mm.base = layer->out_dim.mm.base - old + new_base;
+        for (auto &cb: layer->out_dim.mm.channel_base) {
+          cb = cb - old + new_base;
+        }
+      }
+
+      std::cout << "Layer output buffers: " << buffers.size() << " (" << (buffers.size() - shared.size()) << " private), "
+                << total_size << " byte with reuse, " << mm_output_size_linear << " byte without\n";
+      return total_size;
+    }
+
+    // ISS in the loop autotuning of layercfg.scheduling_order (flow: see tuning_db.h)
+    // - imports the measurements of the previous tuning round into the database
+    // - target hardware: the one of the last simulation (sim_results/tuning_cycles.txt), the database is not used without
+    // - layers with measurements of all their tuningVariants() on the target hardware use the fastest one
+    // - tune_layers: the other layers use their next unmeasured variant and are listed in generated/tuning_candidates.txt
+    // the heuristic's choice is measured first and wins on equal cycles
+    // requires final segmentation and memory layout (designMmLayoutVpro)
+    virtual void applyTuningDb() {
+      std::string candidates_fname = "generated/tuning_candidates.txt";
+      std::string cycles_fname = "sim_results/tuning_cycles.txt";
+      TuningDB db(tuning_db_fname);
+      bool db_exists = db.load();
+      int imported = db.importMeasurements(candidates_fname, cycles_fname);
+      if (imported) {
+        std::cout << "Tuning: imported " << imported << " measurements into " << tuning_db_fname << "\n";
+        /*int status = */mkdir("../../cache", 0777);
+        db.save();
+        db_exists = true;
+      }
+      remove(candidates_fname.c_str()); // measurements belong to the previous blob only
+      if (!db_exists && !tune_layers)
+        return;
+      uint64_t hw_key;
+      bool hw_known = TuningDB::hwKey(cycles_fname, hw_key);
+      if (!hw_known) {
+        std::cout << "Tuning: simulated hardware unknown (no " << cycles_fname << "), measurements not used\n";
+        db = TuningDB(tuning_db_fname); // empty, candidates only
+      }
+
+      std::stringstream candidates;
+      int tuned = 0, pending = 0;
+      for (unsigned int xli = 0; xli < layer_execlist.size(); xli++) {
+        CNN_LAYER::Layer *l = layers[layer_execlist[xli]];
+        std::vector<int> variants{l->layercfg.scheduling_order}; // heuristic first
+        for (auto v: l->tuningVariants()) {
+          if (v != l->layercfg.scheduling_order)
+            variants.push_back(v);
+        }
+        if (variants.size() < 2)
+          continue;
+
+        uint64_t layer_key = l->tuningKey();
+        uint64_t key = TuningDB::key(layer_key, hw_key);
+        auto unmeasured = std::find_if(variants.begin(), variants.end(), [&](int v) { return !db.isMeasured(key, v); });
+        if (unmeasured == variants.end()) {
+          uint64_t cycles;
+          int best = db.fastest(key, variants, &cycles);
+          if (best != l->layercfg.scheduling_order) {
+            std::cout << "Tuning: layer " << l->getFullName() << " scheduling_order " << l->layercfg.scheduling_order << " -> " << best << " (" << cycles << " cycles)\n";
+          }
+          l->layercfg.scheduling_order = (CNN_LAYER::SEGMENT_SCHEDULING_ORDER)best;
+          tuned++;
+        } else if (tune_layers) {
+          l->layercfg.scheduling_order = (CNN_LAYER::SEGMENT_SCHEDULING_ORDER)*unmeasured;
+          candidates << xli << " " << std::hex << layer_key << std::dec << " " << *unmeasured << " " << l->getFullName() << "\n";
+          pending++;
+        }
+      }
+
+      std::cout << "Tuning: " << tuned << " layers use measured scheduling_order";
+      if (tune_layers) {
+        std::cout << ", " << pending << " layers measure a new variant" << (pending ? " (simulate, then run netgen again)" : " (tuning complete)");
+        if (pending) {
+          auto fd = fopenw("generated/", "tuning_candidates.txt", "tuning candidates");
+          fd << candidates.str();
+        }
+      }
+      std::cout << "\n";
+    }
+
+    // Layer::generateCommandSegments() of layers[blob_layers] on a pool of netgen_threads worker threads
+    // - one task per layer; a layer only reads its own parameters, its src layers' out_dim and the (fixed) MM layout
+    // - result is in each layer's commands[], the serial concatenation in generateEisvBlob() keeps the blob byte-identical
+    // - console output of the layers interleaves if more than one thread is used
+    virtual void generateCommandSegments(const std::vector<unsigned int> &blob_layers) {
+      unsigned int threads = netgen_threads ? netgen_threads : std::max(1u, std::thread::hardware_concurrency());
+      threads = std::min<unsigned int>(threads, blob_layers.size());
+      if (threads <= 1) {
+        for (unsigned int li: blob_layers) {
+          std::cout << "== Layer " << layers[li]->getFullName() << ": generating commands\n";
+          layers[li]->generateCommandSegments();
+        }
+        return;
+      }
+
+      std::cout << "== Generating commands of " << blob_layers.size() << " layers on " << threads << " threads\n";
+      std::atomic<unsigned int> next{0};
+      auto worker = [&]() {
+        for (unsigned int i = next++; i < blob_layers.size(); i = next++) {
+          layers[blob_layers[i]]->generateCommandSegments();
+        }
+      };
+      std::vector<std::thread> pool;
+      for (unsigned int t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+      }
+      for (auto &t: pool) {
+        t.join();
+      }
+    }
+
     virtual Blob* generateEisvBlob() {
       /*
         EISV blob memory layout                                size
@@ -135,20 +421,38 @@ namespace CNN_NET {
       assert((layer_exec_count > 0) && "layer_execlist is empty");
       std::vector<uint32_t> log_idx_to_bin_idx(layers.size()); // some frontend layers[] are not in EISV blob -> different indexing
       
-      // == generate list of BIF::LAYER blobs for all layers
+      // == command generation: independent per layer -> parallel
+      std::vector<unsigned int> blob_layers; // index into layers[]
+      for (unsigned int li = 0; li < layers.size(); li++) {
+        if (layers[li]->produces_binary_data)
+          blob_layers.push_back(li);
+      }
+      generateCommandSegments(blob_layers);
+
+      // == generate list of BIF::LAYER blobs for all layers (serial, in layers[] order -> blob independent of thread count)
       std::vector<Blob*> layer_blobs; // each element encapsulates the variable-size BIF::LAYER of one layer
+      uint64_t cmd_bytes_raw = 0, cmd_bytes_stored = 0;
 
-      for (unsigned int li = 0; li < layers.size(); li++) {
+      for (unsigned int li: blob_layers) {
         // PRINTD("li="<< li);
-        if (!layers[li]->produces_binary_data)
-          continue;
-
         std::cout << "== Layer " << layers[li]->getFullName() << "\n";
-        std::vector<BIF::COMMAND_SEGMENT> &layer_cmd_segs = layers[li]->generateCommandSegments();
+        std::vector<BIF::COMMAND_SEGMENT> &layer_cmd_segs = layers[li]->commands;
         std::cout << std::setw(8) << layers[li]->segments.size() << " segments -> "
                   << std::setw(6) << layer_cmd_segs.size() << " commands";
 
-        int bl_memsize = sizeof(BIF::LAYER) + sizeof(BIF::COMMAND_SEGMENT)*layer_cmd_segs.size();
+        // command list: raw COMMAND_SEGMENT array or compact stream (command_stream.h)
+        size_t cmd_bytes = sizeof(BIF::COMMAND_SEGMENT)*layer_cmd_segs.size();
+        std::vector<uint8_t> cmd_stream;
+        bool compact = compact_commands && layers[li]->getLayerType() != LAYERTYPE::SCATTER_TO_GRID; // scatter kernels index the array
+        if (compact) {
+          cmd_stream = BIF::CommandStreamWriter::encode(layer_cmd_segs);
+          std::cout << ", " << std::setw(8) << cmd_stream.size() << " / " << std::setw(8) << cmd_bytes << " command bytes";
+          cmd_bytes_raw += cmd_bytes;
+          cmd_bytes = cmd_stream.size();
+          cmd_bytes_stored += cmd_bytes;
+        }
+
+        int bl_memsize = sizeof(BIF::LAYER) + cmd_bytes;
         bl_memsize = align(bl_memsize, 32); // align start of next LAYER struct in (variable-size) array
         Blob *bl_blob = new Blob(bl_memsize);
         BIF::LAYER *bl = (BIF::LAYER*)bl_blob->data();
@@ -159,7 +463,14 @@ namespace CNN_NET {
         // fill all fields of LAYER except command segments
         layers[li]->generateBifLayer(*bl);
         bl->command_segments_count = layer_cmd_segs.size();
-        memcpy(&bl->command_segments, layer_cmd_segs.data(), sizeof(BIF::COMMAND_SEGMENT)*layer_cmd_segs.size());
+        bl->command_stream_bytes = cmd_bytes;
+        if (compact) {
+          bl->command_encoding = BIF::COMMANDS_COMPACT;
+          memcpy(&bl->command_segments, cmd_stream.data(), cmd_bytes);
+        } else {
+          bl->command_encoding = BIF::COMMANDS_RAW;
+          memcpy(&bl->command_segments, layer_cmd_segs.data(), cmd_bytes);
+        }
         // PRINTD("li = " << li);
 
         log_idx_to_bin_idx[li] = layer_blobs.size(); // layers[li] is stored in bif_layer_offs[log_idx_to_bin_idx[li]]
@@ -167,6 +478,10 @@ namespace CNN_NET {
         layer_blobs.push_back(bl_blob);
         // PRINTD("layer_blobs.size() = " << layer_blobs.size());
       }
+      if (compact_commands) {
+        std::cout << "-- compact command encoding: " << cmd_bytes_stored << " of " << cmd_bytes_raw << " byte ("
+                  << std::fixed << std::setprecision(1) << 100.0 * cmd_bytes_stored / std::max<uint64_t>(cmd_bytes_raw, 1) << "%)\n" << std::defaultfloat;
+      }
       unsigned int layer_count = layer_blobs.size(); // number of layer data structures
       std::cout << "-- " << layers.size() << " frontend layers, " << layer_count << " layers in blob, " << layer_exec_count << " layers in execlist: ";
       for (unsigned int xli = 0; xli < layer_execlist.size(); xli++) {
@@ -385,6 +700,7 @@ namespace CNN_NET {
       fd << "# Notes:\n";
       fd << "# - shapes are generally specified in whc order in cnn_converter, but actual memory layout in tensorflow notation is chw\n"; // TODO: change cnn_converter to consistently use tensorflow's notation representing actual memory layout
       fd << "# - '!' denotes 'not' in e.g. file load/save and dynamic_shape context\n";
+      fd << "# - CNN input + layer outputs: " << mm_output_size_reused << " byte (" << mm_output_size_linear << " byte without buffer reuse)\n";
       fd << "#\n";
 
       mm_addr_type addr;
@@ -466,8 +782,8 @@ namespace CNN_NET {
       return "../sim_results/l" + to_signed_string(layer.number, 3) + ".bin";
     }
     virtual bool getSimOutputActiveLayer(const CNN_LAYER::Layer &layer) {
-      // default: dump outputs and intermediate layers
-      return true;
+      // default: dump outputs and intermediate layers (only outputs if intermediate buffers are reused)
+      return !reuse_mm_buffers || run_layers_decoupled || layer.out_is_result;
     }
 
     // one file per channel
@@ -495,9 +811,22 @@ Independent execution of all layers in a net, useful to quickly identify working
 
       instantiateLayers();
 
+      generateLayerExecList();
+
+      if (fuse_layers && !run_layers_decoupled)
+        fuseLayers();
+
       designMmLayoutVpro();
 
-      generateLayerExecList();
+      applyTuningDb();
+
+      // cross-layer overlap is opt-in: a layer may start while the final stores of its predecessor are in flight
+      for (auto l: layers) {
+        l->layercfg.overlap_layer_boundaries &= overlap_layers;
+        l->prev_exec_layers.clear();
+      }
+      for (unsigned eli = 1; eli < layer_execlist.size(); eli++)
+        layers[layer_execlist[eli]]->prev_exec_layers.push_back(layers[layer_execlist[eli-1]]);
 
       if (run_layers_decoupled) {
         layers[layer_execlist.front()]->first_layer_producing_output = true;
@@ -636,6 +965,49 @@ Independent execution of all layers in a net, useful to quickly identify working
 #endif
     bool run_layers_decoupled{RUN_LAYERS_DECOUPLED};
 
+#ifndef REUSE_MM_BUFFERS
+#define REUSE_MM_BUFFERS false
+#endif
+    // liveness-based reuse of intermediate layer output buffers (designMmLayoutVpro), opt-in:
+    // intermediate outputs are not dumped to sim_results any more (getSimOutputActiveLayer)
+    bool reuse_mm_buffers{REUSE_MM_BUFFERS};
+
+#ifndef FUSE_LAYERS
+#define FUSE_LAYERS false
+#endif
+    // compute a layer's only consumer within its commands, e.g. conv + maxpool / residual add (fuseLayers), opt-in
+    bool fuse_layers{FUSE_LAYERS};
+
+#ifndef NETGEN_THREADS
+#define NETGEN_THREADS 0
+#endif
+    // worker threads for command generation (generateCommandSegments); 0: one per hardware thread, 1: serial
+    unsigned int netgen_threads{NETGEN_THREADS};
+
+#ifndef TUNE_LAYERS
+#define TUNE_LAYERS false
+#endif
+    // ISS in the loop autotuning (applyTuningDb); the database is used in any case if it exists
+    bool tune_layers{TUNE_LAYERS};
+
+#ifndef COMPACT_COMMANDS
+#define COMPACT_COMMANDS false
+#endif
+    // store each layer's commands as delta-encoded stream, decoded by the runtime while executing (command_stream.h)
+    bool compact_commands{COMPACT_COMMANDS};
+
+#ifndef OVERLAP_LAYERS
+#define OVERLAP_LAYERS false
+#endif
+    // start a layer's independent loads while the previous layer's final stores drain (layercfg.overlap_layer_boundaries);
+    // the drain is then counted in the cycles of the next layer (per layer stats)
+    bool overlap_layers{OVERLAP_LAYERS};
+    std::string tuning_db_fname{"../../cache/tuning_db.txt"};
+
+    // size of the CNN input + layer output region without / with reuse
+    mm_size_type mm_output_size_linear{};
+    mm_size_type mm_output_size_reused{};
+
     //  protected:
     std::vector<CNN_LAYER::Layer*> layers;
     std::vector<int> layer_execlist; // index into layers[]
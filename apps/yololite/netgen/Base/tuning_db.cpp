@@ -0,0 +1,136 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+#include "tuning_db.h"
+#include <sys/stat.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool TuningDB::load() {
+    std::ifstream is(fname);
+    if (!is)
+        return false;
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream ss(line);
+        uint64_t key, cycles;
+        int variant;
+        if (ss >> std::hex >> key >> std::dec >> variant >> cycles) {
+            add(key, variant, cycles);
+        } else {
+            std::cout << "Tuning database " << fname << ": ignoring invalid line '" << line << "'\n";
+        }
+    }
+    return true;
+}
+
+bool TuningDB::save() const {
+    std::ofstream fd(fname);
+    if (!fd) {
+        std::cout << "Could not open tuning database '" << fname << "' for writing\n";
+        return false;
+    }
+    fd << "# netgen tuning database: <key> <variant (SEGMENT_SCHEDULING_ORDER)> <risc cycles>\n";
+    for (auto &e: cycles_db) {
+        fd << std::hex << e.first.first << std::dec << " " << e.first.second << " " << e.second << "\n";
+    }
+    return true;
+}
+
+int TuningDB::fastest(uint64_t key, const std::vector<int> &variants, uint64_t *cycles) const {
+    int best = -1;
+    uint64_t best_cycles = UINT64_MAX;
+    for (int v: variants) {
+        auto it = cycles_db.find({key, v});
+        if (it != cycles_db.end() && it->second < best_cycles) {
+            best = v;
+            best_cycles = it->second;
+        }
+    }
+    if (cycles)
+        *cycles = best_cycles;
+    return best;
+}
+
+int TuningDB::importMeasurements(const std::string &candidates_fname, const std::string &cycles_fname) {
+    struct stat cand_stat, cyc_stat;
+    if (stat(candidates_fname.c_str(), &cand_stat) || stat(cycles_fname.c_str(), &cyc_stat))
+        return 0;
+    if (cyc_stat.st_mtime < cand_stat.st_mtime) {
+        std::cout << "Tuning: " << cycles_fname << " is older than " << candidates_fname << ", simulate the tuning blob first\n";
+        return 0;
+    }
+
+    uint64_t hw_key;
+    if (!hwKey(cycles_fname, hw_key)) {
+        std::cout << "Tuning: " << cycles_fname << " does not list the simulated hardware, measurements ignored\n";
+        return 0;
+    }
+
+    std::map<int, uint64_t> measured; // exec list index -> cycles
+    std::ifstream cyc(cycles_fname);
+    std::string line;
+    bool isolated = false;
+    int xli;
+    uint64_t cycles;
+    while (std::getline(cyc, line)) {
+        std::istringstream ss(line);
+        if (line == "# isolated")
+            isolated = true;
+        else if (!line.empty() && line[0] != '#' && ss >> xli >> cycles)
+            measured[xli] = cycles;
+    }
+    if (!isolated) {
+        std::cout << "Tuning: " << cycles_fname << " not simulated with --tune-isolated, measurements ignored\n";
+        return 0;
+    }
+
+    int imported = 0;
+    std::ifstream cand(candidates_fname);
+    while (std::getline(cand, line)) {
+        std::istringstream ss(line);
+        uint64_t key;
+        int variant;
+        if (!(ss >> xli >> std::hex >> key >> std::dec >> variant))
+            continue;
+        auto it = measured.find(xli);
+        if (it == measured.end())
+            continue;
+        add(TuningDB::key(key, hw_key), variant, it->second);
+        imported++;
+    }
+    return imported;
+}
+
+bool TuningDB::hwKey(const std::string &cycles_fname, uint64_t &hw_key) {
+    std::ifstream cyc(cycles_fname);
+    std::string line;
+    bool found = false;
+    hw_key = hash(nullptr, 0);
+    while (std::getline(cyc, line)) {
+        if (line.rfind("# hw ", 0) != 0)
+            continue;
+        hw_key = hash(line.data(), line.size(), hw_key);
+        found = true;
+    }
+    return found;
+}
+
+uint64_t TuningDB::hash(const void *data, size_t size, uint64_t h) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
@@ -0,0 +1,66 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+#ifndef TUNING_DB_H
+#define TUNING_DB_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Measured execution time of layer variants (ISS in the loop autotuning)
+//
+// Flow (see Net::applyTuningDb(), make tune_<net>), one round per variant:
+// 1. netgen with TUNE_LAYERS=1: each executed layer without complete measurements uses its next unmeasured variant
+//    -> generated/tuning_candidates.txt: "<exec list index> <key> <variant> <layer name>"
+// 2. sim --tune-isolated: per layer risc cycles, each layer from an empty DCMA without pending transfers
+//    -> sim_results/tuning_cycles.txt: "# hw <key> = <value>" lines of the simulated HWConfig, "# isolated",
+//       "<exec list index> <cycles>"; only written with --tune-isolated
+// 3. next netgen run: merges 1. + 2. into the database, layers use the fastest variant measured on the hardware of
+//    the last simulation (its "# hw" lines; simulate another configuration to tune for it)
+//
+// Database file: one "<key> <variant> <cycles>" per line; key = hash of layer parameters (BIF::LAYER) and the simulated hw config
+class TuningDB {
+public:
+    explicit TuningDB(const std::string &fname) : fname(fname) {}
+
+    // false if the file does not exist (empty database)
+    bool load();
+    bool save() const;
+
+    // later measurements overwrite earlier ones
+    void add(uint64_t key, int variant, uint64_t cycles) { cycles_db[{key, variant}] = cycles; }
+
+    bool isMeasured(uint64_t key, int variant) const { return cycles_db.count({key, variant}) > 0; }
+
+    // fastest measured variant of variants (first one on equal cycles), -1 if none is measured
+    int fastest(uint64_t key, const std::vector<int> &variants, uint64_t *cycles = nullptr) const;
+
+    // merge the result of a tuning run: candidates written by netgen, cycles written by the sim (has to be newer)
+    // returns number of imported measurements
+    int importMeasurements(const std::string &candidates_fname, const std::string &cycles_fname);
+
+    // hash of the "# hw" lines (simulated hardware) of a sim tuning_cycles file, false if there are none
+    static bool hwKey(const std::string &cycles_fname, uint64_t &hw_key);
+
+    // database key of a layer (Layer::tuningKey) measured on hardware hw_key
+    static uint64_t key(uint64_t layer_key, uint64_t hw_key) { return hash(&hw_key, sizeof(hw_key), layer_key); }
+
+    // 64 bit FNV-1a
+    static uint64_t hash(const void *data, size_t size, uint64_t h = 0xcbf29ce484222325ull);
+
+private:
+    std::string fname;
+    std::map<std::pair<uint64_t, int>, uint64_t> cycles_db; // (key, variant) -> risc cycles
+};
+
+#endif // TUNING_DB_H
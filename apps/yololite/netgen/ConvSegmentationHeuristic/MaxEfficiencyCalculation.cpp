@@ -17,6 +17,8 @@
 #include <list>
 #include <set>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <cstdio>
 #include <assert.h>
 #include "misc.h"
@@ -52,9 +54,33 @@ int MaxEfficiencyCalculation::getBlockOverlap(uint32_t blocksize, uint32_t block
     return int((blocksize * blockcount) - in_size);
 }
 
+std::map<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>, MaxEfficiencyCalculation::config_t> MaxEfficiencyCalculation::memo;
+std::mutex MaxEfficiencyCalculation::memo_mutex;
+
+double MaxEfficiencyCalculation::getCyclesLowerBound(uint n, uint block_size, uint blockcount) const {
+    // each lane computes n segments (all inc) per set
+    double sets = ceil_div(blockcount * outc, VPRO_CFG::parallel_Lanes * n);
+    double calc = sets * inc * block_size * n;
+    // inputs, kernels + bias and outputs pass main memory at least once
+    double mm = (double(inc) * in_size + double(outc) * (inc + 1) + double(outc) * in_size) / MM_ELEMENTS_PER_CYCLE;
+    return std::max(calc, mm);
+}
+
 void MaxEfficiencyCalculation::runCalculation() {
     in_size = inx * iny;
 
+    auto key = std::make_tuple(inx, iny, inc, outc);
+    {
+        std::lock_guard<std::mutex> lock(memo_mutex);
+        auto it = memo.find(key);
+        if (it != memo.end()) {
+            final = it->second;
+            printf("Eval for inx = %i, iny = %i, inc = %i, outc = %i: same as previous layer (n %i, m %i, bs %i, bc %i, eff %lf)\n",
+                   inx, iny, inc, outc, final.n, final.m, final.in_size, final.block_count, final.efficiency);
+            return;
+        }
+    }
+
     if (not silent) {
         printf("Running Eval for:\n");
         printf("  inx = %i, iny = %i, [in size = %i]\n", inx, iny, in_size);
@@ -64,86 +90,109 @@ void MaxEfficiencyCalculation::runCalculation() {
         printf("Eval for inx = %i, iny = %i, [in size = %i], inc = %i, outc = %i. HW parallel Lanes: %i\n", inx, iny, in_size, inc, outc, VPRO_CFG::parallel_Lanes);
     }
 
-    auto bs = getBlockSizeUpperBound(in_size, 1, 1);
-    auto bc = getBlockCount(bs, in_size);
-    runCalculationSegmentation(1, 1, bs, bc);
+    // ideal: all lanes busy with required calculations only
+    const double ideal_cycles = double(inc) * in_size * outc / VPRO_CFG::parallel_Lanes;
 
-    double overcalc_correction = 1. - (double(getBlockOverlap(bs, bc, in_size)) / (bs * bc));
-    double mergeEff, originalEff = calc_eff * overcalc_correction * hw_eff * 100;
-    final.efficiency = originalEff;
-    final.n = 1;
-    final.m = 1;
-    final.block_count = bc;
-    final.in_size = bs;
-    final.overcalc = getBlockOverlap(bs, bc, in_size);
+    struct candidate_t {
+        uint32_t n, bs, bc;
+        double bound_eff;   // efficiency upper bound
+        double eff{};       // evaluated efficiency (0 if pruned)
+        cost_t cost{};
+    };
+    std::vector<candidate_t> candidates; // in order of preference on equal efficiency
 
     int m = 1;  // TODO: multiple inputs...
-    //    int bs_previous = 0;
-    uint eval_count = 0;
-
-    uint count = 0;
+    auto addCandidate = [&](uint32_t n, uint32_t bs) {
+        uint32_t bc = getBlockCount(bs, in_size);
+        candidates.push_back({n, bs, bc, 100 * ideal_cycles / getCyclesLowerBound(n, bs, bc)});
+    };
+    addCandidate(1, getBlockSizeUpperBound(in_size, 1, 1));  // original
     for (uint32_t n = 2; n <= std::min(std::min(outc, in_size / 2), 62u); n += 2) {   // in_size/2 | n = 62 => bs = 14 | n = 31 => bs =  31
-        for (bs = 1; bs <= getBlockSizeUpperBound(in_size, n, m); ++bs) {  //getBlockSizeUpperBound(in_size, n, m)
-            count++;
+        for (uint32_t bs = getBlockSizeLowerBound(in_size, n, m); bs <= getBlockSizeUpperBound(in_size, n, m); ++bs) {
+            addCandidate(n, bs);
         }
     }
 
-    printf("\rRemaining: %5i Configuration for Evaluation\n", count);
-    for (uint32_t n = 2; n <= std::min(std::min(outc, in_size / 2), 62u); n += 2) {   // in_size/2 | n = 62 => bs = 14 | n = 31 => bs =  31
-        for (bs = 1; bs <= getBlockSizeUpperBound(in_size, n, m); ++bs) {  //getBlockSizeUpperBound(in_size, n, m)
-            printf("\rRemaining: %5i", count);
-            count--;
-            auto bc = getBlockCount(bs, in_size);
-            runCalculationSegmentation(n, m, bs, bc);
-
-            overcalc_correction = 1. - (double(getBlockOverlap(bs, bc, in_size)) / (bs * bc));  // pow? -> more important?!
-            mergeEff = calc_eff * overcalc_correction * hw_eff * 100;
-
+    // most promising first -> good result early -> prune by bound
+    std::vector<uint32_t> order(candidates.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return candidates[a].bound_eff > candidates[b].bound_eff;
+    });
+
+    std::mutex best_mutex;
+    double best_eff = 0;
+    std::atomic<uint32_t> next{0};
+    std::atomic<uint32_t> eval_count{0};
+    auto worker = [&]() {
+        for (uint32_t i = next++; i < order.size(); i = next++) {
+            candidate_t &c = candidates[order[i]];
+            {
+                std::lock_guard<std::mutex> lock(best_mutex);
+                // strict: candidates with equal efficiency are evaluated -> deterministic tie break
+                if (c.bound_eff < best_eff)
+                    continue;
+            }
+            c.cost = runCalculationSegmentation(c.n, m, c.bs, c.bc);
+            c.eff = 100 * ideal_cycles / c.cost.cycles;
             eval_count++;
+            std::lock_guard<std::mutex> lock(best_mutex);
+            best_eff = std::max(best_eff, c.eff);
+        }
+    };
+    unsigned int threads = std::max(1u, std::min<unsigned int>(std::thread::hardware_concurrency(), candidates.size()));
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (auto &t: pool) {
+        t.join();
+    }
 
-            if (!silent) {
-                if (PRINT_EVERY_TRY || (mergeEff > final.efficiency)) {
-                    if (mergeEff > final.efficiency) {
-                        printf("\r \n[MAX EFF] ");
-                    } else {
-                        printf("\r   current try ");
-                    }
-                    printf("Method [n %3i, m %3i]\tBlock Size: %4i,\tBlock Count: %4i,\tOverlap Elements:", n, m, bs, bc);
-                    printf("%i", getBlockOverlap(bs, bc, in_size));
-                    printf(",\tCalc Efficiency: %.03lf,\tHW Efficiency: %.03lf\t[Overcalc correction due to segment size: %.03lf]", calc_eff, hw_eff, overcalc_correction);
-                    printf("\t Total Eff: %.03lf (max: %.03lf)", mergeEff, final.efficiency);
-                    if (PRINT_EVERY_TRY_IN_NEW_LINE || (!PRINT_EVERY_TRY_IN_NEW_LINE && (mergeEff > final.efficiency))) {
-                        printf("\n");
-                    }
-                }
-            }
-            if (mergeEff > final.efficiency) {
-                final.efficiency = mergeEff;
-                final.n = n;
-                final.m = m;
-                final.block_count = bc;
-                final.in_size = bs;
-                final.overcalc = getBlockOverlap(bs, bc, in_size);
-            }
-        }   // bs
-    }   // n
-    printf("\rAll Evaluations Done!\n");
+    // best efficiency, on equal efficiency first in candidates[] (smaller n, smaller block size)
+    const candidate_t *best = &candidates[0];
+    for (const candidate_t &c: candidates) {
+        if (c.eff > best->eff)
+            best = &c;
+    }
+    final.efficiency = best->eff;
+    final.n = best->n;
+    final.m = m;
+    final.block_count = best->bc;
+    final.in_size = best->bs;
+    final.overcalc = getBlockOverlap(best->bs, best->bc, in_size);
 
-    if (not silent)
-        printf("\r \n\n#########################################\n Best Result: (n %i, m %i, bs %i, bc %i, eff %lf)\n", final.n, final.m, final.in_size, final.block_count,
+    if (not silent) {
+        printf("\n#########################################\n Best Result: (n %i, m %i, bs %i, bc %i, eff %lf)\n", final.n, final.m, final.in_size, final.block_count,
                final.efficiency);
-    else
+        printf("  Calc Efficiency: %.03lf, HW Efficiency: %.03lf, DCMA reuse: %.03lf, Overlap Elements: %i, Estimated Cycles: %.0lf\n",
+               best->cost.calc_eff, best->cost.hw_eff, best->cost.dcma_hit, final.overcalc, best->cost.cycles);
+    } else {
         printf("  Best Result: (n %i, m %i, bs %i, bc %i, eff %lf)\n", final.n, final.m, final.in_size, final.block_count, final.efficiency);
+    }
 
+    // original: n = 1, largest block (evaluated even if pruned)
+    const candidate_t &original = candidates[0];
+    double originalEff = original.eff;
+    if (originalEff == 0) {
+        originalEff = 100 * ideal_cycles / runCalculationSegmentation(original.n, m, original.bs, original.bc).cycles;
+    }
     double improvement_vs_original = final.efficiency / originalEff - 1;
     printf("  Original Eff: %.2f\n", originalEff);
-    printf("  Efficiency Improvement: +%.2f%% [After %u evaluations]\n", improvement_vs_original * 100, eval_count);
+    printf("  Efficiency Improvement: +%.2f%% [After %u of %zu evaluations, %u threads]\n", improvement_vs_original * 100,
+           eval_count.load(), candidates.size(), threads);
+
+    std::lock_guard<std::mutex> lock(memo_mutex);
+    memo[key] = final;
 }
 
-void MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint block_size, uint blockcount) {
+MaxEfficiencyCalculation::cost_t MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint block_size, uint blockcount) const {
     bool DEBUG = false;
 
     uint total_transfers = 0;
+    double total_cycles = 0;
+    double total_loaded = 0, total_mm_loaded = 0; // elements requested by the clusters / loaded from main memory
     uint total_calcs_ext_dummies = 0;
     uint total_executed_correct_segments = 0;
     uint total_executed_dummy_segments = 0;
@@ -296,10 +345,25 @@ void MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint b
 //        }
 //        c = 0;
 
+        // main memory: inputs (x) / kernels + bias (outc) used by several clusters are loaded once, DCMA serves the others
+        std::set<uint> set_x, set_outc;
+        uint set_stores = 0;
+        for (const Seg &seg: set) {
+            if (!seg.dummy) {
+                set_x.insert(seg.x);
+                set_outc.insert(seg.outc);
+                set_stores++;
+            }
+        }
+        double mm_elements = double(set_x.size()) * block_size * inc + double(set_outc.size()) * (inc + 1) + double(set_stores) * block_size;
+
         // get the list for cluster with most transfers
         uint max_dma_length = 0;
+        double max_dma_cycles = 0;
+        double loaded = 0;
         for (auto &cluster_list: cluster_dma_list) {
             uint this_dma_length = 0;
+            uint this_dma_commands = 0;
 
             // calculate the transfers for this cluster's segments (broadcasts are already merged)
             // all inc segments are required (inputs + kernel [n], if seg_blocks.empty() => store)
@@ -308,6 +372,8 @@ void MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint b
             this_dma_length += cluster_list.size() * inc;  // kernel
             this_dma_length += cluster_list.size() * block_size;  // store
             this_dma_length += cluster_list.size();   // bias
+            this_dma_commands += 3 * cluster_list.size();
+            loaded += double(cluster_list.size()) * (inc + 1);
 
             // unique without outc information -> same x -> input broadcast
             cluster_list.unique([](Seg const &s1, Seg const &s2) -> bool {
@@ -323,13 +389,17 @@ void MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint b
 //            c++;
 
             this_dma_length += cluster_list.size() * block_size * inc;   // input
+            this_dma_commands += cluster_list.size();
+            loaded += double(cluster_list.size()) * block_size * inc;
 
-            // TODO: DMA delay penalty by #nr of dma commands?
+            // DMA delay penalty by #nr of dma commands
+            double this_dma_cycles = this_dma_length / DMA_ELEMENTS_PER_CYCLE + this_dma_commands * DMA_COMMAND_OVERHEAD;
 
             // check for maximum
             if (this_dma_length >= max_dma_length) {
                 max_dma_length = this_dma_length;
             }
+            max_dma_cycles = std::max(max_dma_cycles, this_dma_cycles);
         }
         uint calc_cycles = inc * block_size * n;
 
@@ -338,14 +408,22 @@ void MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint b
             printf("total_executed_correct_segments: %i, total_executed_dummy_segments: %i\n", total_executed_correct_segments, total_executed_dummy_segments);
         }
 
+        // double buffering: compute, DMA and main memory overlap -> slowest one
+        total_cycles += std::max({double(calc_cycles), max_dma_cycles, mm_elements / MM_ELEMENTS_PER_CYCLE});
+        total_loaded += loaded;
+        total_mm_loaded += mm_elements - double(set_stores) * block_size;
+
         total_transfers += max_dma_length;
         total_calcs_ext_dummies += calc_cycles;
     }   // all segments added
 
     assert(seg_blocks.empty());
 
-    calc_eff = 100 * double(total_calcs_ext_dummies) / VPRO_CFG::parallel_Lanes / total_transfers;
-    hw_eff = double(total_executed_correct_segments) / (total_executed_dummy_segments + total_executed_correct_segments);
+    cost_t cost;
+    cost.cycles = total_cycles;
+    cost.calc_eff = 100 * double(total_calcs_ext_dummies) / VPRO_CFG::parallel_Lanes / total_transfers;
+    cost.hw_eff = double(total_executed_correct_segments) / (total_executed_dummy_segments + total_executed_correct_segments);
+    cost.dcma_hit = (total_loaded > 0) ? 1. - total_mm_loaded / total_loaded : 0;
 
     if (DEBUG) {
         printf(" Calculations (Excluding Dummy Lanes): %i\n", total_calcs_ext_dummies);
@@ -354,7 +432,9 @@ void MaxEfficiencyCalculation::runCalculationSegmentation(uint n, uint m, uint b
         printf(" Segments on Lanes: %i \n", int(total_executed_correct_segments));
         printf(" Dummy Segments on Lanes: %i \n", int(total_executed_dummy_segments));
 
-        printf("\t Calc Eff: %.08lf [Calc/Transfer]\n", calc_eff);
-        printf("\t HW Eff: %.08lf\n", hw_eff);
+        printf("\t Calc Eff: %.08lf [Calc/Transfer]\n", cost.calc_eff);
+        printf("\t HW Eff: %.08lf\n", cost.hw_eff);
+        printf("\t DCMA reuse: %.08lf, Estimated Cycles: %.0lf\n", cost.dcma_hit, cost.cycles);
     }
+    return cost;
 }
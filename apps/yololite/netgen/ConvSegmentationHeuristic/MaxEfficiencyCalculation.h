@@ -17,7 +17,22 @@
 
 #include <stdint.h>
 #include <functional>
-
+#include <map>
+#include <mutex>
+#include <tuple>
+
+/**
+ * Segmentation of 1x1 Conv2D layers (1D blocks of the input, n parallel output channels per lane)
+ *
+ * Candidates (n, block size) are scored by an estimated execution time. Per set of segments (all lanes):
+ *  - compute: inc * block size * n VPRO cycles
+ *  - DMA of the busiest cluster: transferred elements + a fixed overhead per DMA command
+ *  - main memory: elements not served by the DCMA (inputs / kernels used by several clusters are loaded once)
+ * the slowest of them determines the set's time. Efficiency = ideal compute time / estimated time.
+ *
+ * Search: candidates are evaluated in order of their optimistic bound and skipped when the bound cannot beat
+ * the best result so far. The evaluation runs on all cores, results are memoised per layer shape.
+ */
 class MaxEfficiencyCalculation {
 
 public:
@@ -54,12 +69,24 @@ public:
 
     static int getBlockOverlap(uint32_t blocksize, uint32_t blockcount, uint32_t in_size);
 
+    // cost model parameters (in VPRO cycles / 16-bit elements)
+    static constexpr double DMA_ELEMENTS_PER_CYCLE = 1;  // per cluster
+    static constexpr double DMA_COMMAND_OVERHEAD = 8;    // cycles per DMA command (setup, bus latency)
+    static constexpr double MM_ELEMENTS_PER_CYCLE = 4;   // main memory (DCMA misses), shared by all clusters
+
 private:
 
-    void runCalculationSegmentation(uint n, uint m, uint block_size, uint blockcount);
+    struct cost_t {
+        double cycles{};    // estimated execution time
+        double calc_eff{};  // compute cycles / DMA cycles (lanes busy while transferring)
+        double hw_eff{};    // non-dummy segments / all segments
+        double dcma_hit{};  // fraction of loaded elements served by DCMA (reuse across clusters)
+    };
+
+    [[nodiscard]] cost_t runCalculationSegmentation(uint n, uint m, uint block_size, uint blockcount) const;
 
-    bool PRINT_EVERY_TRY{true};
-    bool PRINT_EVERY_TRY_IN_NEW_LINE{true};
+    // lower bound of the execution time (no dummies, no DMA, every element loaded/stored once)
+    [[nodiscard]] double getCyclesLowerBound(uint n, uint block_size, uint blockcount) const;
 
     uint32_t inx{};
     uint32_t iny{};
@@ -81,7 +108,9 @@ private:
         double efficiency{};
     } final;
 
-    double calc_eff{}, hw_eff{};
+    // results of previous calculations (inx, iny, inc, outc) -> identical layers are evaluated once
+    static std::map<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>, config_t> memo;
+    static std::mutex memo_mutex;
 };
 
 
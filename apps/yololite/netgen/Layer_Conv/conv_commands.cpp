@@ -12,6 +12,8 @@
 #include "vpro_cmd_defs.h"
 
 #include "conv_layer.h"
+#include "Layer_Pooling/maxpooling2d.h"
+#include "Layer_Elwise/elwise_layer.h"
 #include "bif.h"
 
 // legacy reference uses relative mm_addr; enable diff between legacy and netgen generated commands.txt
@@ -184,6 +186,121 @@ namespace CNN_LAYER {
         }
     }
 
+    bool Conv2D::fuseDestLayer(Layer *dest) {
+        // derived layers (pooling, transpose, deformable) and layers already fused keep their own post-processing
+        if (getLayerType() != LAYERTYPE::CONV2 || pool_type != NO_POOLING || upsampling_scale != 1 || residual)
+            return false;
+
+        if (dest->getLayerType() == LAYERTYPE::MAXPOOL2D) {
+            // 2x2 max pooling of the conv result in RF (maxpool2x2_fused) after activation, as in the unfused net
+            auto mp = dynamic_cast<MaxPool2D *>(dest);
+            bool pre_zp = mp->pre_zp.top || mp->pre_zp.right || mp->pre_zp.bottom || mp->pre_zp.left;
+            if (mp->kernel_length != 2 || mp->stride != 2 || mp->padding_mode != PADDING_MODE::VALID || pre_zp ||
+                mp->activation != NO_ACTIVATION || mp->upsampling_scale != 1 ||
+                mp->store_shift_right != 0 || // shift of the 16 bit conv output not representable by the fused store shift
+                out_dim.x % 2 || out_dim.y % 2 || mp->out_dim.x * 2 != out_dim.x || mp->out_dim.y * 2 != out_dim.y)
+                return false;
+            pool_type = MAX_POOLING;
+            pool_size = {2, 2};
+            pool_stride = {2, 2};
+            pool_after_activation = true;
+            out_dim.x /= 2;
+            out_dim.y /= 2;
+            return true;
+        }
+
+        if (dest->getLayerType() == LAYERTYPE::ADD) {
+            auto add = dynamic_cast<Add *>(dest);
+            if (add->src_layers.size() != 2 || add->src_layers[0] == add->src_layers[1])
+                return false;
+            int conv_idx = (add->src_layers[0] == this) ? 0 : 1;
+            Layer *res = add->src_layers[1 - conv_idx];
+            qparam_t conv_shift = conv_idx ? add->input_shift_left_1 : add->input_shift_left_0;
+            qparam_t res_shift = conv_idx ? add->input_shift_left_0 : add->input_shift_left_1;
+
+            // residual is added as loaded: same geometry (no broadcasting), no input shift
+            // activation of the conv would have to be applied before the add
+            if (activation != NO_ACTIVATION || res_shift != 0 || !res->out_dim.algoEqual(out_dim) || !add->out_dim.algoEqual(out_dim) ||
+                add->pool_type != NO_POOLING || add->upsampling_scale != 1)
+                return false;
+
+            residual = res;
+            residual_pre_shift_right = store_shift_right;
+            residual_shift_left = conv_shift;
+
+            // post-processing of the Add takes over
+            activation = add->activation;
+            alpha = add->alpha;
+            store_shift_right = add->store_shift_right;
+            rf_frac_bits = add->rf_frac_bits;
+            alpha_mulh_shift_right = add->alpha_mulh_shift_right;
+            out_dim.fixedpoint_scaling = add->out_dim.fixedpoint_scaling;
+            return true;
+        }
+
+        return false;
+    }
+
+    void Conv::residualLoad(std::vector<SEGMENT *> &segments, int seg_cnt) {
+        // the residual tile of a set goes to the LM region shiftStoreVPRO() writes the set's result to, i.e. the
+        // transfers are the stores of that set in reverse direction, with MM addresses in the residual layout
+        // shiftStoreVPRO() alternates the store buffer per stored set, starting with B
+        if (seg_cnt == 0) {
+            residual_sets = 0;
+            residual_regions.clear();
+        }
+        BUFFER region = (residual_sets % 2) ? A : B;
+
+        std::vector<BIF::COMMAND_SEGMENT> stores;
+        std::swap(stores, commands);
+        CMD_COUNT cnt = cmd_cnt;
+        store(segments, seg_cnt, region);
+        std::swap(stores, commands);
+        cmd_cnt = cnt;
+        if (stores.empty())
+            return; // not the last set of its output channels, nothing stored
+        residual_sets++;
+        residual_regions.push_back(region);
+
+        // WAR: the region's previous content has been stored by the preceding block; DMAs are executed in order
+        const auto &res = residual->out_dim.mm;
+        for (auto cmd: stores) {
+            int ch = out_dim.ch - 1;
+            while (ch > 0 && out_dim.mm.channel_base[ch] > cmd.dma.mm_addr)
+                ch--;
+            mm_addr_type offs = cmd.dma.mm_addr - out_dim.mm.channel_base[ch];
+            cmd.dma.direction = (cmd.dma.direction == l2e1D) ? e2l1D : e2l2D;
+
+            if (res.x == out_dim.mm.x) {
+                // identical row stride (always true for the 1D segmentation of 1x1 convs, see setSegmentDimensions())
+                cmd.dma.mm_addr = res.channel_base[ch] + offs;
+                commands.push_back(cmd);
+                cmd_cnt.dma++;
+                continue;
+            }
+
+            mm_addr_type row = offs / 2 / out_dim.mm.x;
+            mm_addr_type col = offs / 2 % out_dim.mm.x;
+            cmd.dma.mm_addr = res.channel_base[ch] + 2 * (row * res.x + col);
+            if (cmd.dma.y_size == 1 || res.x >= cmd.dma.x_size) {
+                cmd.dma.y_leap = res.x - cmd.dma.x_size + 1;
+                commands.push_back(cmd);
+                cmd_cnt.dma++;
+            } else {
+                // segment wider than the residual row stride: one transfer per row (surplus elements are garbage anyway)
+                int y_size = cmd.dma.y_size;
+                cmd.dma.y_size = 1;
+                cmd.dma.y_leap = 1;
+                for (int y = 0; y < y_size; y++) {
+                    commands.push_back(cmd);
+                    cmd_cnt.dma++;
+                    cmd.dma.mm_addr += 2 * res.x;
+                    cmd.dma.lm_addr += cmd.dma.x_size;
+                }
+            }
+        }
+    }
+
     void Conv2D::load(std::vector<SEGMENT *> &segments, int seg_cnt, BUFFER &buffer) {
         if (kernel_length == 1 && pool_size[0] == 1 && stride == 1 && groups == 1 && parallel_outchannels_per_lane > 1 && upsampling_scale == 1) {
             assert(parallel_outchannels_per_lane >= 1);
@@ -241,6 +358,8 @@ namespace CNN_LAYER {
             cmd_cnt.dma += (int) dma_commands.size();
             commands.insert(std::end(commands), std::begin(dma_commands), std::end(dma_commands));
 
+            if (residual)
+                residualLoad(segments, seg_cnt);
             return;
         }   // special 1D case
 
@@ -268,6 +387,9 @@ namespace CNN_LAYER {
         auto dma_commands = DMA_COMMANDS::DMA_DESCRIPTOR::startBroadcastLoad(dmas_1d, dmas_2d);
         cmd_cnt.dma += (int) dma_commands.size();
         commands.insert(std::end(commands), std::begin(dma_commands), std::end(dma_commands));
+
+        if (residual)
+            residualLoad(segments, seg_cnt);
     }
 
     void Conv2D::store(std::vector<SEGMENT *> &segments, int seg_cnt, BUFFER &buffer) {
@@ -326,6 +448,10 @@ namespace CNN_LAYER {
 
         // post-processing
         if (segment->isLast) {
+            if (residual) {
+                cmd_cnt.vpro++;
+                commands.push_back(residualAddVPRO(mem_layout, store_buffer));
+            }
             poolActivationVPRO(mem_layout);
             
             // transfer result from RF to LM
@@ -334,6 +460,26 @@ namespace CNN_LAYER {
         }
     }
 
+    BIF::COMMAND_SEGMENT Conv::residualAddVPRO(BIF::COMMAND_VPRO &mem_layout, const BUFFER &store_buffer) {
+        BIF::COMMAND_SEGMENT cmd;
+        cmd.vpro = mem_layout;
+        cmd.vpro.command = VPRO_TYPE::residual_add_fused;
+
+        // residual tile has been loaded to where the following shiftStoreVPRO() places the result (residualLoad())
+        BUFFER region = (store_buffer == A) ? B : A;
+        assert(!residual_regions.empty() && residual_regions.front() == region && "residual tile not loaded to the store buffer");
+        residual_regions.pop_front();
+        cmd.vpro.lm_base = int(region) * VPRO_CFG::LM_SIZE/2 + VPRO_CFG::LM_SIZE / 4;
+        cmd.vpro.lm_lane_stride = lm_lane_stride;
+        cmd.vpro.shift_right = residual_pre_shift_right;
+
+        // VPRO pipeline compensation: NOPs before the 1st instruction; runtime repeats them between its instructions
+        int implicit_wait_cycles = (cmd.vpro.xend+1) * (cmd.vpro.yend+1) * (cmd.vpro.zend+1) - 1;
+        cmd.vpro.nops = std::max(0, W2R_BUBBLE_CYCLES - implicit_wait_cycles);
+
+        return cmd;
+    }
+
     void Conv::generateCommands() {
 
         kernel_x = kernel_length;
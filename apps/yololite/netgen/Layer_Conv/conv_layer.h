@@ -12,6 +12,7 @@
 #define CONV_H
 
 #include "Base/fusedfunc_layer.h"
+#include <deque>
 
 namespace CNN_LAYER {
 
@@ -33,6 +34,11 @@ namespace CNN_LAYER {
     int outchannel_block_size{-1};
     int outchannel_parallelism{-1};
 
+    // Add layer fused into this conv (fuseDestLayer()): residual tile is added to the RF result before activation
+    Layer *residual{nullptr}; // other input of the Add
+    qparam_t residual_pre_shift_right{0}; // store_shift_right of the conv result before fusion
+    qparam_t residual_shift_left{0}; // Add input shift of the conv result
+
     // methods
   public:
 
@@ -40,6 +46,8 @@ namespace CNN_LAYER {
       std::stringstream ss;
       ss << FusedFunc::getLayerInfoText();
       ss << "  conv_seg wh " << conv_seg_w << "x" << conv_seg_h << "\n";
+      if (residual)
+        ss << "  fused residual add of " << residual->getFullName() << ", pre_shift_right " << residual_pre_shift_right << ", shift_left " << residual_shift_left << "\n";
       return ss.str();
     }
 
@@ -68,12 +76,20 @@ namespace CNN_LAYER {
 
       bl.conv_result_shift_right = result_shift_right;
       bl.bias_shift_right = bias_shift_right;
+
+      if (residual) {
+        bl.elwise_0_left_shift = residual_shift_left;
+      }
     }
 
     virtual BIF::COMMAND_SEGMENT convVPRO(const CNN_LAYER::SEGMENT &segment, BUFFER &buffer, uint32_t lane_mask, BIF::COMMAND_VPRO &mem_layout);
+    virtual BIF::COMMAND_SEGMENT residualAddVPRO(BIF::COMMAND_VPRO &mem_layout, const BUFFER &store_buffer);
     virtual void compute(std::vector<SEGMENT *> &segments, int seg_cnt, BUFFER &buffer, BUFFER &store_buffer);
     virtual void generateCommands();
 
+    // residual tile of the next set: mirror image of its store (fused Add)
+    void residualLoad(std::vector<SEGMENT *> &segments, int seg_cnt);
+
   protected:
     Dim conv_out_dim;
     int conv_in_dim_w{0};
@@ -88,6 +104,9 @@ namespace CNN_LAYER {
     int conv_seg_w; // segmentation: conv output dimension (before fused pooling/upsampling)
     int conv_seg_h;
 
+    int residual_sets{0}; // stored sets with residual tile loaded so far
+    std::deque<BUFFER> residual_regions; // LM regions of loaded residual tiles not yet added by compute()
+
   }; // class Conv
 
   class Conv2D: public Conv {
@@ -112,6 +131,13 @@ namespace CNN_LAYER {
     virtual void generateSegments();
     virtual void generateCommands();
 
+    // all orders are handled by Layer::generateSegments(); derived layers (transpose, deformable, pooling) are not tuned
+    virtual std::vector<SEGMENT_SCHEDULING_ORDER> tuningVariants() {
+      if (getLayerType() != LAYERTYPE::CONV2)
+        return {};
+      return {ITERATE_ALL_SORTED_OUTC, ITERATE_ALL_SORTED_X, ITERATE_ALL_SORTED_X2};
+    }
+
     virtual void computeOutputDim() {
       // chain: zeropadding - conv - maxpool2x2
 
@@ -186,6 +212,8 @@ namespace CNN_LAYER {
       return getWeightsMMAddr() + sizeof(weight_t) * (x + kernel_length/*_x*/ * (y + kernel_length/*_y*/ * (out_channel + out_dim.ch * in_offs)));
     }
 
+    virtual bool fuseDestLayer(Layer *dest);
+
     virtual void setSegmentDimensions();
 //    virtual void calcOutputMemLayout();
 
@@ -144,7 +144,9 @@ namespace CNN_LAYER
         // inputs stored in local memory; halved for double buffering
         int lm_free_entries = VPRO_CFG::LM_SIZE / 4 - VPRO_CFG::LANES * n_weights; // each lane computes one output channel
 
-        if (layercfg.segmentation_strategy == DETAILED_HEURISTIC && kernel_length == 1 && pool_size[0] == 1 && stride == 1 && groups == 1 && upsampling_scale == 1 && pre_zp.top == 0 && pre_zp.right == 0 && pre_zp.bottom == 0 && pre_zp.left == 0) {
+        // 1D segmentation: output rows have the input row stride; a fused residual tile is loaded with the store addresses
+        bool residual_layout_1d = !residual || (residual->out_dim.mm.layout_known && residual->out_dim.mm.x == in_dim(0).mm.x);
+        if (layercfg.segmentation_strategy == DETAILED_HEURISTIC && kernel_length == 1 && pool_size[0] == 1 && stride == 1 && groups == 1 && upsampling_scale == 1 && pre_zp.top == 0 && pre_zp.right == 0 && pre_zp.bottom == 0 && pre_zp.left == 0 && residual_layout_1d) {
             // if defined [manual] by layer, use this parametrization
             if (outchannel_parallelism > 0) {    // TODO setting in layer
                 seg.num.x = MaxEfficiencyCalculation::getBlockCount(outchannel_block_size, in_dim(0).mm.x * in_dim(0).y);
@@ -291,9 +293,9 @@ namespace CNN_LAYER
                 overcalc_elements_1d = (seg.out.w * seg.num.x * seg.out.h * seg.num.y) - (out_dim.x * out_dim.y);
                 assert(overcalc_elements_1d >= 0);
             } else {
-                // check for a cache version
+                // check for a cache version (v2: MaxEfficiencyCalculation cost model incl. DMA commands and DCMA reuse)
                 char cache_fname[1024];
-                sprintf(cache_fname, "../../cache/conv2d1x1_segmentation_%dc%du%dl_%ldx%dx%d_%d.bin",
+                sprintf(cache_fname, "../../cache/conv2d1x1_segmentation_v2_%dc%du%dl_%ldx%dx%d_%d.bin",
                         VPRO_CFG::CLUSTERS, VPRO_CFG::UNITS, VPRO_CFG::LANES,
                         in_dim(0).mm.x, in_dim(0).y, in_dim(0).ch, out_dim.ch);
                 std::ifstream is(cache_fname, std::ofstream::binary | std::ofstream::in);
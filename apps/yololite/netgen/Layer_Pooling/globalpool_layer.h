@@ -91,40 +91,44 @@ namespace CNN_LAYER {
 
         // is i factorizable into x, y, z with 1<=x<=63, 1<=y<=63, 1<=z<=1023?
         static bool factorize(int i, int &x, int &y, int &z) {
-            static bool initialized = false;
-            static int max_i;
-            static std::vector<bool> factorizable;
-            static std::vector<int> x_tab;
-            static std::vector<int> y_tab;
-            static std::vector<int> z_tab;
-    
-            if (!initialized) {
-                // precompute tables
-                max_i = VPRO_CFG::LM_SIZE / 2;
-                factorizable = std::vector<bool>(max_i+1, false);
-                x_tab = std::vector<int>(max_i+1);
-                y_tab = std::vector<int>(max_i+1);
-                z_tab = std::vector<int>(max_i+1);
-                // conditions see _global_avgpool2d_add()
-                for (int x = 0; x <= (int)std::min(MAX_X_END+1, MAX_BETA); x++) {
-                    for (int y = 0; y <= (int)MAX_Y_END+1; y++) {
-                        for (int z = 0; z <= (int)MAX_Z_END; z++) {
-                            if (z > 1 && x*y > (int)MAX_GAMMA)
-                                break;
-                            int i = x*y*z;
-                            if (i > max_i)
-                                break; // increasing z will only further increase i
-                            factorizable[i] = true;
-                            x_tab[i] = x;
-                            y_tab[i] = y;
-                            z_tab[i] = z;
+            // precomputed once (thread-safe static init: commands of several layers are generated in parallel)
+            struct Tables {
+                int max_i;
+                std::vector<bool> factorizable;
+                std::vector<int> x_tab;
+                std::vector<int> y_tab;
+                std::vector<int> z_tab;
+                Tables() {
+                    max_i = VPRO_CFG::LM_SIZE / 2;
+                    factorizable = std::vector<bool>(max_i+1, false);
+                    x_tab = std::vector<int>(max_i+1);
+                    y_tab = std::vector<int>(max_i+1);
+                    z_tab = std::vector<int>(max_i+1);
+                    // conditions see _global_avgpool2d_add()
+                    for (int x = 0; x <= (int)std::min(MAX_X_END+1, MAX_BETA); x++) {
+                        for (int y = 0; y <= (int)MAX_Y_END+1; y++) {
+                            for (int z = 0; z <= (int)MAX_Z_END; z++) {
+                                if (z > 1 && x*y > (int)MAX_GAMMA)
+                                    break;
+                                int i = x*y*z;
+                                if (i > max_i)
+                                    break; // increasing z will only further increase i
+                                factorizable[i] = true;
+                                x_tab[i] = x;
+                                y_tab[i] = y;
+                                z_tab[i] = z;
+                            }
                         }
                     }
                 }
-                initialized = true;
-            }
-
-            assert(i <= max_i);
+            };
+            static const Tables tables;
+            const std::vector<bool> &factorizable = tables.factorizable;
+            const std::vector<int> &x_tab = tables.x_tab;
+            const std::vector<int> &y_tab = tables.y_tab;
+            const std::vector<int> &z_tab = tables.z_tab;
+
+            assert(i <= tables.max_i);
 
             if (!factorizable[i])
                 return false;
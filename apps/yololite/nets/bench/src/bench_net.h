@@ -0,0 +1,102 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ * 
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ * 
+ */
+
+#ifndef BENCH_NET_H
+#define BENCH_NET_H
+
+#include "layers.h"
+#include "base_net.h"
+
+using namespace CNN_LAYER;
+
+// Small fixed net for the ISS throughput benchmark (apps/benchmark)
+// - no weight, quantization or input files: weights are generated, the input is all zero (not found by the ISS)
+// - output data is meaningless, the simulated cycles only depend on the net and the hardware configuration
+class BenchNet : public CNN_NET::Net {
+
+public:
+  
+  BenchNet() : CNN_NET::Net("BENCH") {}
+
+  // deterministic weights in [-2, 2]
+  void generateWeights(Layer *l) {
+    std::vector<weight_t> weights(l->expectedWeightCount());
+    for (size_t i = 0; i < weights.size(); i++)
+      weights[i] = weight_t(int(i * 7 % 5) - 2);
+    l->setWeights(weights);
+  }
+
+  virtual void instantiateLayers() {
+
+    // input layer
+    auto l000 = new CNN_LAYER::Input;
+    l000->name = "input";
+    l000->number = 0;
+    l000->out_dim.x = 64;
+    l000->out_dim.y = 64;
+    l000->out_dim.ch = 3;
+    addLayer(l000);
+
+    //// Layer 1
+    auto l001 = new CNN_LAYER::Conv2D;
+    l001->name = "Layer_1 CONV2+BIAS+RELU";
+    l001->number = 1;
+    l001->addSrcLayers({l000});
+    l001->out_dim.ch = 16;
+    l001->padding_mode = SAME;
+    l001->kernel_length = 3;
+    l001->stride = 1;
+    l001->pool_size = {2, 2};
+    l001->pool_stride = {2, 2};
+    l001->pool_type = MAX_POOLING;
+    l001->activation = LEAKY;
+    l001->use_bias = true;
+    l001->processParams();
+    generateWeights(l001);
+    addLayer(l001);
+
+    //// Layer 2
+    auto l002 = new CNN_LAYER::Conv2D;
+    l002->name = "Layer_2 CONV2+BIAS+RELU";
+    l002->number = 2;
+    l002->addSrcLayers({l001});
+    l002->out_dim.ch = 32;
+    l002->padding_mode = SAME;
+    l002->kernel_length = 3;
+    l002->stride = 1;
+    l002->pool_type = NO_POOLING;
+    l002->activation = LEAKY;
+    l002->use_bias = true;
+    l002->processParams();
+    generateWeights(l002);
+    addLayer(l002);
+
+    //// Layer 3
+    auto l003 = new CNN_LAYER::Conv2D;
+    l003->name = "Layer_3 CONV2+BIAS+NONE";
+    l003->number = 3;
+    l003->addSrcLayers({l002});
+    l003->out_dim.ch = 16;
+    l003->padding_mode = SAME;
+    l003->kernel_length = 1;
+    l003->stride = 1;
+    l003->pool_type = NO_POOLING;
+    l003->activation = NO_ACTIVATION;
+    l003->use_bias = true;
+    l003->out_is_result = true;
+    l003->processParams();
+    generateWeights(l003);
+    addLayer(l003);
+  }
+
+}; // class BenchNet
+
+#endif // BENCH_NET_H
@@ -10,6 +10,7 @@
  */
 #include <cassert>
 #include "segment_scheduling.h"
+#include "command_stream.h"
 #include <eisv.h>
 #include <vpro.h>
 #include "calc_cnn.h"
@@ -24,10 +25,11 @@ char completeVersion[] = {
         ':', BUILD_MIN_CH0, BUILD_MIN_CH1, ':', BUILD_SEC_CH0, BUILD_SEC_CH1, '\0'
 };
 
-uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats) {
+uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats, unsigned int first_layer) {
   printf("=================== CNN execution from binary ===================\n");
 
   uint64_t totalclock = 0;
+  bool stores_pending = false; // last layer ended without waiting for its stores (BIF::LAYER::stores_pending_at_end)
   aux_reset_all_stats();
 
   assert((bnet->magicword == BIF::net_magicword) && "Magicword mismatch");
@@ -35,7 +37,7 @@ uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats) {
   if (per_layer_stats) {
     printf("layers = %d\n", bnet->layer_execlist_count);
   }
-  for (unsigned int xli = 0; xli < bnet->layer_execlist_count; xli++) { // eXecution-List Index
+  for (unsigned int xli = first_layer; xli < bnet->layer_execlist_count; xli++) { // eXecution-List Index
     unsigned int lbi = ((uint32_t*)(((uint8_t*)bnet) + (bnet->layer_execlist_offs)))[xli];
     assert((lbi < bnet->layer_count) && "Layer execution list entry is larger than number of available layers");
 
@@ -43,8 +45,9 @@ uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats) {
     const BIF::COMMAND_SEGMENT *commandSegments = &layer->command_segments[0];
 
     if (per_layer_stats) {
-      printf("layer_execlist[%3d] = %3d: layer (%3d), type %s, %6d COMMAND_SEGMENTs @ %p\n",
-             xli, lbi, layer->number, to_char(layer->type), layer->command_segments_count, (void*)commandSegments);
+      printf("layer_execlist[%3d] = %3d: layer (%3d), type %s, %6d COMMAND_SEGMENTs (%s, %" PRIu32 " byte) @ %p\n",
+             xli, lbi, layer->number, to_char(layer->type), layer->command_segments_count,
+             layer->command_encoding == BIF::COMMANDS_COMPACT ? "compact" : "raw", layer->command_stream_bytes, (void*)commandSegments);
     }
 
     // HW: communicate with host
@@ -56,9 +59,21 @@ uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats) {
     }
 
     aux_clr_sys_time();
+    char marker[48];
+    snprintf(marker, sizeof(marker), "layer %d (%s)", layer->number, to_char(layer->type));
+    sim_timeline_begin(marker);
+    // cross-layer overlap (netgen OVERLAP_LAYERS): the previous layer's final stores are still in flight;
+    // their drain is counted in this layer's cycles, so per layer stats shift compared to serial execution
+    if (stores_pending && !layer->overlap_prev_stores) {
+      vpro_sync();
+    }
     calcLayer(*layer, commandSegments, layer->command_segments_count);
-    vpro_sync();    // make shure sync is really done (double sync), as sync is not blocking any more (Sync Feature Update, 09.2023)
+    stores_pending = layer->stores_pending_at_end;
+    if (!stores_pending) {
+      vpro_sync();    // make shure sync is really done (double sync), as sync is not blocking any more (Sync Feature Update, 09.2023)
+    }
     uint32_t endclock = aux_get_sys_time_lo();
+    sim_timeline_end();
 
     // HW: communicate with host
     post_layer_hook(xli, bnet->layer_execlist_count, layer);
@@ -71,6 +86,12 @@ uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats) {
     }
   }
 
+  if (stores_pending) {
+    aux_clr_sys_time();
+    vpro_sync();
+    totalclock += aux_get_sys_time_lo();
+  }
+
   return totalclock;
 }
 
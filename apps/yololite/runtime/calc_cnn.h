@@ -34,7 +34,11 @@ enum ARM_RV_Comm : uint32_t {
 void pre_layer_hook(int layer_exec_idx, int total_layers, const BIF::LAYER *layer);
 void post_layer_hook(int layer_exec_idx, int total_layers, const BIF::LAYER *layer);
 
-uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats);
+/**
+ * executes the layer execution list from index first_layer (e.g. after a simulator checkpoint of
+ * the previous layers, sim/sim.cpp)
+ */
+uint64_t calcCnn(BIF::NET *bnet, bool per_layer_stats, unsigned int first_layer = 0);
 
 void print_cnn_stats(uint64_t totalclock, unsigned int clockfreq_mhz);
 
@@ -170,4 +170,84 @@ inline void _elwise(VPRO_TYPE command, int32_t input_0_left_shift, int32_t input
     }
 }
 
+// RF in place: x = x >> shift_right (negative: left shift)
+inline void _rf_shift(int shift_right, uint32_t xend, uint32_t yend, uint32_t zend, uint32_t rf_ch_stride, uint32_t rf_base, LANE lanes) {
+    int w = xend + 1;
+    if (shift_right > 0) {
+        VPRO::DIM3::PROCESSING::shift_ar(lanes,
+                                         DST_ADDR (rf_base, 1, w, rf_ch_stride),
+                                         SRC1_ADDR(rf_base, 1, w, rf_ch_stride),
+                                         SRC2_IMM_3D(shift_right),
+                                         xend, yend, zend);
+    } else if (shift_right < 0) {
+        VPRO::DIM3::PROCESSING::mull(lanes,
+                                     DST_ADDR (rf_base, 1, w, rf_ch_stride),
+                                     SRC1_ADDR(rf_base, 1, w, rf_ch_stride),
+                                     SRC2_IMM_3D(1 << (-shift_right)),
+                                     xend, yend, zend);
+    }
+}
+
+// RF in place: x = min(max(x, INT16_MIN), INT16_MAX)
+inline void _rf_saturate16(int nops, uint32_t xend, uint32_t yend, uint32_t zend, uint32_t rf_ch_stride, uint32_t rf_base, LANE lanes) {
+    int w = xend + 1;
+    VPRO::DIM3::PROCESSING::min(lanes,
+                                DST_ADDR (rf_base, 1, w, rf_ch_stride),
+                                SRC1_ADDR(rf_base, 1, w, rf_ch_stride),
+                                SRC2_IMM_3D(INT16_MAX),
+                                xend, yend, zend);
+    insertNops(nops);
+    VPRO::DIM3::PROCESSING::max(lanes,
+                                DST_ADDR (rf_base, 1, w, rf_ch_stride),
+                                SRC1_ADDR(rf_base, 1, w, rf_ch_stride),
+                                SRC2_IMM_3D(INT16_MIN),
+                                xend, yend, zend);
+}
+
+// Add fused into the preceding conv: conv result (RF) + residual tile (LM, loaded by DMA to the result region of each lane)
+// - conv result is brought to the fixed-point format of the add like in the unfused net:
+//   shift by the former store shift of the conv, limit to the 16 bit of its LM store, then shift by the add's input shift
+// - the residual input is added unshifted
+// - result stays in RF for activation and _shift_store(), which overwrites the residual tile
+inline void _residual_add(int pre_shift_right, int32_t input_left_shift, int nops, uint32_t xend, uint32_t yend, uint32_t zend,
+                          uint32_t rf_ch_stride, uint32_t lm_ch_stride,
+                          uint32_t rf_base, uint32_t lm_base, int32_t lm_lane_stride, LANE lanes) {
+    if (pre_shift_right != 0) {
+        _rf_shift(pre_shift_right, xend, yend, zend, rf_ch_stride, rf_base, lanes);
+        insertNops(nops);
+    }
+    _rf_saturate16(nops, xend, yend, zend, rf_ch_stride, rf_base, lanes);
+    insertNops(nops);
+    if (input_left_shift != 0) {
+        _rf_shift(-input_left_shift, xend, yend, zend, rf_ch_stride, rf_base, lanes);
+        insertNops(nops);
+    }
+
+    int w = xend + 1;
+    if (lanes & L0) {
+        VPRO::DIM3::LOADSTORE::loads(lm_base,
+                                     0, 1, w, lm_ch_stride,
+                                     xend, yend, zend);
+
+        VPRO::DIM3::PROCESSING::add(L0,
+                                    DST_ADDR (rf_base, 1, w, rf_ch_stride),
+                                    SRC1_ADDR(rf_base, 1, w, rf_ch_stride),
+                                    SRC2_LS_3D,
+                                    xend, yend, zend,
+                                    false, true, true); // update flags for _act_leakyrelu()
+    }
+    if (lanes & L1) {
+        VPRO::DIM3::LOADSTORE::loads(lm_base + lm_lane_stride,
+                                     0, 1, w, lm_ch_stride,
+                                     xend, yend, zend);
+
+        VPRO::DIM3::PROCESSING::add(L1,
+                                    DST_ADDR (rf_base, 1, w, rf_ch_stride),
+                                    SRC1_ADDR(rf_base, 1, w, rf_ch_stride),
+                                    SRC2_LS_3D,
+                                    xend, yend, zend,
+                                    false, true, true);
+    }
+}
+
 #endif // ELWISE_KERNEL_H
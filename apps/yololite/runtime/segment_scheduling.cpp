@@ -12,6 +12,7 @@
 #include <algorithm>
 
 #include "segment_scheduling.h"
+#include "command_stream.h"
 #include "vpro_functions.h"
 #include <vpro.h>
 #include "eisv.h"
@@ -420,8 +421,8 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
     int vpro_syncs = 0;
 #endif
 
-    intptr_t start_segment = intptr_t(&segments[0]);
-    intptr_t end_segment = intptr_t(&segments[0]) + seg_size * sizeof(COMMAND_SEGMENT);
+    // raw COMMAND_SEGMENT array or compact stream (LAYER.command_encoding, command_stream.h)
+    CommandStreamReader stream(layer, segments, seg_size);
 
 #ifndef SIMULATION
     // declaration of a uint32_t variabale here will force gcc application for risc-v only to load the dcache short address once!?
@@ -429,12 +430,11 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
 #endif
 
 // #pragma GCC unroll 8
-    // FIXME why intptr_t instead of
-    for (intptr_t seg_cnt = start_segment; seg_cnt < end_segment; seg_cnt += sizeof(COMMAND_SEGMENT)) {
-        // hint: seg_cnt is also incremented manually within loop
-#define CMD ((COMMAND_SEGMENT *)seg_cnt)
+    while (const COMMAND_SEGMENT *cmd = stream.next()) {
+        // hint: DMA blocks skip their commands within loop
+#define CMD cmd
 
-        int cmd_idx = (seg_cnt - start_segment) / sizeof(COMMAND_SEGMENT);
+        int cmd_idx = stream.consumed() - 1;
 
 #ifdef SIMULATION
         printProgress(cmd_idx, seg_size, 60, last_progress);
@@ -463,8 +463,8 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
             uint block_size = dmab.unit_mask;
 //            printf_warning("DMA BLOCK Segment! [size; %i]\n", block_size); // , start: %li, seg_cnt);
             dma_block_size(block_size);
-            dma_block_addr_trigger((void *)(seg_cnt + sizeof(COMMAND_SEGMENT)));
-            seg_cnt += block_size * sizeof(COMMAND_SEGMENT);
+            dma_block_addr_trigger((void *)(CMD + 1));
+            stream.skip(block_size);
         } else if (CMD->type.type == VPRO_CMD) {
 #if defined(RV_PRINT_SEGMENT_CNT)
             vpros++;
@@ -520,6 +520,10 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
             } else if (IMPL_ADD && vpro.command == VPRO_TYPE::add) {
                 insertNops(vpro.nops);
                 _elwise(vpro.command, layer.elwise_0_left_shift, layer.elwise_1_left_shift, vpro.broadcast_map, vpro.xend, vpro.yend, vpro.rf_base, vpro.lm_base);
+            } else if (IMPL_ADD && vpro.command == VPRO_TYPE::residual_add_fused) {
+                insertNops(vpro.nops);
+                _residual_add(vpro.shift_right, layer.elwise_0_left_shift, vpro.nops, vpro.xend, vpro.yend, vpro.zend, vpro.rf_ch_stride, vpro.lm_ch_stride,
+                              vpro.rf_base, vpro.lm_base, vpro.lm_lane_stride, (LANE)vpro.lane_mask);
             } else if (IMPL_MUL && vpro.command == VPRO_TYPE::mul) {
                 insertNops(vpro.nops);
 
@@ -639,7 +643,7 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
             // load dcache line for segments to avoid dcache stall in next loop iterations
                     {
                         auto dcache_line_size_bytes = 4096; // 1024 Bytes in 64 x 128-bit words
-                        [[maybe_unused]] volatile auto tmp = *(reinterpret_cast<const uint8_t *>(seg_cnt) + dcache_line_size_bytes);
+                        [[maybe_unused]] volatile auto tmp = *(stream.position() + dcache_line_size_bytes);
                     }
 #endif
             vpro_sync();
@@ -652,7 +656,7 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
             // load dcache line for segments to avoid dcache stall in next loop iterations
                     {
                         auto dcache_line_size_bytes = 4096; // 1024 Bytes in 64 x 128-bit words
-                        [[maybe_unused]] volatile auto tmp = *(reinterpret_cast<const uint8_t *>(seg_cnt) + dcache_line_size_bytes);
+                        [[maybe_unused]] volatile auto tmp = *(stream.position() + dcache_line_size_bytes);
                     }
 #endif
             vpro_dma_sync();
@@ -665,7 +669,7 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
             // load dcache line for segments to avoid dcache stall in next loop iterations
                     {
                         auto dcache_line_size_bytes = 4096; // 1024 Bytes in 64 x 128-bit words
-                        [[maybe_unused]] volatile auto tmp = *(reinterpret_cast<const uint8_t *>(seg_cnt) + dcache_line_size_bytes);
+                        [[maybe_unused]] volatile auto tmp = *(stream.position() + dcache_line_size_bytes);
                     }
 #endif
             vpro_lane_sync();
@@ -675,10 +679,10 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
 #if defined(RV_PRINT_SEGMENT_CNT)
             dmas++;
 #endif
-            dma_dcache_short_command((void*)(seg_cnt));
+            dma_dcache_short_command((void*)(CMD));
 #if(defined(LIMIT_IMPL) && defined(IMPL_DCONV) || not defined(LIMIT_IMPL))
         } else if (IMPL_DCONV && CMD->type.type == DMA_SET_PADDING) {
-            auto dma_padding = ((COMMAND_DMA_PADDING *)seg_cnt);
+            auto dma_padding = ((const COMMAND_DMA_PADDING *)CMD);
             dma_set_pad_widths(dma_padding->pad.top, dma_padding->pad.right, dma_padding->pad.bottom, dma_padding->pad.left);
             dma_set_pad_value(dma_padding->pad.value);
 #endif
@@ -688,8 +692,8 @@ void calcLayer(LAYER &layer, const COMMAND_SEGMENT *segments, const uint32_t seg
             aux_print_debugfifo(0xdead1009);
             printf("\n[Error] Segment type unknown!\n");
             printf("Segment.type 0x%8x\n", (unsigned int) CMD->type.type);
-            printf("Segment[%u] @ 0x%8x\n", (unsigned int) ((seg_cnt - start_segment) / sizeof(COMMAND_SEGMENT)),
-                   (unsigned int) uint32_t(seg_cnt));
+            printf("Segment[%u] @ 0x%8x\n", (unsigned int) cmd_idx,
+                   (unsigned int) uint32_t(intptr_t(CMD)));
             exit(1);
         } // case    / if
     } // for all cmd segments
@@ -11,6 +11,9 @@
 
 #include <stdint.h>
 #include <string>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 #include "riscv/eisV_hardware_info.hpp"
 #include "vpro_functions.h"
 #include "segment_scheduling.h"
@@ -32,13 +35,62 @@
 #endif
 
 
+/**
+ * risc cycles per executed layer: "<exec list index> <cycles>", preceded by "# hw <key> = <value>"
+ * lines of the simulated hardware (HWConfig). input of netgen's autotuning (netgen/Base/tuning_db.h),
+ * written to tuning_cycles.txt with --tune-isolated only
+ */
+std::ofstream tuning_cycles;
+
+/**
+ * --tune-isolated (make tune_%): every layer starts with a clean and empty DCMA and no pending
+ * transfers, its cycles do not depend on the variants of the previous layers. writes tuning_cycles
+ */
+bool tune_isolated = false;
+
+/**
+ * simulator checkpoint after a layer (exec list index), removed from argv before sim_init:
+ *   --checkpoint-save=<layer>:<file>     saves the state after the layer
+ *   --checkpoint-restore=<layer>:<file>  restores the state saved after the layer, continues with
+ *                                        the next one (reported cycles: remaining layers only)
+ */
+int checkpoint_save_layer = -1, checkpoint_restore_layer = -1;
+std::string checkpoint_save_file, checkpoint_restore_file;
+
+bool parseCheckpointArg(const std::string &arg, const char *option, int &layer,
+                        std::string &file) {
+    if (arg.rfind(option, 0) != 0) return false;
+    std::string value = arg.substr(strlen(option));
+    size_t colon = value.find(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == value.size()) {
+        printf_error("%s expects <layer>:<file> (got %s)\n", option, value.c_str());
+        exit(EXIT_FAILURE);
+    }
+    layer = std::stoi(value.substr(0, colon));
+    file = value.substr(colon + 1);
+    return true;
+}
+
 void pre_layer_hook(int layer_exec_idx, int total_layers, const BIF::LAYER *layer) {
+    // before the layer's sys time is cleared -> not part of its cycles
+    if (tune_isolated) {
+        vpro_sync();
+        dcma_flush();
+        dcma_reset();
+    }
 #if RV_EVAL==1
     pre_layer_stat_update(layer_exec_idx, total_layers, layer, RV_PRINT_LAYER_CYCLE_DETAILS);
 #endif
 }
 
 void post_layer_hook(int layer_exec_idx, int total_layers, const BIF::LAYER *layer) {
+    // sys time has been cleared before the layer
+    if (tuning_cycles.is_open())
+        tuning_cycles << layer_exec_idx << " " << aux_get_sys_time_lo() << "\n";
+    if (layer_exec_idx == checkpoint_save_layer) {
+        vpro_sync();  // stores may be pending (BIF::LAYER::stores_pending_at_end)
+        if (sim_checkpoint_save(checkpoint_save_file.c_str()) != 0) exit(EXIT_FAILURE);
+    }
 #if RV_EVAL==1
     post_layer_stat_update(layer_exec_idx, total_layers, layer, RV_PRINT_LAYER_CYCLE_DETAILS);
 #endif
@@ -50,6 +102,23 @@ void post_layer_hook(int layer_exec_idx, int total_layers, const BIF::LAYER *lay
 //----------------------------------------------------------------------------------
 
 int main(int argc, char *argv[]) {
+    // second call (simulation thread) gets the argv without these
+    int remaining = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        bool checkpoint_arg =
+            parseCheckpointArg(arg, "--checkpoint-save=", checkpoint_save_layer,
+                               checkpoint_save_file) ||
+            parseCheckpointArg(arg, "--checkpoint-restore=", checkpoint_restore_layer,
+                               checkpoint_restore_file);
+        if (arg == "--tune-isolated")
+            tune_isolated = true;
+        else if (!checkpoint_arg)
+            argv[remaining++] = argv[i];
+    }
+    argc = remaining;
+    argv[argc] = nullptr;
+
     sim_init(main, argc, argv);
 
     aux_print_hardware_info("CNN sim", versionVersion, completeVersion);
@@ -57,29 +126,16 @@ int main(int argc, char *argv[]) {
     // check HW config of this cnn's App config
     //sim_min_req(VPRO_CFG::CLUSTERS, VPRO_CFG::UNITS, VPRO_CFG::LANES); @DEPRECATED
 
-    BIF::NET *net;
-    {
-      // copy eisvblob from simulator memory into host (x86) memory
-      uint32_t eisvblob_addr = 0x06000000;
-      int copysize = 0;
-      {
-        BIF::NET net;
-        
-        for (int i = 0; i < 8; i++) {
-          core_->dbgMemRead(eisvblob_addr + i, ((uint8_t*)&net) + i);
-        }
-        std::cout << "net.magicword = " << net.magicword << "\n";
-        std::cout << "net.blobsize = " << net.blobsize << "\n";
-        assert(net.magicword == BIF::net_magicword && "Magicword mismatch");
-        copysize = net.blobsize;
-      }
-
-      net = (BIF::NET *)malloc(copysize);
-      for (int i = 0; i < copysize; i++) {
-        core_->dbgMemRead(eisvblob_addr + i, ((uint8_t*)net) + i);
-      }
-      
-    }
+    // eisvblob interpreted in place in the simulated main memory (as on the risc), no host copy
+    uint32_t eisvblob_addr = 0x06000000;
+    BIF::NET *net = (BIF::NET *)core_->dbgMemPtr(eisvblob_addr, sizeof(BIF::NET));
+    assert(net != nullptr && "eisvblob header out of main memory");
+    std::cout << "net.magicword = " << net->magicword << "\n";
+    std::cout << "net.blobsize = " << net->blobsize << "\n";
+    assert(net->magicword == BIF::net_magicword && "Magicword mismatch");
+    // range check of the whole blob
+    net = (BIF::NET *)core_->dbgMemPtr(eisvblob_addr, net->blobsize);
+    assert(net != nullptr && "eisvblob exceeds main memory");
 
     vpro_set_cluster_mask(0xFFFFFFFF);
     vpro_set_unit_mask(0xFFFFFFFF);
@@ -89,7 +145,21 @@ int main(int argc, char *argv[]) {
     // reset DCMA to load new input into cache
     dcma_reset();
         
-    uint64_t totalclock = calcCnn(net, RV_PRINT_LAYER_CYCLE_DETAILS);
+    unsigned int first_layer = 0;
+    if (checkpoint_restore_layer >= 0) {
+        if (sim_checkpoint_restore(checkpoint_restore_file.c_str()) != 0) exit(EXIT_FAILURE);
+        first_layer = checkpoint_restore_layer + 1;
+    }
+
+    if (tune_isolated) {
+        tuning_cycles.open("tuning_cycles.txt");
+        std::istringstream hw_config(core_->getHWConfig().toString().toStdString());
+        for (std::string line; std::getline(hw_config, line);)
+            tuning_cycles << "# hw " << line << "\n";
+        tuning_cycles << "# isolated\n";
+    }
+    uint64_t totalclock = calcCnn(net, RV_PRINT_LAYER_CYCLE_DETAILS, first_layer);
+    if (tuning_cycles.is_open()) tuning_cycles.close();
 
     // include dcma flush cycles in profiling
     dcma_flush();
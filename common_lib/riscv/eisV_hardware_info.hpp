@@ -65,9 +65,9 @@ aux_print_hardware_info(const char appname[] = static_defaultAppName, const char
     printf("Frequency DMA:   %d MHz\n", int(1000 / core_->getDMAClockPeriod()));
     printf("Frequency AXI:   %d MHz\n", int(1000 / core_->getAxiClockPeriod()));
     printf("VPRO Config:\n");
-    printf("  Clusters:                  %i\n", VPRO_CFG::CLUSTERS);
-    printf("  Units per Cluster:         %i\n", VPRO_CFG::UNITS);
-    printf("  Proc. Lanes per Unit:      %i\n", VPRO_CFG::LANES);
+    printf("  Clusters:                  %u\n", core_->getHWConfig().clusters);
+    printf("  Units per Cluster:         %u\n", core_->getHWConfig().units);
+    printf("  Proc. Lanes per Unit:      %u\n", core_->getHWConfig().lanes);
     printf("DCMA Config:\n");
     if (get_gpr_DCMA_off() == 0){
         printf("  Num RAMs:                  %ld\n", get_gpr_DCMA_nr_rams());
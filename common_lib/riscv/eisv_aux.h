@@ -489,6 +489,10 @@ inline void prefetch_dcache(uint32_t addr){
     DCACHE_PREFETCH_TRIGER = addr;
 }
 
+// timeline markers of the simulator (iss_aux.h)
+inline void sim_timeline_begin(const char* name) {}
+inline void sim_timeline_end() {}
+
 #else   // SIMULATION
 
 inline void aux_clr_icache_miss_cnt(){}
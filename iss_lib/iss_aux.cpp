@@ -55,7 +55,7 @@ void dma_wait_to_finish(uint32_t cluster_mask) {
     }
 
     core_->io_write(VPRO_BUSY_MASK_CL_ADDR, cluster_mask);
-    while (core_->io_read(VPRO_BUSY_MASKED_DMA_ADDR) != 0) {}
+    core_->io_wait(VPRO_BUSY_MASKED_DMA_ADDR, 0xffffffff);
     core_->setWaitingToFinish(false);
 
     if (CREATE_CMD_HISTORY_FILE) {
@@ -82,9 +82,8 @@ void vpro_dma_sync() {
 
 void dma_dcache_short_command(const void* ptr) {
 #ifdef ISS_STANDALONE
-    while (core_->io_read(IDMA_COMMAND_FSM_ADDR) != 0) {
-        core_->runUntilRiscReadyForCmd();  // "Risc" takes 2 cycles until this check is parsed
-    }                                      // wait to finish current block loop
+    // "Risc" takes 2 cycles until this check is parsed, wait to finish current block loop
+    core_->io_wait(IDMA_COMMAND_FSM_ADDR, 0xffffffff, true);
 #endif
 
     core_->io_write(IDMA_COMMAND_DCACHE_ADDR + 1, uint32_t(intptr_t(ptr) >> 32));
@@ -93,18 +92,16 @@ void dma_dcache_short_command(const void* ptr) {
 
 void dma_block_size(const uint32_t& size) {
     core_->runUntilRiscReadyForCmd();  // "Risc" takes 2 cycles until this check is parsed
-    while (core_->io_read(IDMA_COMMAND_FSM_ADDR) != 0) {
-        core_->runUntilRiscReadyForCmd();  // "Risc" takes 2 cycles until this check is parsed
-    }                                      // wait to finish current block loop
+    // wait to finish current block loop
+    core_->io_wait(IDMA_COMMAND_FSM_ADDR, 0xffffffff, true);
 
     core_->io_write(IDMA_COMMAND_BLOCK_SIZE_ADDR, size);
 }
 
 void dma_block_addr_trigger(const void* ptr) {
     core_->runUntilRiscReadyForCmd();  // "Risc" takes 2 cycles until this check is parsed
-    while (core_->io_read(IDMA_COMMAND_FSM_ADDR) != 0) {
-        core_->runUntilRiscReadyForCmd();  // "Risc" takes 2 cycles until this check is parsed
-    }                                      // wait to finish current block loop
+    // wait to finish current block loop
+    core_->io_wait(IDMA_COMMAND_FSM_ADDR, 0xffffffff, true);
 
     core_->io_write(IDMA_COMMAND_BLOCK_ADDR_TRIGGER_ADDR + 1, uint32_t(intptr_t(ptr) >> 32));
     core_->io_write(IDMA_COMMAND_BLOCK_ADDR_TRIGGER_ADDR, uint32_t(intptr_t(ptr)));
@@ -160,7 +157,7 @@ void dma_e2l_2d(uint32_t cluster_mask,
         // TODO: if y size == 1, no padding possible!?!
     }
 
-    if (ext_base <= VPRO_CFG::MM_SIZE - 1) {
+    if (ext_base <= core_->getMMSize() - 1) {
         core_->io_write(IDMA_EXT_BASE_ADDR_E2L_ADDR, uint32_t(ext_base));
     } else {
         core_->io_write(IDMA_EXT_BASE_ADDR_E2L_ADDR + 1, uint32_t(ext_base >> 32));
@@ -194,7 +191,7 @@ void dma_l2e_2d(uint32_t cluster_mask,
         core_->io_write(IDMA_X_STRIDE_ADDR, x_stride);
     }
 
-    if (ext_base <= VPRO_CFG::MM_SIZE - 1) {
+    if (ext_base <= core_->getMMSize() - 1) {
         core_->io_write(IDMA_EXT_BASE_ADDR_L2E_ADDR, uint32_t(ext_base));
     } else {
         core_->io_write(IDMA_EXT_BASE_ADDR_L2E_ADDR + 1, uint32_t(ext_base >> 32));
@@ -212,7 +209,7 @@ void dma_print_access_counters() {
         1000 / core_->getDMAClockPeriod(),
         RESET_COLOR);
 
-    for (int cluster = 0; cluster < VPRO_CFG::CLUSTERS; cluster++) {
+    for (int cluster = 0; cluster < int(core_->getHWConfig().clusters); cluster++) {
         uint32_t read_hit_cycles = core_->io_read(IDMA_READ_HIT_CYCLES_ADDR);
         uint32_t read_miss_cycles = core_->io_read(IDMA_READ_MISS_CYCLES_ADDR);
         uint32_t write_hit_cycles = core_->io_read(IDMA_WRITE_HIT_CYCLES_ADDR);
@@ -231,13 +228,13 @@ void dma_print_access_counters() {
 // *** VPRO DCMA *** //
 
 void dcma_flush() {
-    while (core_->io_read(DCMA_WAIT_BUSY_ADDR)) {}
+    core_->io_wait(DCMA_WAIT_BUSY_ADDR, 0xffffffff);
     core_->io_write(DCMA_FLUSH_ADDR, 0);
-    while (core_->io_read(DCMA_WAIT_BUSY_ADDR)) {}
+    core_->io_wait(DCMA_WAIT_BUSY_ADDR, 0xffffffff);
 }
 
 void dcma_reset() {
-    while (core_->io_read(DCMA_WAIT_BUSY_ADDR)) {}
+    core_->io_wait(DCMA_WAIT_BUSY_ADDR, 0xffffffff);
     core_->io_write(DCMA_RESET_ADDR, 0);
 };
 
@@ -252,7 +249,7 @@ void vpro_wait_busy(uint32_t cluster_mask, uint32_t unit_mask, int cycle) {
 void vpro_wait_busy(uint32_t cluster_mask, uint32_t unit_mask) {
     core_->setWaitingToFinish(true);
     core_->io_write(VPRO_BUSY_MASK_CL_ADDR, cluster_mask);
-    while ((core_->io_read(VPRO_BUSY_MASKED_VPRO_ADDR) & unit_mask) != 0) {}
+    core_->io_wait(VPRO_BUSY_MASKED_VPRO_ADDR, unit_mask);
     core_->setWaitingToFinish(false);
     if (CREATE_CMD_HISTORY_FILE) {
         QString cmd_description = "VPRO Sync";
@@ -453,6 +450,34 @@ void sim_stat_reset() {
     core_->sim_stats_reset();
 }
 
+int sim_checkpoint_save(const char* file_name) {
+    return core_->sim_checkpoint_save(file_name);
+}
+
+int sim_checkpoint_restore(const char* file_name) {
+    return core_->sim_checkpoint_restore(file_name);
+}
+
+int sim_trace_record(const char* file_name) {
+    return core_->sim_trace_record(file_name);
+}
+
+void sim_trace_record_stop() {
+    core_->sim_trace_record_stop();
+}
+
+int sim_trace_replay(const char* file_name) {
+    return core_->sim_trace_replay(file_name);
+}
+
+void sim_timeline_begin(const char* name) {
+    core_->sim_timeline_begin(name);
+}
+
+void sim_timeline_end() {
+    core_->sim_timeline_end();
+}
+
 void sim_printf(const char* format) {
     printf("#SIM_PRINTF: ");
     printf("%s", format);
@@ -171,6 +171,33 @@ void sim_dump_queue(uint32_t cluster, uint32_t unit);
 
 void sim_stat_reset();
 
+/**
+ * Checkpoint of the complete simulator state (e.g. after a layer) to resume the simulation later on
+ * VPRO and DMA have to be idle (vpro_sync())
+ * @param file_name checkpoint file
+ * @return 0 on success
+ */
+int sim_checkpoint_save(const char* file_name);
+int sim_checkpoint_restore(const char* file_name);
+
+/**
+ * Command trace of all following VPRO / DMA commands, io accesses, syncs and main memory writes,
+ * replayable without the application (apps/replay). Also: sim_init argument --record-trace=<file>
+ * VPRO and DMA have to be idle (vpro_sync())
+ * @param file_name trace file
+ * @return 0 on success
+ */
+int sim_trace_record(const char* file_name);
+void sim_trace_record_stop();
+int sim_trace_replay(const char* file_name = nullptr);
+
+/**
+ * Named span on the runtime track of the timeline (sim_init argument --timeline=<file.json>),
+ * e.g. around a layer. Markers nest, no-op without timeline (and on hardware)
+ */
+void sim_timeline_begin(const char* name);
+void sim_timeline_end();
+
 void sim_printf(const char* format);
 
 template <typename... Args>
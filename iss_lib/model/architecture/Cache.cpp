@@ -13,6 +13,8 @@
 //
 
 #include "Cache.h"
+#include "../../simulator/helper/checkpoint.h"
+#include "../../simulator/helper/timeline.h"
 
 Cache::Cache(ISS* core,
     uint32_t line_size,
@@ -33,6 +35,7 @@ Cache::Cache(ISS* core,
     tag_memory = std::vector<uint32_t>(config.nr_lines, 0);
     dirty_flags = std::vector<bool>(config.nr_lines, false);
     valid_flags = std::vector<bool>(config.nr_lines, false);
+    prefetched_flags = std::vector<bool>(config.nr_lines, false);
 
     bus_buffer = std::vector<uint8_t>(line_size, 0);
 
@@ -55,6 +58,9 @@ Cache::Cache(ISS* core,
     if (replacement_policy == ReplacementPolicy::LFU) {
         replacement_memory = std::vector<uint32_t>(config.nr_lines, 0);
     }
+    if (replacement_policy == ReplacementPolicy::PLRU) {
+        replacement_memory = std::vector<uint32_t>(config.nr_lines, 0);
+    }
 
     // init brams
     for (int i = 0; i < nr_brams; ++i) {
@@ -137,6 +143,7 @@ void Cache::dmaReadDataHit(uint32_t addr_in, uint8_t* data_ptr) {
     uint32_t bram_addr = getBramAddr(cache_addr);
     brams[bram_idx].read(bram_addr, data_ptr);
     brams[bram_idx].set_accessed_this_cycle(true);
+    accessLine(line + set_offset, addr_in);
 
     if (replacement_policy == ReplacementPolicy::LRU) {
         // increment replacement memory of other lines in a set
@@ -148,6 +155,8 @@ void Cache::dmaReadDataHit(uint32_t addr_in, uint8_t* data_ptr) {
         }
     } else if (replacement_policy == ReplacementPolicy::LFU) {
         replacement_memory[set_offset + line]++;
+    } else if (replacement_policy == ReplacementPolicy::PLRU) {
+        plruTouch(set_offset, line);
     }
 }
 
@@ -175,6 +184,7 @@ void Cache::dmaWriteDataHit(uint32_t addr_in, uint8_t* data_ptr) {
     brams[bram_idx].set_accessed_this_cycle(true);
 
     dirty_flags[line + set_offset] = true;
+    accessLine(line + set_offset, addr_in);
 
     if (replacement_policy == ReplacementPolicy::LRU) {
         // increment replacement memory of other lines in a set
@@ -186,7 +196,51 @@ void Cache::dmaWriteDataHit(uint32_t addr_in, uint8_t* data_ptr) {
         }
     } else if (replacement_policy == ReplacementPolicy::LFU) {
         replacement_memory[set_offset + line]++;
+    } else if (replacement_policy == ReplacementPolicy::PLRU) {
+        plruTouch(set_offset, line);
+    }
+}
+
+void Cache::accessLine(uint32_t line, uint32_t addr) {
+    if (prefetched_flags[line]) {
+        prefetched_flags[line] = false;
+        Statistics::get().getDCMAStat()->counters.prefetch_useful++;
     }
+    if (!classify_misses) return;
+
+    uint32_t line_addr = addr / config.line_size;
+    if (line_addr == shadow_last_line) return;  // already most recently used
+    shadow_last_line = line_addr;
+
+    auto it = shadow_lines.find(line_addr);
+    if (it != shadow_lines.end()) {
+        shadow_lru.splice(shadow_lru.begin(), shadow_lru, it->second);
+        return;
+    }
+    seen_lines.insert(line_addr);
+    shadow_lru.push_front(line_addr);
+    shadow_lines[line_addr] = shadow_lru.begin();
+    if (shadow_lru.size() > config.nr_lines) {
+        shadow_lines.erase(shadow_lru.back());
+        shadow_lru.pop_back();
+    }
+}
+
+/**
+ * compulsory: line never accessed before, capacity: not in the fully associative LRU cache of
+ * the same size either, conflict: would have been a hit with full associativity
+ * (the shadow tag store is updated by the following access, accessLine)
+ */
+void Cache::classifyMiss(uint32_t addr, uint32_t set) {
+    uint32_t line_addr = addr / config.line_size;
+    StatisticDcma::MissClass miss_class;
+    if (seen_lines.count(line_addr) == 0)
+        miss_class = StatisticDcma::COMPULSORY;
+    else if (shadow_lines.count(line_addr) == 0)
+        miss_class = StatisticDcma::CAPACITY;
+    else
+        miss_class = StatisticDcma::CONFLICT;
+    Statistics::get().getDCMAStat()->countMiss(set, miss_class);
 }
 
 /**
@@ -251,7 +305,24 @@ void Cache::dmaRequestDownloadCacheLine(uint32_t byte_addr, uint32_t initiator_i
     cur_bus_request.is_waiting_for_bus = false;
     cur_bus_request.is_waiting_for_wdata = false;
     cur_bus_request.is_done = false;
+    cur_bus_request.is_prefetch = false;
     cur_bus_request.cache_line_data_ptr = 0;
+    if (Timeline::enabled) {
+        timeline_begin = Timeline::get().now();
+        timeline_initiator = initiator_id;
+    }
+}
+
+bool Cache::dmaRequestPrefetchCacheLine(uint32_t byte_addr, uint32_t initiator_id) {
+    if (isHit(byte_addr)) return false;
+    uint32_t tag, set, word;
+    splitAddr(byte_addr, &tag, &set, &word);
+    int64_t victim = getVictimLine(set);
+    if (victim < 0 || dirty_flags[victim]) return false;
+
+    dmaRequestDownloadCacheLine(byte_addr, initiator_id);
+    cur_bus_request.is_prefetch = true;
+    return true;
 }
 
 /**
@@ -262,6 +333,18 @@ bool Cache::isBusy() {
     return !cur_bus_request.is_done;
 }
 
+bool Cache::isWaitingForBus() const {
+    return cur_bus_request.is_waiting_for_bus && burst_wait_counter == 0;
+}
+
+void Cache::tickWait(uint64_t ticks) {
+    if (ticks == 0) return;
+    for (Bram& bram : brams)
+        bram.set_accessed_this_cycle(false);
+    // flush does not count its bus wait cycles
+    if (!flush_flag) Statistics::get().getDCMAStat()->counters.bus_wait_cycles += ticks;
+}
+
 /**
  * checks if is hit and if bram was not accessed in this cycle
  * @param addr_in byte addr of data
@@ -303,6 +386,7 @@ void Cache::tick() {
                     if (!found_dirty) {
                         cur_bus_request.is_done = true;
                         flush_flag = false;
+                        if (Timeline::enabled) timelineSpan(true);
                     }
                 }
             }
@@ -337,6 +421,7 @@ void Cache::tick() {
                     if (flush_last) {
                         flush_flag = false;
                         cur_bus_request.is_done = true;
+                        if (Timeline::enabled) timelineSpan(true);
                     }
                 }
             } else if (bus->isWriteDataReady(initiator_id)) {
@@ -354,7 +439,17 @@ void Cache::tick() {
             &cur_bus_request.tag,
             &cur_bus_request.set,
             &cur_bus_request.word);
+        if (prefetched_flags[cur_bus_request.cache_line]) {
+            prefetched_flags[cur_bus_request.cache_line] = false;
+            Statistics::get().getDCMAStat()->counters.prefetch_unused++;
+        }
         valid_flags[cur_bus_request.cache_line] = false;
+        if (cur_bus_request.is_prefetch)
+            Statistics::get().getDCMAStat()->counters.prefetch_issued++;
+        else
+            Statistics::get().getDCMAStat()->counters.demand_line_fills++;
+        if (classify_misses && !cur_bus_request.is_prefetch)
+            classifyMiss(cur_bus_request.byte_addr, cur_bus_request.set);
 
         // check if overwritten block is dirty
         if (dirty_flags[cur_bus_request.cache_line]) {
@@ -375,7 +470,9 @@ void Cache::tick() {
                     cur_bus_request.is_done = true;
                     cur_bus_request.is_waiting_for_bus = false;
                     valid_flags[cur_bus_request.cache_line] = true;
+                    prefetched_flags[cur_bus_request.cache_line] = cur_bus_request.is_prefetch;
                     tag_memory[cur_bus_request.cache_line] = cur_bus_request.tag;
+                    if (Timeline::enabled) timelineSpan(false);
                 } else {
                     // upload of dirty cache line finished
                     cur_bus_request.is_waiting_for_wdata = false;
@@ -432,7 +529,10 @@ uint32_t Cache::getReplaceLine(uint32_t addr) {
 
     // if there is an unused block, return that
     for (int i = 0; i < config.associativity; ++i) {
-        if (!valid_flags[set_offset + i]) return set_offset + i;
+        if (!valid_flags[set_offset + i]) {
+            if (replacement_policy == ReplacementPolicy::PLRU) plruTouch(set_offset, i);
+            return set_offset + i;
+        }
     }
 
     // else use replacement policy
@@ -478,10 +578,68 @@ uint32_t Cache::getReplaceLine(uint32_t addr) {
         std::mt19937 gen(rd());  // seed the generator
         std::uniform_int_distribution<> distr(0, config.associativity - 1);  // define the range
         return set_offset + distr(gen);
+    } else if (replacement_policy == ReplacementPolicy::PLRU) {
+        uint32_t plru_line = plruVictim(set_offset);
+        plruTouch(set_offset, plru_line);
+        return set_offset + plru_line;
+    }
+    return -1;
+}
+
+int64_t Cache::getVictimLine(uint32_t set) const {
+    uint32_t set_offset = set * config.associativity;
+    for (uint32_t i = 0; i < config.associativity; ++i) {
+        if (!valid_flags[set_offset + i]) return set_offset + i;
+    }
+
+    // same selection as getReplaceLine
+    if (replacement_policy == ReplacementPolicy::FIFO) {
+        return set_offset + replacement_memory[set];
+    } else if (replacement_policy == ReplacementPolicy::LRU) {
+        uint32_t lru_line = 0;
+        for (uint32_t i = 1; i < config.associativity; ++i) {
+            if (replacement_memory[set_offset + i] > replacement_memory[set_offset + lru_line])
+                lru_line = i;
+        }
+        return set_offset + lru_line;
+    } else if (replacement_policy == ReplacementPolicy::LFU) {
+        uint32_t lfu_line = 0;
+        for (uint32_t i = 1; i < config.associativity; ++i) {
+            if (replacement_memory[set_offset + i] < replacement_memory[set_offset + lfu_line])
+                lfu_line = i;
+        }
+        return set_offset + lfu_line;
+    } else if (replacement_policy == ReplacementPolicy::PLRU) {
+        return set_offset + plruVictim(set_offset);
     }
     return -1;
 }
 
+/**
+ * binary tree over the ways of a set, inner node n (1 .. associativity - 1, children 2n and 2n + 1)
+ * in replacement_memory[set_offset + n]: 0 victim in the lower, 1 in the upper half of its ways.
+ * an access turns the nodes on its path away from the way
+ */
+void Cache::plruTouch(uint32_t set_offset, uint32_t way) {
+    uint32_t node = 1;
+    for (uint32_t half = config.associativity >> 1; half > 0; half >>= 1) {
+        uint32_t upper = (way & half) ? 1 : 0;
+        replacement_memory[set_offset + node] = 1 - upper;
+        node = 2 * node + upper;
+    }
+}
+
+uint32_t Cache::plruVictim(uint32_t set_offset) const {
+    uint32_t node = 1;
+    uint32_t way = 0;
+    for (uint32_t half = config.associativity >> 1; half > 0; half >>= 1) {
+        uint32_t upper = replacement_memory[set_offset + node];
+        if (upper) way |= half;
+        node = 2 * node + upper;
+    }
+    return way;
+}
+
 /**
  * get number of bram from addr
  * @param addr byte addr of data
@@ -508,6 +666,7 @@ uint32_t Cache::getBramAddr(uint32_t addr) {
  */
 void Cache::reset() {
     valid_flags = std::vector<bool>(config.nr_lines, false);
+    prefetched_flags = std::vector<bool>(config.nr_lines, false);
     dirty_flags = std::vector<bool>(config.nr_lines, false);
     tag_memory = std::vector<uint32_t>(config.nr_lines, 0);
 
@@ -521,6 +680,63 @@ void Cache::reset() {
     if (replacement_policy == ReplacementPolicy::LFU) {
         replacement_memory = std::vector<uint32_t>(config.nr_lines, 0);
     }
+    if (replacement_policy == ReplacementPolicy::PLRU) {
+        replacement_memory = std::vector<uint32_t>(config.nr_lines, 0);
+    }
+
+    // misses after a reset are compulsory
+    clearShadowTags();
+}
+
+void Cache::setReplacementPolicy(ReplacementPolicy policy) {
+    replacement_policy = policy;
+    reset();
+}
+
+void Cache::setMissClassification(bool enable) {
+    classify_misses = enable;
+    clearShadowTags();
+}
+
+void Cache::clearShadowTags() {
+    shadow_lru.clear();
+    shadow_lines.clear();
+    seen_lines.clear();
+    shadow_last_line = -1;
+}
+
+void Cache::saveCheckpoint(QDataStream& out) const {
+    Checkpoint::write(out, tag_memory);
+    Checkpoint::write(out, dirty_flags);
+    Checkpoint::write(out, valid_flags);
+    Checkpoint::write(out, prefetched_flags);
+    Checkpoint::write(out, replacement_memory);
+    Checkpoint::write(out, std::vector<uint32_t>(shadow_lru.begin(), shadow_lru.end()));
+    Checkpoint::write(out, std::vector<uint32_t>(seen_lines.begin(), seen_lines.end()));
+    for (const auto& bram : brams) {
+        bram.saveCheckpoint(out);
+    }
+}
+
+void Cache::restoreCheckpoint(QDataStream& in) {
+    Checkpoint::read(in, tag_memory);
+    Checkpoint::read(in, dirty_flags);
+    Checkpoint::read(in, valid_flags);
+    Checkpoint::read(in, prefetched_flags);
+    Checkpoint::read(in, replacement_memory);
+    std::vector<uint32_t> lines;
+    Checkpoint::read(in, lines);
+    shadow_lru.assign(lines.begin(), lines.end());
+    shadow_lines.clear();
+    for (auto it = shadow_lru.begin(); it != shadow_lru.end(); ++it) {
+        shadow_lines[*it] = it;
+    }
+    Checkpoint::read(in, lines);
+    seen_lines = std::unordered_set<uint32_t>(lines.begin(), lines.end());
+    shadow_last_line = -1;
+    for (auto& bram : brams) {
+        bram.restoreCheckpoint(in);
+    }
 }
 
 /**
@@ -531,4 +747,28 @@ void Cache::flush() {
     flush_flag = true;
     flush_last = false;
     cur_bus_request.is_done = false;
+    if (Timeline::enabled) timeline_begin = Timeline::get().now();
+}
+
+/**
+ * timeline span of the finished bus request (miss / prefetch) or flush
+ */
+void Cache::timelineSpan(bool flush) {
+    auto& timeline = Timeline::get();
+    if (flush) {
+        timeline.span(Timeline::DCMA_FLUSH,
+            timeline.systemPid(),
+            Timeline::DCMA_TRACK,
+            0,
+            timeline_begin,
+            timeline.now());
+    } else {
+        timeline.span(cur_bus_request.is_prefetch ? Timeline::DCMA_PREFETCH : Timeline::DCMA_MISS,
+            timeline.systemPid(),
+            Timeline::DCMA_TRACK,
+            timeline_initiator,
+            timeline_begin,
+            timeline.now(),
+            cur_bus_request.byte_addr);
+    }
 }
@@ -26,6 +26,8 @@
 #include <cmath>
 #include <list>
 #include <random>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // ISS libraries
@@ -42,6 +44,14 @@
 
 class Cache {
    public:
+    enum ReplacementPolicy {
+        FIFO,  // First In First Out
+        LRU,   // Least Recently Used
+        LFU,   // Least Frequently Used
+        Random,
+        PLRU  // tree Pseudo LRU (associativity - 1 bits per set)
+    };
+
     Cache(ISS* core,
         uint32_t line_size,
         uint32_t associativity,
@@ -55,6 +65,14 @@ class Cache {
 
     void dmaRequestDownloadCacheLine(uint32_t byte_addr, uint32_t initiator_id);
 
+    /**
+     * starts a line fill ahead of demand (DCMA prefetcher), only possible if cache is not busy.
+     * fills an invalid way or replaces a clean line (no write back for a prefetch)
+     * @param initiator_id cluster whose dma stream predicted the line
+     * @return false if the line is present or the victim is dirty / unknown (Random)
+     */
+    bool dmaRequestPrefetchCacheLine(uint32_t byte_addr, uint32_t initiator_id);
+
     void flush();
 
     void reset();
@@ -67,13 +85,39 @@ class Cache {
 
     void tick();
 
+    /**
+     * bus transfer (line fill / write back / flush) requested, waiting for the bus to deliver
+     * or accept the burst. tick() only polls the bus in this state
+     */
+    bool isWaitingForBus() const;
+
+    /**
+     * equivalent to ticks times tick() while isWaitingForBus() and the bus is not ready
+     */
+    void tickWait(uint64_t ticks);
+
+    /**
+     * simulator checkpoint of an idle cache (not busy): tags, flags, replacement state and data
+     */
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
+    /**
+     * selects the replacement policy (default FIFO), resets the cache (e.g. apps/microbench)
+     */
+    void setReplacementPolicy(ReplacementPolicy policy);
+
+    ReplacementPolicy getReplacementPolicy() const {
+        return replacement_policy;
+    }
+
+    /**
+     * classifies demand line fills as compulsory / capacity / conflict miss (StatisticDcma), using
+     * a shadow fully associative LRU tag store of the same number of lines. no timing effect
+     */
+    void setMissClassification(bool enable);
+
    private:
-    enum ReplacementPolicy {
-        FIFO,  // First In First Out
-        LRU,   // Least Recently Used
-        LFU,   // Least Frequently Used
-        Random
-    };
 
     // constants
     constexpr static int dma_dataword_length_byte = 16 / 8;
@@ -105,6 +149,7 @@ class Cache {
         bool is_waiting_for_bus = false;
         bool is_waiting_for_wdata;
         bool is_done = true;
+        bool is_prefetch = false;
     } cur_bus_request;
 
     // object pointers// object pointers
@@ -117,10 +162,20 @@ class Cache {
     std::vector<uint32_t> tag_memory;
     std::vector<bool> dirty_flags;
     std::vector<bool> valid_flags;
+    // filled by a prefetch and not yet accessed by a dma
+    std::vector<bool> prefetched_flags;
 
     // memory for cache replacement policies
     std::vector<uint32_t> replacement_memory;  // stores information for replacement algorithms
 
+    // miss classification: shadow fully associative LRU tag store (line addresses, most recently
+    // used first) and all line addresses accessed since reset, not in hardware
+    bool classify_misses = false;
+    std::list<uint32_t> shadow_lru;
+    std::unordered_map<uint32_t, std::list<uint32_t>::iterator> shadow_lines;
+    std::unordered_set<uint32_t> seen_lines;
+    int64_t shadow_last_line{-1};  // most recently used, skips the update of sequential accesses
+
     // virtual buffer for cache line, this will not be in hardware
     std::vector<uint8_t> bus_buffer;
     uint32_t
@@ -131,6 +186,11 @@ class Cache {
     bool flush_last = false;
     uint32_t flush_counter;
 
+    // timeline (helper/timeline.h): start and requesting cluster of the current bus request / flush
+    double timeline_begin{0};
+    uint32_t timeline_initiator{0};
+    void timelineSpan(bool flush);
+
     // functions
     void splitAddr(uint32_t addr_in, uint32_t* tag, uint32_t* line, uint32_t* word);
 
@@ -144,6 +204,22 @@ class Cache {
 
     uint32_t getReplaceLine(uint32_t addr);
 
+    // line getReplaceLine would select in the set, without updating the replacement state
+    // (-1: not predictable, Random)
+    int64_t getVictimLine(uint32_t set) const;
+
+    // first dma access of a prefetched line (useful prefetch), shadow tag store update
+    void accessLine(uint32_t line, uint32_t addr);
+
+    // tree PLRU: marks way as recently used / way selected by the tree bits of the set
+    void plruTouch(uint32_t set_offset, uint32_t way);
+    uint32_t plruVictim(uint32_t set_offset) const;
+
+    // classification of the demand line fill of addr (miss in set)
+    void classifyMiss(uint32_t addr, uint32_t set);
+
+    void clearShadowTags();
+
     uint32_t getBramIdx(uint32_t addr);
 
     uint32_t getBramAddr(uint32_t addr);
@@ -20,7 +20,9 @@
 #include <limits>  // std::numeric_limits
 
 #include "../../simulator/ISS.h"
+#include "../../simulator/helper/checkpoint.h"
 #include "../../simulator/helper/debugHelper.h"
+#include "../../simulator/helper/hostProfile.h"
 #include "../../simulator/helper/typeConversion.h"
 #include "Cluster.h"
 #include "stats/Statistics.h"
@@ -39,20 +41,21 @@ Cluster::Cluster(ISS* core,
       vpro_time(0),
       dma_time(0) {
     auto unitsTemp = std::vector<std::shared_ptr<Unit::VectorUnit>>();
-    for (int i = 0; i < VPRO_CFG::UNITS; i++) {
+    const int unit_count = int(core->getHWConfig().units);
+    for (int i = 0; i < unit_count; i++) {
         unitsTemp.push_back(std::make_shared<Unit::VectorUnit>(i,
             cluster_id,
             time,
-            architecture_state));
+            architecture_state,
+            core->getHWConfig()));
     }
 
-    if (VPRO_CFG::UNITS > 1) {
-        unitsTemp[0]->setNeighbors(unitsTemp[VPRO_CFG::UNITS - 1], unitsTemp[1]);
-        for (int i = 1; i < VPRO_CFG::UNITS - 1; i++) {
+    if (unit_count > 1) {
+        unitsTemp[0]->setNeighbors(unitsTemp[unit_count - 1], unitsTemp[1]);
+        for (int i = 1; i < unit_count - 1; i++) {
             unitsTemp[i]->setNeighbors(unitsTemp[i - 1], unitsTemp[i + 1]);
         }
-        unitsTemp[VPRO_CFG::UNITS - 1]->setNeighbors(
-            unitsTemp[VPRO_CFG::UNITS - 2], unitsTemp[0]);
+        unitsTemp[unit_count - 1]->setNeighbors(unitsTemp[unit_count - 2], unitsTemp[0]);
     } else {
         unitsTemp[0]->setNeighbors(unitsTemp[0], unitsTemp[0]);
     }
@@ -81,7 +84,7 @@ bool Cluster::isBusy() {
 /**
  * Clock tick
  */
-void Cluster::tick() {
+bool Cluster::tickDMA() {
     // cascade to DMAs
     if (dma_time <= time) {
         if (debug & DEBUG_TICK)
@@ -90,11 +93,14 @@ void Cluster::tick() {
                 dma_time,
                 cluster_id);
         dma_time += core->getDMAClockPeriod();
+        HostTimer timer(HostProfile::DMA_TICK);
         dma->tick();
-        if (cluster_id == VPRO_CFG::CLUSTERS - 1)
-            Statistics::get().tick(Statistics::clock_domains::DMA);
+        return true;
     }
+    return false;
+}
 
+bool Cluster::tickVPRO() {
     // check if time for clock tick is up
     if (vpro_time <= time) {
         if (debug & DEBUG_TICK)
@@ -103,16 +109,111 @@ void Cluster::tick() {
                 vpro_time,
                 cluster_id);
         vpro_time += core->getVPROClockPeriod();
+        HostTimer timer(HostProfile::CLUSTER_VPRO);
         // cascade tick to units -> lanes
+        if (core->isFunctionalVPRO()) {
+            // repeat while any unit progresses (ls lanes may chain across units)
+            bool progress = true;
+            while (progress) {
+                progress = false;
+                for (auto unit : units) {
+                    progress |= unit->tickFunctional();
+                }
+            }
+            return true;
+        }
 
-        for (auto unit : units) {
-            unit->tick();
+        {
+            HostTimer unit_timer(HostProfile::UNIT_TICK);
+            for (auto unit : units) {
+                unit->tick();
+            }
         }
-        for (auto unit : units) {
-            unit->update();
+        {
+            HostTimer unit_timer(HostProfile::UNIT_UPDATE);
+            for (auto unit : units) {
+                unit->update();
+            }
         }
-        if (cluster_id == VPRO_CFG::CLUSTERS - 1)
-            Statistics::get().tick(Statistics::clock_domains::VPRO);
+        return true;
+    }
+    return false;
+}
+
+void Cluster::startWorker(SpinBarrier* barrier) {
+    worker_barrier = barrier;
+    start();
+}
+
+void Cluster::run() {
+    while (true) {
+        worker_barrier->wait();  // tick start
+        if (worker_stop.load(std::memory_order_relaxed)) return;
+        tickVPRO();
+        worker_barrier->wait();  // tick done
+    }
+}
+
+bool Cluster::isIdle() {
+    if (dma->isBusy()) return false;
+    for (auto unit : units) {
+        if (!unit->isIdle()) return false;
+    }
+    return true;
+}
+
+void Cluster::tickIdle() {
+    if (dma_time <= time) {
+        dma_time += core->getDMAClockPeriod();
+        idle_dma_ticks++;
+    }
+    if (vpro_time <= time) {
+        vpro_time += core->getVPROClockPeriod();
+        idle_vpro_ticks++;
+    }
+}
+
+bool Cluster::isWaiting() {
+    if (dma->isBusy() && !dma->isStalled()) return false;
+    for (auto unit : units) {
+        if (!unit->isIdle()) return false;
+    }
+    return true;
+}
+
+void Cluster::tickWait() {
+    if (dma_time <= time && dma->isBusy()) dma->tickStalled();
+    tickIdle();
+}
+
+void Cluster::applyIdleTicks() {
+    // idle (or stalled) dma tick does not change any state
+    for (auto unit : units) {
+        unit->tickIdle(idle_vpro_ticks);
+    }
+    if (cluster_id == int(core->getHWConfig().clusters) - 1) {
+        Statistics::get().tickIdle(Statistics::clock_domains::DMA, idle_dma_ticks);
+        Statistics::get().tickIdle(Statistics::clock_domains::VPRO, idle_vpro_ticks);
+    }
+    idle_dma_ticks = 0;
+    idle_vpro_ticks = 0;
+}
+
+void Cluster::saveCheckpoint(QDataStream& out) const {
+    Checkpoint::write(out, vpro_time);
+    Checkpoint::write(out, dma_time);
+    dma->saveCheckpoint(out);
+    for (auto unit : units) {
+        unit->saveCheckpoint(out);
+    }
+}
+
+void Cluster::restoreCheckpoint(QDataStream& in) {
+    Checkpoint::read(in, vpro_time);
+    Checkpoint::read(in, dma_time);
+    dma->restoreCheckpoint(in);
+    for (auto unit : units) {
+        unit->restoreCheckpoint(in);
     }
 }
 
@@ -170,7 +271,7 @@ bool Cluster::sendCMD(std::shared_ptr<CommandBase> cmd) {
             //*********************************************
             uint32_t unit_mask = 1u << unit->id();
             if (unit_mask & architecture_state->unit_mask_global) {
-                if (!unit->trySendCMD(std::make_shared<CommandVPRO>(vprocmd.get()))) {
+                if (!unit->trySendCMD(vprocmd)) {  // copied into the units queue
                     ret |= unit_mask;
                 }
             }
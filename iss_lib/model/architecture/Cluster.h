@@ -25,10 +25,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 #include <list>
 #include <vector>
 
-#include <QMutex>
 #include <QThread>
 
 #include <vpro/vpro_special_register_enums.h>
@@ -36,6 +36,7 @@
 #include "DCMA.h"
 #include "DMA.h"
 #include "unit/VectorUnit.h"
+#include "../../simulator/helper/spinBarrier.h"
 
 class ISS;
 
@@ -48,28 +49,68 @@ class Cluster : public QThread {
     DMA* dma;
     ISS* core;
 
-#ifdef THREAD_CLUSTER
-    QMutex tick_en;
-    QMutex tick_done;
-#endif
-
     Cluster(ISS* core,
         int id,
         std::shared_ptr<ArchitectureState> architecture_state,
         DCMA* dcma,
         double& time);
 
-#ifdef THREAD_CLUSTER
-    [[noreturn]] void run() override {
-        while (true) {
-            tick_en.lock();
-            tick();
-            tick_done.unlock();
-        }
+    /**
+     * worker thread (sim_init argument --cluster-threads): ticks the units in lockstep with the
+     * main thread (barrier before and after tickVPRO() in each ISS clock tick)
+     */
+    void startWorker(SpinBarrier* barrier);
+
+    /**
+     * lets the worker thread return at the next tick start. the caller releases the tick start
+     * barrier once more and waits for the thread to finish
+     */
+    void stopWorker() {
+        worker_stop.store(true, std::memory_order_relaxed);
     }
-#endif
 
-    void tick();
+    void run() override;
+
+    /**
+     * DMA clock domain part of the clock tick
+     * @return whether the DMA clock ticked
+     */
+    bool tickDMA();
+
+    /**
+     * VPRO clock domain part of the clock tick (tick + update of all units)
+     * @return whether the VPRO clock ticked
+     */
+    bool tickVPRO();
+
+    /**
+     * DMA and all units idle. no state change until a new command is received
+     */
+    bool isIdle();
+
+    /**
+     * clock tick while isIdle(). Only advances the time of the clock domains,
+     * the skipped ticks are accounted in bulk by applyIdleTicks()
+     */
+    void tickIdle();
+
+    /**
+     * all units idle, DMA idle or stalled on a cache miss (DMA::isStalled)
+     */
+    bool isWaiting();
+
+    /**
+     * clock tick while isWaiting(), as tickIdle() (a busy DMA marks its stall)
+     */
+    void tickWait();
+
+    void applyIdleTicks();
+
+    /**
+     * simulator checkpoint of an idle cluster (isIdle): clock domain times, dma and units
+     */
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
 
 #ifndef ISS_STANDALONE
     // FK: Callback for accessing core methods
@@ -121,9 +162,15 @@ class Cluster : public QThread {
     double& time;  // sim time
     // time of vpro (required to determine clock tick occurence)
     double vpro_time, dma_time;
+    // skipped clock ticks (tickIdle) not yet accounted
+    uint64_t idle_vpro_ticks{0}, idle_dma_ticks{0};
 
     // all the VectorUnits in this cluster are stored here
     std::vector<std::shared_ptr<Unit::IVectorUnit>> units;
+
+    SpinBarrier* worker_barrier{nullptr};
+    // set before the final tick start release (ordered by the barrier)
+    std::atomic<bool> worker_stop{false};
 };
 
 #endif  //VPRO_CPP_CLUSTER_H
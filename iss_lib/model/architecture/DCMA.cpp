@@ -13,6 +13,9 @@
 //
 
 #include "DCMA.h"
+#include <algorithm>
+#include <cstdlib>
+#include "../../simulator/helper/checkpoint.h"
 
 DCMA::DCMA(ISS* core,
     NonBlockingBusSlaveInterface* bus,
@@ -20,10 +23,15 @@ DCMA::DCMA(ISS* core,
     uint32_t line_size,
     uint32_t associativity,
     uint32_t nr_brams,
-    uint32_t bram_size)
+    uint32_t bram_size,
+    uint32_t prefetch_degree,
+    Cache::ReplacementPolicy replacement_policy,
+    bool miss_classification)
     : core(core),
       cache(core, line_size, associativity, nr_brams, bram_size, bus),
-      dcma_dma_mode(bus, number_cluster) {
+      dcma_dma_mode(bus, number_cluster),
+      prefetch_degree(prefetch_degree),
+      prefetchers(number_cluster) {
     this->bus = bus;
     this->dmaRequests = std::vector<Request>(number_cluster);
     this->number_cluster = number_cluster;
@@ -33,6 +41,8 @@ DCMA::DCMA(ISS* core,
     this->params.bram_size = bram_size;
     this->params.line_size = line_size;
     this->params.associativity = associativity;
+    cache.setReplacementPolicy(replacement_policy);
+    cache.setMissClassification(miss_classification);
 }
 
 /**
@@ -54,6 +64,7 @@ void DCMA::requestDmaReadTransfer(
     cur_request.latency_wait_counter = 6 * dcma_dataword_length_byte / dma_dataword_length_byte;
 
     dmaRequests[initiator_id] = cur_request;
+    if (prefetch_degree > 0) trainPrefetcher(initiator_id, byte_addr, burst_length);
 }
 
 /**
@@ -75,6 +86,7 @@ void DCMA::requestDmaWriteTransfer(
     cur_request.latency_wait_counter = 9 * dcma_dataword_length_byte / dma_dataword_length_byte;
 
     dmaRequests[initiator_id] = cur_request;
+    if (prefetch_degree > 0) trainPrefetcher(initiator_id, byte_addr, burst_length);
 }
 
 /**
@@ -315,16 +327,132 @@ void DCMA::tick() {
 
         pointer_nxt_dma_miss++;
         if (pointer_nxt_dma_miss >= number_cluster) pointer_nxt_dma_miss = 0;
+
+        if (prefetch_degree > 0 && !cache.isBusy()) issuePrefetch();
     }
 
     cache.tick();
 }
 
+void DCMA::trainPrefetcher(uint32_t initiator_id, intptr_t byte_addr, uint32_t burst_length) {
+    auto& prefetcher = prefetchers[initiator_id];
+    const intptr_t line_size = params.line_size;
+    const intptr_t bytes = intptr_t(burst_length) * dma_dataword_length_byte;
+    auto line = [line_size](intptr_t addr) { return addr - addr % line_size; };
+
+    if (prefetcher.last_addr >= 0) {
+        intptr_t delta = byte_addr - prefetcher.last_addr;
+        if (delta != 0 && delta == prefetcher.stride) {
+            prefetcher.confidence = std::min(prefetcher.confidence + 1, 3u);
+        } else {
+            prefetcher.stride = delta;
+            prefetcher.confidence = 0;
+        }
+    }
+    prefetcher.last_addr = byte_addr;
+
+    auto& candidates = prefetcher.candidates;
+    candidates.clear();
+    auto add = [&](intptr_t addr) {
+        if (addr < 0 || candidates.size() >= prefetch_degree) return;
+#ifdef ISS_STANDALONE
+        if (uint64_t(addr) >= reinterpret_cast<NonBlockingMainMemory*>(bus)->getMemByteSize())
+            return;
+#endif
+        if (addr == line(byte_addr) ||
+            std::find(candidates.begin(), candidates.end(), addr) != candidates.end())
+            return;
+        candidates.push_back(addr);
+    };
+
+    // lines of this request (the first one is demanded now)
+    for (intptr_t addr = line(byte_addr) + line_size; addr < byte_addr + bytes; addr += line_size) {
+        add(addr);
+    }
+    if (prefetcher.confidence == 0) return;
+
+    const intptr_t stride = prefetcher.stride;
+    for (uint32_t k = 1; k <= prefetch_degree && candidates.size() < prefetch_degree; k++) {
+        if (std::abs(stride) < line_size) {
+            // stream: lines following the current request
+            intptr_t last = stride > 0 ? line(byte_addr + bytes - 1) : line(byte_addr);
+            add(last + (stride > 0 ? 1 : -1) * intptr_t(k) * line_size);
+        } else {
+            // lines of the k-th next request
+            intptr_t begin = byte_addr + intptr_t(k) * stride;
+            for (intptr_t addr = line(begin); addr < begin + bytes; addr += line_size) {
+                add(addr);
+            }
+        }
+    }
+}
+
+void DCMA::issuePrefetch() {
+    // demand misses first
+    for (auto& req : dmaRequests) {
+        if (!req.is_done &&
+            !cache.isHit(req.byte_addr + req.current_burst_iter * dma_dataword_length_byte))
+            return;
+    }
+    for (uint32_t i = 0; i < number_cluster; i++) {
+        uint32_t cluster = (pointer_nxt_prefetch + i) % number_cluster;
+        auto& candidates = prefetchers[cluster].candidates;
+        while (!candidates.empty()) {
+            intptr_t addr = candidates.front();
+            candidates.erase(candidates.begin());
+            if (cache.dmaRequestPrefetchCacheLine(addr, cluster)) {
+                pointer_nxt_prefetch = (cluster + 1) % number_cluster;
+                return;
+            }
+        }
+    }
+}
+
+bool DCMA::isIdle() {
+    if (dcma_mode == DMA) return false;
+    if (cache.isBusy()) return false;
+    for (auto& req : dmaRequests) {
+        if (!req.is_done) return false;
+    }
+    for (auto& prefetcher : prefetchers) {
+        if (!prefetcher.candidates.empty()) return false;
+    }
+    return true;
+}
+
+void DCMA::tickIdle(uint64_t ticks) {
+    if (ticks == 0) return;
+    tick();
+    // idle tick only moves the round robin pointer
+    pointer_nxt_dma_miss = (pointer_nxt_dma_miss + (ticks - 1)) % number_cluster;
+}
+
+bool DCMA::isWaitingForMemory() {
+    return dcma_mode == REALISTIC && cache.isWaitingForBus();
+}
+
+bool DCMA::isStalled(uint32_t initiator_id) {
+    if (dcma_mode != REALISTIC) return false;
+    const Request& req = dmaRequests[initiator_id];
+    if (req.is_done || req.latency_wait_counter > 0 || req.is_new_access) return false;
+#ifdef ISS_STANDALONE
+    if (req.byte_addr >= reinterpret_cast<NonBlockingMainMemory*>(bus)->getMemByteSize())
+        return false;
+#endif
+    return !cache.isHit(req.byte_addr + dma_dataword_length_byte * req.current_burst_iter);
+}
+
+void DCMA::tickWait(uint64_t ticks) {
+    // cache busy: no miss request, no prefetch, round robin pointer unchanged
+    cache.tickWait(ticks);
+}
+
 /**
  * resets cache by reseting all valid flags to false
  */
 void DCMA::reset() {
     cache.reset();
+    prefetchers = std::vector<Prefetcher>(number_cluster);
 
     Statistics::get().getDCMAStat()->reset();
 }
@@ -336,6 +464,29 @@ void DCMA::flush() {
     cache.flush();
 }
 
+void DCMA::saveCheckpoint(QDataStream& out) const {
+    cache.saveCheckpoint(out);
+    Checkpoint::write(out, pointer_nxt_dma_miss);
+    Checkpoint::write(out, pointer_nxt_prefetch);
+    for (const auto& prefetcher : prefetchers) {
+        Checkpoint::write(out, prefetcher.last_addr);
+        Checkpoint::write(out, prefetcher.stride);
+        Checkpoint::write(out, prefetcher.confidence);
+    }
+}
+
+void DCMA::restoreCheckpoint(QDataStream& in) {
+    cache.restoreCheckpoint(in);
+    Checkpoint::read(in, pointer_nxt_dma_miss);
+    Checkpoint::read(in, pointer_nxt_prefetch);
+    for (auto& prefetcher : prefetchers) {
+        Checkpoint::read(in, prefetcher.last_addr);
+        Checkpoint::read(in, prefetcher.stride);
+        Checkpoint::read(in, prefetcher.confidence);
+        prefetcher.candidates.clear();
+    }
+}
+
 /**
  * checks if DCMA is busy
  */
@@ -46,10 +46,39 @@ class DCMA {
         uint32_t line_size,
         uint32_t associativity,
         uint32_t nr_brams,
-        uint32_t bram_size);
+        uint32_t bram_size,
+        uint32_t prefetch_degree = 0,
+        Cache::ReplacementPolicy replacement_policy = Cache::FIFO,
+        bool miss_classification = false);
 
     void tick();
 
+    /**
+     * no outstanding dma request, cache not busy (no download/flush) and no prefetch candidate
+     */
+    bool isIdle();
+
+    /**
+     * equivalent to ticks times tick() while isIdle()
+     */
+    void tickIdle(uint64_t ticks);
+
+    /**
+     * cache waits for the main memory (line fill / write back), tick() only polls the bus
+     */
+    bool isWaitingForMemory();
+
+    /**
+     * dma request of the cluster waits for a line which is not in the cache, each poll of the
+     * dma (isReadDataAvailable / isWriteDataReady) is a miss until the line fill completes
+     */
+    bool isStalled(uint32_t initiator_id);
+
+    /**
+     * equivalent to ticks times tick() while isWaitingForMemory() and the bus is not ready
+     */
+    void tickWait(uint64_t ticks);
+
     // DMA
     void requestDmaReadTransfer(intptr_t byte_addr,
         uint32_t burst_length,
@@ -75,6 +104,12 @@ class DCMA {
 
     bool isBusy();
 
+    /**
+     * simulator checkpoint of an idle DCMA (isIdle): cache content, prefetcher training
+     */
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
     bool getDCMAOff();
 
     uint32_t getNrRams();
@@ -126,6 +161,27 @@ class DCMA {
 
     // DMA
     std::vector<Request> dmaRequests;
+
+    /**
+     * stride / stream prefetcher of a cluster, trained on its dma requests (start address).
+     * a stride seen twice predicts the next requests: strides below a line continue the stream
+     * line by line, larger strides give the lines of the next requests. candidates are the
+     * remaining lines of the current request first, at most prefetch_degree lines
+     */
+    struct Prefetcher {
+        intptr_t last_addr{-1};
+        intptr_t stride{0};
+        uint32_t confidence{0};
+        std::vector<intptr_t> candidates;  // line aligned byte addresses, next first
+    };
+    uint32_t prefetch_degree;  // 0: off
+    std::vector<Prefetcher> prefetchers;
+    uint32_t pointer_nxt_prefetch = 0;
+
+    void trainPrefetcher(uint32_t initiator_id, intptr_t byte_addr, uint32_t burst_length);
+
+    // line fill of the next candidate (cache not busy, no dma waits for a miss)
+    void issuePrefetch();
 };
 
 #endif  //TEMPLATE_DCMA_H
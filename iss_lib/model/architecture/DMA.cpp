@@ -14,7 +14,9 @@
 
 #include "DMA.h"
 #include "../../simulator/ISS.h"
+#include "../../simulator/helper/checkpoint.h"
 #include "../../simulator/helper/debugHelper.h"
+#include "../../simulator/helper/timeline.h"
 #include "Cluster.h"
 #include "unit/VectorUnit.h"
 
@@ -59,6 +61,16 @@ std::shared_ptr<CommandDMA> DMA::getCmd() {
     return command;
 }
 
+void DMA::saveCheckpoint(QDataStream& out) const {
+    Checkpoint::write(out, id_counter);
+    Checkpoint::write(out, ext_addr_base_lst);
+}
+
+void DMA::restoreCheckpoint(QDataStream& in) {
+    Checkpoint::read(in, id_counter);
+    Checkpoint::read(in, ext_addr_base_lst);
+}
+
 bool DMA::isBusy() {
     return !command->is_done() || !cmd_queue.empty() || dcma->isBusy(DMA::cluster->cluster_id);
 }
@@ -168,6 +180,10 @@ void DMA::tick() {
         command->done = false;
 
         Statistics::get().getDMAStat()->addExecutedCommand(command.get(), cluster->cluster_id);
+        if (Timeline::enabled) {
+            timeline_begin = Timeline::get().now();
+            timeline_pending = true;
+        }
 
         cur_iteration.x = 0;
         cur_iteration.y = 0;
@@ -351,6 +367,33 @@ void DMA::tick() {
             }
         }
     }
+
+    if (timeline_pending && command->is_done()) {
+        timeline_pending = false;
+        auto& timeline = Timeline::get();
+        if (Timeline::enabled) {
+            timeline.span(Timeline::DMA,
+                uint16_t(cluster->cluster_id),
+                timeline.dmaTrack(),
+                command->type,
+                timeline_begin,
+                timeline.now(),
+                command->ext_base);
+        }
+    }
+}
+
+bool DMA::isStalled() {
+    return !command->is_done() && cur_iteration.remaining_req_elements > 0 &&
+           dcma->isStalled(cluster->cluster_id);
+}
+
+void DMA::tickStalled() {
+    auto& cycle_counters = Statistics::get().getDCMAStat()->cycle_counters;
+    if (is_read_transfer(*command))
+        cycle_counters.did_dma_read_miss[cluster->cluster_id] = 1;
+    else
+        cycle_counters.did_dma_write_miss[cluster->cluster_id] = 1;
 }
 
 bool DMA::is_read_transfer(const CommandDMA& dma_command) const {
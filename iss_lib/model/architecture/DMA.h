@@ -68,8 +68,23 @@ class DMA {
      */
     void tick();
 
+    /**
+     * transfer ongoing, but the DCMA request misses the cache (DCMA::isStalled): tick() only
+     * polls the DCMA
+     */
+    bool isStalled();
+
+    /**
+     * equivalent to tick() while isStalled(), marks the miss of this cycle in the statistics
+     */
+    void tickStalled();
+
     std::shared_ptr<CommandDMA> getCmd();
 
+    // simulator checkpoint of an idle dma (no command in queue / execution)
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
     void setExternalVariableInfo(QMap<uint64_t, QMap<int, QString>>* map) {
         this->map = map;
     };
@@ -141,6 +156,10 @@ class DMA {
     std::ofstream trace;
     std::ofstream cmd_trace;
 
+    // timeline (helper/timeline.h): start of the current command
+    double timeline_begin{0};
+    bool timeline_pending{false};
+
     int id_counter = 0;
 
     void createWriteRequest(uint32_t y_iteration);
@@ -40,6 +40,15 @@ class DMABlockExtractor {
         return busy;
     };
 
+    // remaining DMA commands / address of the next one (command trace)
+    [[nodiscard]] uint32_t getSize() const {
+        return size_ff;
+    };
+
+    [[nodiscard]] uint64_t getAddr() const {
+        return addr_ff;
+    };
+
     void tick();
 
    private:
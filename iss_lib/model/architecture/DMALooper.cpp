@@ -184,7 +184,7 @@ std::shared_ptr<CommandDMA> DMALooper::bif_to_dma(COMMAND_DMA::COMMAND_DMA* dma)
     }
 
     assert(dma->unit_mask != 0);
-    for (size_t i = 0; i < VPRO_CFG::UNITS; i++) {
+    for (size_t i = 0; i < core->getHWConfig().units; i++) {
         if ((dma->unit_mask >> i) & 0x1) {
             cmdp->unit.append(i);
         }
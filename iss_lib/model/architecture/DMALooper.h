@@ -39,6 +39,13 @@ class DMALooper {
         return busy;
     };
 
+    /**
+     * not looping and no pending input. tick() has no effect
+     */
+    [[nodiscard]] bool isIdle() const {
+        return state != LOOPING && !input_register.is_filled;
+    };
+
     void new_dcache_input(const uint8_t dcache_data_struct[32]);
 
     void tick();
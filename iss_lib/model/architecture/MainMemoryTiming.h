@@ -0,0 +1,57 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file MainMemoryTiming.h
+ *
+ * Timing parameters of the main memory (NonBlockingMainMemory), in AXI clock cycles.
+ * Runtime hardware parameters (hwConfig.h: --mm_dram=1 --dram_banks=8 ...).
+ *
+ * dram == false: fixed latency per transfer (read_latency / write_latency), no bandwidth limit
+ * dram == true: DRAM controller model
+ *  - address mapping row | bank | column (row_size bytes per row and bank)
+ *  - open page policy: row hit read_latency (write_latency), row miss + t_rcd,
+ *    row conflict + t_rp + t_rcd
+ *  - refresh every t_refi cycles closes all rows, banks busy for t_rfc cycles (t_refi 0: none)
+ *  - up to queue_depth requests (arrival order) visible to the FR-FCFS scheduler, one request
+ *    issued per cycle: oldest row hit on a ready bank first, else the oldest on a ready bank
+ *  - shared data bus: bytes_per_cycle (peak bandwidth), burst data is transferred in order
+ */
+
+#ifndef MAIN_MEMORY_TIMING_H
+#define MAIN_MEMORY_TIMING_H
+
+#include <cstdint>
+
+struct MainMemoryTiming {
+    bool dram{false};
+
+    uint32_t read_latency{36};  // dram: row hit
+    uint32_t write_latency{6};  // dram: row hit
+
+    uint32_t banks{8};
+    uint32_t row_size{2048};  // in bytes (per bank)
+    uint32_t t_rcd{3};        // activate
+    uint32_t t_rp{3};         // precharge
+    uint32_t t_refi{1560};    // 7.8 us at 200 MHz
+    uint32_t t_rfc{70};       // 350 ns at 200 MHz
+    uint32_t queue_depth{16};
+    uint32_t bytes_per_cycle{64};  // one 512 bit AXI word per cycle
+
+    bool operator==(const MainMemoryTiming& ref) const {
+        return dram == ref.dram && read_latency == ref.read_latency &&
+               write_latency == ref.write_latency && banks == ref.banks &&
+               row_size == ref.row_size && t_rcd == ref.t_rcd && t_rp == ref.t_rp &&
+               t_refi == ref.t_refi && t_rfc == ref.t_rfc && queue_depth == ref.queue_depth &&
+               bytes_per_cycle == ref.bytes_per_cycle;
+    }
+};
+
+#endif  // MAIN_MEMORY_TIMING_H
@@ -42,6 +42,31 @@ class NonBlockingBusSlaveInterface {
     virtual void dbgWrite(intptr_t dst_addr, uint8_t* data_ptr) = 0;
 
     virtual void dbgRead(intptr_t dst_addr, uint8_t* data_ptr) = 0;
+
+    /**
+     * debug write / read of a contiguous block (e.g., load / dump of files)
+     * default: byte wise dbgWrite / dbgRead
+     */
+    virtual void dbgWriteBlock(intptr_t dst_addr, const uint8_t* data_ptr, uint64_t size) {
+        for (uint64_t i = 0; i < size; i++) {
+            dbgWrite(dst_addr + intptr_t(i), const_cast<uint8_t*>(&data_ptr[i]));
+        }
+    }
+
+    virtual void dbgReadBlock(intptr_t dst_addr, uint8_t* data_ptr, uint64_t size) {
+        for (uint64_t i = 0; i < size; i++) {
+            dbgRead(dst_addr + intptr_t(i), &data_ptr[i]);
+        }
+    }
+
+    /**
+     * host pointer into the backing store for [addr, addr + size), no copy (e.g., read only data
+     * interpreted in place by the host). valid as long as the slave exists
+     * default: nullptr (not host backed)
+     */
+    virtual uint8_t* dbgHostPtr(intptr_t addr, uint64_t size) {
+        return nullptr;
+    }
 };
 
 #endif  //TEMPLATE_NONBLOCKINGBUSSLAVEINTERFACE_H
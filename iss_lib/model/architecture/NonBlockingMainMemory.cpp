@@ -14,10 +14,18 @@
 
 #include "NonBlockingMainMemory.h"
 #include <errno.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
 #include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+#include "../../simulator/helper/checkpoint.h"
 #include "../../simulator/helper/debugHelper.h"
 
-NonBlockingMainMemory::NonBlockingMainMemory(uint64_t memory_byte_size) {
+NonBlockingMainMemory::NonBlockingMainMemory(
+    uint64_t memory_byte_size, const MainMemoryTiming& timing)
+    : timing(timing) {
     printf("# [NonBlockingMainMemory] Allocating memory... (Size: %lu Bytes)\n", memory_byte_size);
     this->memory = (uint8_t*)(mmap(
         NULL, memory_byte_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
@@ -27,6 +35,24 @@ NonBlockingMainMemory::NonBlockingMainMemory(uint64_t memory_byte_size) {
         perror("NonBlockingMainMemory");
     }
     this->memory_byte_size = memory_byte_size;
+    dirty_pages.resize((memory_byte_size + checkpoint_page_size - 1) / checkpoint_page_size);
+
+    if (timing.dram) {
+        printf("# [NonBlockingMainMemory] DRAM model: %u banks, %u B rows, latency (hit) read %u, "
+               "write %u, tRCD %u, tRP %u, tREFI %u, tRFC %u, queue %u, %u B / cycle\n",
+            timing.banks,
+            timing.row_size,
+            timing.read_latency,
+            timing.write_latency,
+            timing.t_rcd,
+            timing.t_rp,
+            timing.t_refi,
+            timing.t_rfc,
+            timing.queue_depth,
+            timing.bytes_per_cycle);
+        banks.resize(timing.banks);
+        next_refresh_cycle = timing.t_refi;
+    }
 
     if (gen_mem_trace) {
         std::stringstream ss;
@@ -36,33 +62,177 @@ NonBlockingMainMemory::NonBlockingMainMemory(uint64_t memory_byte_size) {
 }
 
 void NonBlockingMainMemory::tick() {
-    for (auto& kr : incomingReadTransfers) {
-        if (kr.second.cycle_counter == cycles_read_latency) kr.second.is_done = true;
-        kr.second.cycle_counter++;
+    if (timing.dram) tickDRAM();
+    completeActive(tick_counter + 1);
+    tick_counter++;
+}
+
+void NonBlockingMainMemory::tick(uint64_t ticks) {
+    if (timing.dram) {
+        // scheduling decisions each cycle
+        if (!queued.empty() || !active.empty()) {
+            for (uint64_t t = 0; t < ticks; t++) {
+                tick();
+            }
+            return;
+        }
+        while (timing.t_refi > 0 && next_refresh_cycle < tick_counter + ticks) {
+            refresh(next_refresh_cycle);
+        }
     }
+    completeActive(tick_counter + ticks);
+    tick_counter += ticks;
+}
 
-    for (auto& kr : incomingWriteTransfers) {
-        if (kr.second.cycle_counter == cycles_write_latency) kr.second.is_done = true;
-        kr.second.cycle_counter++;
+uint64_t NonBlockingMainMemory::ticksUntilCompletion() const {
+    uint64_t ticks = UINT64_MAX;
+    for (const auto& ref : active) {
+        const auto& request = (ref.is_write ? writeSlots : readSlots)[ref.initiator_id];
+        ticks = std::min(ticks, request.ready_cycle - tick_counter);
     }
+    // DRAM: a queued request is issued at the earliest in this cycle
+    if (!queued.empty())
+        ticks = std::min<uint64_t>(ticks, std::min(timing.read_latency, timing.write_latency));
+    return ticks;
+}
 
-    tick_counter++;
+void NonBlockingMainMemory::completeActive(uint64_t end_cycle) {
+    for (size_t i = 0; i < active.size();) {
+        auto& request = slot(active[i].is_write, active[i].initiator_id);
+        if (request.ready_cycle < end_cycle) {
+            request.state = Request::DONE;
+            dram_stats.latency_cycles += request.ready_cycle - request.request_cycle;
+            active[i] = active.back();
+            active.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+void NonBlockingMainMemory::refresh(uint64_t cycle) {
+    for (auto& bank : banks) {
+        bank.open_row = -1;
+        bank.ready_cycle = std::max(bank.ready_cycle, cycle + timing.t_rfc);
+    }
+    next_refresh_cycle = cycle + timing.t_refi;
+    dram_stats.refreshes++;
+}
+
+void NonBlockingMainMemory::tickDRAM() {
+    const uint64_t now = tick_counter;
+    while (timing.t_refi > 0 && next_refresh_cycle <= now) {
+        refresh(next_refresh_cycle);
+    }
+    if (queued.empty()) return;
+    if (queued.size() > timing.queue_depth) dram_stats.queue_full_cycles++;
+
+    // FR-FCFS on the oldest queue_depth requests: first ready row hit, else first ready
+    const uint64_t row_stride = uint64_t(timing.row_size) * timing.banks;
+    size_t window = std::min<size_t>(queued.size(), timing.queue_depth);
+    size_t selected = window;
+    for (size_t i = 0; i < window; i++) {
+        const auto& request = slot(queued[i].is_write, queued[i].initiator_id);
+        const auto& bank = banks[(uint64_t(request.byte_addr) / timing.row_size) % timing.banks];
+        if (bank.ready_cycle > now) continue;
+        if (bank.open_row == int64_t(uint64_t(request.byte_addr) / row_stride)) {
+            selected = i;
+            break;
+        }
+        if (selected == window) selected = i;
+    }
+    if (selected == window) return;
+
+    SlotRef ref = queued[selected];
+    queued.erase(queued.begin() + selected);
+    auto& request = slot(ref.is_write, ref.initiator_id);
+    auto& bank = banks[(uint64_t(request.byte_addr) / timing.row_size) % timing.banks];
+    auto row = int64_t(uint64_t(request.byte_addr) / row_stride);
+
+    uint32_t row_cycles = 0;
+    if (bank.open_row == row) {
+        dram_stats.row_hits++;
+    } else if (bank.open_row < 0) {
+        row_cycles = timing.t_rcd;
+        dram_stats.row_misses++;
+    } else {
+        row_cycles = timing.t_rp + timing.t_rcd;
+        dram_stats.row_conflicts++;
+    }
+    uint32_t latency = ref.is_write ? timing.write_latency : timing.read_latency;
+    uint64_t transfer_cycles =
+        (uint64_t(request.burst_length) * dataword_length_byte + timing.bytes_per_cycle - 1) /
+        timing.bytes_per_cycle;
+
+    // burst data in order on the shared data bus
+    uint64_t data_begin = std::max(now + row_cycles + latency, data_bus_ready_cycle);
+    data_bus_ready_cycle = data_begin + transfer_cycles;
+    bank.open_row = row;
+    // bank busy until its burst left the (possibly occupied) data bus
+    bank.ready_cycle = data_begin + transfer_cycles;
+
+    request.ready_cycle = data_bus_ready_cycle;
+    request.state = Request::ACTIVE;
+    active.push_back(ref);
+}
+
+NonBlockingMainMemory::Request& NonBlockingMainMemory::startRequest(
+    bool is_write, uint32_t initiator_id) {
+    auto& request = slot(is_write, initiator_id);
+    if (!request.isDone()) {
+        auto same = [&](const SlotRef& ref) {
+            return ref.is_write == is_write && ref.initiator_id == initiator_id;
+        };
+        queued.erase(std::remove_if(queued.begin(), queued.end(), same), queued.end());
+        active.erase(std::remove_if(active.begin(), active.end(), same), active.end());
+    }
+    request = Request();
+    request.request_cycle = tick_counter;
+    if (Timeline::enabled) request.timeline_begin = Timeline::get().now();
+    if (timing.dram) {
+        request.state = Request::QUEUED;
+        queued.push_back({is_write, initiator_id});
+    } else {
+        request.state = Request::ACTIVE;
+        request.ready_cycle =
+            tick_counter + (is_write ? timing.write_latency : timing.read_latency);
+        active.push_back({is_write, initiator_id});
+    }
+    (is_write ? dram_stats.writes : dram_stats.reads)++;
+    return request;
 }
 
 bool NonBlockingMainMemory::isReadDataAvailable(uint32_t initiator_id) {
-    return incomingReadTransfers[initiator_id].is_done;
+    return slot(false, initiator_id).isDone();
 }
 
 bool NonBlockingMainMemory::isWriteDataReady(uint32_t initiator_id) {
-    bool result = incomingWriteTransfers[initiator_id].is_done;
-    if (result) incomingWriteTransfers.erase(initiator_id);
+    auto& cur_req = slot(true, initiator_id);
+    bool result = cur_req.isDone();
+    if (result) {
+        if (Timeline::enabled && cur_req.state == Request::DONE)
+            timelineSpan(Timeline::AXI_WRITE, cur_req, initiator_id);
+        cur_req = Request();
+    }
     return result;
 }
 
+void NonBlockingMainMemory::timelineSpan(
+    Timeline::KIND kind, const Request& request, uint32_t initiator_id) {
+    auto& timeline = Timeline::get();
+    timeline.span(kind,
+        timeline.systemPid(),
+        Timeline::axiTrack(initiator_id),
+        request.burst_length,
+        request.timeline_begin,
+        timeline.now(),
+        uint64_t(request.byte_addr));
+}
+
 bool NonBlockingMainMemory::readData(uint8_t* data_ptr, const uint32_t initiator_id) {
-    auto& cur_req = incomingReadTransfers[initiator_id];
+    auto& cur_req = slot(false, initiator_id);
 
-    if (!cur_req.is_done) {
+    if (!cur_req.isDone()) {
         printf_error("ERROR: VPRO Main Memory Not Ready for Read Data\n");
         return false;
     }
@@ -86,17 +256,16 @@ bool NonBlockingMainMemory::readData(uint8_t* data_ptr, const uint32_t initiator
             memcpy(&data_ptr[i], (uint8_t*)(cur_req.byte_addr + i), 1);
     }
 
-    incomingReadTransfers.erase(initiator_id);
+    if (Timeline::enabled) timelineSpan(Timeline::AXI_READ, cur_req, initiator_id);
+    cur_req = Request();
     return true;
 }
 
 bool NonBlockingMainMemory::requestReadTransfer(
     intptr_t dst_addr_ptr, const uint32_t burst_length, const uint32_t initiator_id) {
-    Request cur_request;
+    auto& cur_request = startRequest(false, initiator_id);
     cur_request.byte_addr = dst_addr_ptr;
     cur_request.burst_length = burst_length;
-    cur_request.is_done = false;
-    incomingReadTransfers[initiator_id] = cur_request;
 
     if (gen_mem_trace) {
         mem_trace << tick_counter << "," << dst_addr_ptr << "," << burst_length << ",r\n";
@@ -110,12 +279,10 @@ bool NonBlockingMainMemory::requestWriteTransfer(intptr_t dst_addr_ptr,
     const uint8_t* data_ptr,
     const uint32_t burst_length,
     const uint32_t initiator_id) {
-    Request cur_request;
+    auto& cur_request = startRequest(true, initiator_id);
     cur_request.byte_addr = dst_addr_ptr;
     cur_request.data_ptr = const_cast<uint8_t*>(data_ptr);
     cur_request.burst_length = burst_length;
-    cur_request.is_done = false;
-    incomingWriteTransfers[initiator_id] = cur_request;
 
     if (dst_addr_ptr < memory_byte_size) {
         if (debug & DEBUG_EXT_MEM)
@@ -123,6 +290,7 @@ bool NonBlockingMainMemory::requestWriteTransfer(intptr_t dst_addr_ptr,
                 "[MM] write from loc to ext (addr = 0x%08X) burst_length in 512bit-words: %i\n",
                 cur_request.byte_addr,
                 cur_request.burst_length);
+        markDirty(cur_request.byte_addr, dataword_length_byte * cur_request.burst_length);
         for (int i = 0; i < dataword_length_byte * cur_request.burst_length; ++i) {
             memory[cur_request.byte_addr + i] = data_ptr[i];
             if (debug & DEBUG_EXT_MEM && i % 2 == 0)
@@ -144,7 +312,28 @@ bool NonBlockingMainMemory::requestWriteTransfer(intptr_t dst_addr_ptr,
     return true;
 }
 
+void NonBlockingMainMemory::printStatistics() const {
+    if (!timing.dram) return;
+    uint64_t transfers = dram_stats.reads + dram_stats.writes;
+    uint64_t accesses = dram_stats.row_hits + dram_stats.row_misses + dram_stats.row_conflicts;
+    printf_info("Main Memory (DRAM model):\n");
+    printf("  Transfers:         %" PRIu64 " (read: %" PRIu64 ", write: %" PRIu64 ")\n",
+        transfers,
+        dram_stats.reads,
+        dram_stats.writes);
+    printf("  Row hits:          %" PRIu64 " (%.2f%%)\n",
+        dram_stats.row_hits,
+        accesses > 0 ? 100. * double(dram_stats.row_hits) / double(accesses) : 0.);
+    printf("  Row misses:        %" PRIu64 "\n", dram_stats.row_misses);
+    printf("  Row conflicts:     %" PRIu64 "\n", dram_stats.row_conflicts);
+    printf("  Refreshes:         %" PRIu64 "\n", dram_stats.refreshes);
+    printf("  Queue full cycles: %" PRIu64 "\n", dram_stats.queue_full_cycles);
+    printf("  Mean latency:      %.2f AXI cycles\n",
+        transfers > 0 ? double(dram_stats.latency_cycles) / double(transfers) : 0.);
+}
+
 void NonBlockingMainMemory::dbgWrite(intptr_t dst_addr, uint8_t* data_ptr) {
+    markDirty(dst_addr, 1);
     memory[dst_addr] = data_ptr[0];
 }
 
@@ -152,6 +341,104 @@ void NonBlockingMainMemory::dbgRead(intptr_t dst_addr, uint8_t* data_ptr) {
     data_ptr[0] = memory[dst_addr];
 }
 
+void NonBlockingMainMemory::dbgWriteBlock(intptr_t dst_addr, const uint8_t* data_ptr, uint64_t size) {
+    if (dst_addr < 0 || uint64_t(dst_addr) + size > memory_byte_size) {
+        printf_error("[MM] dbgWriteBlock out of range! (addr: 0x%lx, size: %lu, MM size: %lu)\n",
+            dst_addr,
+            size,
+            memory_byte_size);
+        return;
+    }
+    markDirty(dst_addr, size);
+    memcpy(&memory[dst_addr], data_ptr, size);
+}
+
+void NonBlockingMainMemory::dbgReadBlock(intptr_t dst_addr, uint8_t* data_ptr, uint64_t size) {
+    if (dst_addr < 0 || uint64_t(dst_addr) + size > memory_byte_size) {
+        printf_error("[MM] dbgReadBlock out of range! (addr: 0x%lx, size: %lu, MM size: %lu)\n",
+            dst_addr,
+            size,
+            memory_byte_size);
+        return;
+    }
+    memcpy(data_ptr, &memory[dst_addr], size);
+}
+
+uint8_t* NonBlockingMainMemory::dbgHostPtr(intptr_t addr, uint64_t size) {
+    if (addr < 0 || uint64_t(addr) + size > memory_byte_size) {
+        printf_error("[MM] dbgHostPtr out of range! (addr: 0x%lx, size: %lu, MM size: %lu)\n",
+            addr,
+            size,
+            memory_byte_size);
+        return nullptr;
+    }
+    markDirty(addr, size);  // the caller may write through the pointer
+    return &memory[addr];
+}
+
 uint64_t NonBlockingMainMemory::getMemByteSize() const {
     return memory_byte_size;
 }
+
+void NonBlockingMainMemory::markDirty(uint64_t addr, uint64_t size) {
+    if (size == 0 || addr >= memory_byte_size) return;
+    uint64_t last = std::min(addr + size, memory_byte_size) - 1;
+    for (uint64_t page = addr / checkpoint_page_size; page <= last / checkpoint_page_size; page++)
+        dirty_pages[page] = true;
+}
+
+void NonBlockingMainMemory::saveCheckpoint(QDataStream& out) const {
+    const uint64_t page_size = checkpoint_page_size;
+    const std::vector<uint8_t> zero(page_size, 0);
+
+    Checkpoint::write(out, tick_counter);
+    Checkpoint::write(out, banks);
+    Checkpoint::write(out, data_bus_ready_cycle);
+    Checkpoint::write(out, next_refresh_cycle);
+    Checkpoint::write(out, memory_byte_size);
+    Checkpoint::write(out, page_size);
+    for (uint64_t page = 0; page < dirty_pages.size(); page++) {
+        if (!dirty_pages[page]) continue;
+        uint64_t addr = page * page_size;
+        uint64_t size = std::min(page_size, memory_byte_size - addr);
+        if (memcmp(&memory[addr], zero.data(), size) == 0) continue;
+        Checkpoint::write(out, page);
+        Checkpoint::writeArray(out, &memory[addr], size);
+    }
+    Checkpoint::write(out, uint64_t(dirty_pages.size()));  // end marker
+}
+
+void NonBlockingMainMemory::restoreCheckpoint(QDataStream& in) {
+    uint64_t checkpoint_byte_size, page_size;
+    Checkpoint::read(in, tick_counter);
+    Checkpoint::read(in, banks);
+    Checkpoint::read(in, data_bus_ready_cycle);
+    Checkpoint::read(in, next_refresh_cycle);
+    Checkpoint::read(in, checkpoint_byte_size);
+    Checkpoint::read(in, page_size);
+    if (checkpoint_byte_size != memory_byte_size || page_size != checkpoint_page_size) {
+        printf_error("# [NonBlockingMainMemory] Checkpoint of different memory size (%lu, here: "
+                     "%lu) / page size (%lu, here: %lu)!\n",
+            checkpoint_byte_size,
+            memory_byte_size,
+            page_size,
+            checkpoint_page_size);
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint64_t page = 0; page < dirty_pages.size(); page++) {
+        if (!dirty_pages[page]) continue;
+        uint64_t addr = page * page_size;
+        memset(&memory[addr], 0, std::min(page_size, memory_byte_size - addr));
+    }
+
+    uint64_t page;
+    Checkpoint::read(in, page);
+    while (page < dirty_pages.size() && in.status() == QDataStream::Ok) {
+        uint64_t addr = page * page_size;
+        uint64_t size = std::min(page_size, memory_byte_size - addr);
+        markDirty(addr, size);
+        Checkpoint::readArray(in, &memory[addr], size);
+        Checkpoint::read(in, page);
+    }
+}
@@ -17,13 +17,18 @@
 
 #include <stdio.h>
 #include <fstream>
-#include <map>
 #include <sstream>
+#include <vector>
+#include "../../simulator/helper/timeline.h"
+#include "MainMemoryTiming.h"
 #include "NonBlockingBusSlaveInterface.h"
 
+class QDataStream;
+
 class NonBlockingMainMemory : public NonBlockingBusSlaveInterface {
    public:
-    explicit NonBlockingMainMemory(uint64_t memory_byte_size);
+    explicit NonBlockingMainMemory(
+        uint64_t memory_byte_size, const MainMemoryTiming& timing = MainMemoryTiming());
 
     uint8_t* getMemory() {
         return memory;
@@ -31,6 +36,24 @@ class NonBlockingMainMemory : public NonBlockingBusSlaveInterface {
 
     void tick();
 
+    /**
+     * equivalent to ticks times tick(). completes pending transfers whose latency passes
+     */
+    void tick(uint64_t ticks);
+
+    /**
+     * number of ticks which complete no pending transfer (next event of the memory),
+     * UINT64_MAX if none is pending
+     */
+    [[nodiscard]] uint64_t ticksUntilCompletion() const;
+
+    [[nodiscard]] const MainMemoryTiming& getTiming() const {
+        return timing;
+    }
+
+    // DRAM model: transfers, row hits / misses / conflicts, refreshes, mean latency
+    void printStatistics() const;
+
     bool requestReadTransfer(
         intptr_t dst_addr_ptr, uint32_t burst_length, uint32_t initiator_id) override;
 
@@ -49,29 +72,110 @@ class NonBlockingMainMemory : public NonBlockingBusSlaveInterface {
 
     void dbgRead(intptr_t dst_addr, uint8_t* data_ptr) override;
 
+    // memcpy from / to the memory (range checked)
+    void dbgWriteBlock(intptr_t dst_addr, const uint8_t* data_ptr, uint64_t size) override;
+
+    void dbgReadBlock(intptr_t dst_addr, uint8_t* data_ptr, uint64_t size) override;
+
+    // pointer into the mapping (range checked, nullptr if out of range)
+    uint8_t* dbgHostPtr(intptr_t addr, uint64_t size) override;
+
     [[nodiscard]] uint64_t getMemByteSize() const;
 
+    /**
+     * simulator checkpoint without pending transfers: content of the written (dirty, non zero)
+     * pages and the DRAM state (open rows, refresh), restore clears all other written pages.
+     * restore of a checkpoint with different memory / page size terminates the simulation
+     */
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
    private:
     uint8_t* memory;
     uint64_t memory_byte_size;
-    uint32_t cycles_read_latency = 36;
-    uint32_t cycles_write_latency = 6;
+    MainMemoryTiming timing;
+
+    // granularity of the checkpoint, independent of the host page size
+    constexpr static uint64_t checkpoint_page_size = 4096;
+    // pages written since allocation (transfers, dbg accesses, dbgHostPtr), may be non zero
+    std::vector<bool> dirty_pages;
+    void markDirty(uint64_t addr, uint64_t size);
 
     struct Request {
+        enum STATE : uint8_t {
+            IDLE,    // no transfer (done)
+            QUEUED,  // DRAM: waiting for the scheduler
+            ACTIVE,  // issued, waiting for ready_cycle
+            DONE
+        };
         uint32_t burst_length{};
         intptr_t byte_addr{};
         uint8_t* data_ptr{};
-        uint32_t cycle_counter = 0;
-        bool is_done = true;
+        uint64_t request_cycle{};
+        uint64_t ready_cycle{};
+        STATE state{IDLE};
+        double timeline_begin{};  // helper/timeline.h
+
+        [[nodiscard]] bool isDone() const {
+            return state == IDLE || state == DONE;
+        }
     };
 
-    std::map<uint32_t, Request> incomingReadTransfers, incomingWriteTransfers;
+    // flat slots, one transfer per initiator (cluster id) and direction
+    std::vector<Request> readSlots, writeSlots;
+
+    struct SlotRef {
+        bool is_write;
+        uint32_t initiator_id;
+    };
+    // DRAM: requests not yet issued, arrival order
+    std::vector<SlotRef> queued;
+    // issued requests, not yet done
+    std::vector<SlotRef> active;
+
+    Request& slot(bool is_write, uint32_t initiator_id) {
+        auto& transfers = is_write ? writeSlots : readSlots;
+        if (initiator_id >= transfers.size()) transfers.resize(initiator_id + 1);
+        return transfers[initiator_id];
+    }
+
+    // (re)starts the transfer of the slot (replaces a pending one of this initiator)
+    Request& startRequest(bool is_write, uint32_t initiator_id);
+
+    // marks active requests with ready_cycle < end_cycle done
+    void completeActive(uint64_t end_cycle);
+
+    struct Bank {
+        int64_t open_row{-1};  // -1: precharged
+        uint64_t ready_cycle{0};
+    };
+    std::vector<Bank> banks;
+    uint64_t data_bus_ready_cycle{0};
+    uint64_t next_refresh_cycle{0};
+
+    // DRAM: refresh, issue of one queued request (FR-FCFS) in the current cycle
+    void tickDRAM();
+    void refresh(uint64_t cycle);
+
+    struct DRAMStatistics {
+        uint64_t reads{0};
+        uint64_t writes{0};
+        uint64_t row_hits{0};
+        uint64_t row_misses{0};
+        uint64_t row_conflicts{0};
+        uint64_t refreshes{0};
+        uint64_t queue_full_cycles{0};  // more requests than queue_depth waiting
+        uint64_t latency_cycles{0};     // request to ready, summed up
+    } dram_stats;
+
+    // span of a completed transfer (Timeline::enabled)
+    void timelineSpan(Timeline::KIND kind, const Request& request, uint32_t initiator_id);
 
     bool gen_mem_trace{false};
 
     std::ofstream mem_trace;
 
-    uint32_t tick_counter = 0;
+    uint64_t tick_counter = 0;
 };
 
 #endif  //TEMPLATE_NONBLOCKINGMAINMEMORY_H
@@ -12,6 +12,7 @@
 
 #include <sstream>
 #include <string>
+#include "../../simulator/helper/checkpoint.h"
 #include "../../simulator/helper/debugHelper.h"
 #include "../../simulator/helper/typeConversion.h"
 #include "Cluster.h"
@@ -218,6 +219,22 @@ void Register::update() {
     }
 }
 
+void Register::saveCheckpoint(QDataStream& out) const {
+    if (is_disabled("saveCheckpoint", false)) return;
+    Checkpoint::writeArray(out, rf_data, register_file_size * 3);
+    Checkpoint::writeArray(out, rf_flag[0], register_file_size);
+    Checkpoint::writeArray(out, rf_flag[1], register_file_size);
+    Checkpoint::writeArray(out, is_uninitialized, register_file_size);
+}
+
+void Register::restoreCheckpoint(QDataStream& in) {
+    if (is_disabled("restoreCheckpoint", false)) return;
+    Checkpoint::readArray(in, rf_data, register_file_size * 3);
+    Checkpoint::readArray(in, rf_flag[0], register_file_size);
+    Checkpoint::readArray(in, rf_flag[1], register_file_size);
+    Checkpoint::readArray(in, is_uninitialized, register_file_size);
+}
+
 void Register::set_rf_data_nxt(int addr, uint32_t data, int size) {
     if (rf_inst.nxt) printf_warning("[RegisterFile]: Override RF Nxt Value\n");
     rf_inst.addr = addr;
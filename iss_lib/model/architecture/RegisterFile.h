@@ -15,6 +15,8 @@
 #include <string>
 #include "../../simulator/helper/typeConversion.h"
 
+class QDataStream;
+
 namespace RegisterFile {
 
 struct RegisterInstructionVal {
@@ -59,6 +61,10 @@ class Register {
     void set_rf_flag_nxt(int addr, int select, bool value);
     void update();
 
+    // simulator checkpoint (data, flags and initialization state, no pending _nxt values)
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
    private:
     int cluster_id, vector_unit_id;
 
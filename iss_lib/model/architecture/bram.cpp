@@ -14,6 +14,7 @@
 
 #include "bram.h"
 #include <sys/mman.h>
+#include "../../simulator/helper/checkpoint.h"
 #include "../../simulator/helper/debugHelper.h"
 
 Bram::Bram(uint32_t bram_size_byte, uint32_t bram_word_length) {
@@ -54,3 +55,11 @@ void Bram::set_accessed_this_cycle(bool access) {
     else
         accessed_this_cycle = 0;
 }
+
+void Bram::saveCheckpoint(QDataStream& out) const {
+    Checkpoint::writeArray(out, memory, bram_size_byte);
+}
+
+void Bram::restoreCheckpoint(QDataStream& in) {
+    Checkpoint::readArray(in, memory, bram_size_byte);
+}
@@ -18,6 +18,8 @@
 #include <inttypes.h>
 #include <vector>
 
+class QDataStream;
+
 class Bram {
    public:
     Bram(uint32_t bram_size_byte, uint32_t bram_word_length);
@@ -30,6 +32,10 @@ class Bram {
 
     void set_accessed_this_cycle(bool access);
 
+    // simulator checkpoint of the memory content
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
    private:
     constexpr static int dma_dataword_length_byte = 16 / 8;
     constexpr static int dcma_dataword_length_byte = 128 / 8;
@@ -20,6 +20,9 @@
 #define JSON_OBJ_BEGIN ("{")
 #define JSON_OBJ_END ("}")
 
+#define JSON_ARRAY_BEGIN ("[")
+#define JSON_ARRAY_END ("]")
+
 #define JSON_FIELD_STRING(id, val) JSON_ID(id) << JSON_STRING(val)
 #define JSON_FIELD_INT(id, val) JSON_ID(id) << JSON_INT(val)
 #define JSON_FIELD_FLOAT(id, val) JSON_ID(id) << JSON_FLOAT(val)
@@ -13,6 +13,7 @@
 //
 
 #include "StatisticBase.h"
+#include "../../../simulator/helper/checkpoint.h"
 #include "../../../simulator/helper/debugHelper.h"
 
 StatisticBase::StatisticBase() {}
@@ -23,6 +24,10 @@ void StatisticBase::tick() {
     total_ticks++;
 }
 
+void StatisticBase::tickIdle(uint64_t ticks) {
+    total_ticks += long(ticks);
+}
+
 void StatisticBase::print(QString& output) {
     output.asprintf("Total Clock Ticks: %li \n", total_ticks);
 }
@@ -30,3 +35,11 @@ void StatisticBase::print(QString& output) {
 void StatisticBase::reset() {
     total_ticks = 0;
 }
+
+void StatisticBase::saveCheckpoint(QDataStream& out) const {
+    Checkpoint::write(out, total_ticks);
+}
+
+void StatisticBase::restoreCheckpoint(QDataStream& in) {
+    Checkpoint::read(in, total_ticks);
+}
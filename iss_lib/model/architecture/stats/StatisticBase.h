@@ -16,8 +16,10 @@
 #define CONV2DADD_STATISTICBASE_H
 
 #include <QString>
+#include <cstdint>
 
 class ISS;
+class QDataStream;
 
 class StatisticBase {
    public:
@@ -26,11 +28,20 @@ class StatisticBase {
 
     virtual void tick();
 
+    /**
+     * account ticks clock ticks of an idle system (nothing busy) at once
+     */
+    virtual void tickIdle(uint64_t ticks);
+
     virtual void print(QString& output);
     virtual void print_json(QString& output){};
 
     virtual void reset();
 
+    // simulator checkpoint (ISS::sim_checkpoint_save / sim_checkpoint_restore)
+    virtual void saveCheckpoint(QDataStream& out) const;
+    virtual void restoreCheckpoint(QDataStream& in);
+
    protected:
     ISS* core;
 
@@ -14,12 +14,16 @@
 
 #include "StatisticDcma.h"
 #include "../../../simulator/ISS.h"
+#include "../../../simulator/helper/checkpoint.h"
 #include "../../../simulator/helper/debugHelper.h"
 
 #include "JSONHelpers.h"
 
+#include <algorithm>
+#include <cstring>
+
 StatisticDcma::StatisticDcma(ISS* core) : StatisticBase(core) {
-    uint32_t num_cluster = VPRO_CFG::CLUSTERS;
+    uint32_t num_cluster = core->getHWConfig().clusters;
     cycle_counters.did_dma_read_hit = std::vector<uint32_t>(num_cluster, 0);
     cycle_counters.did_dma_read_hit_but_busy = std::vector<uint32_t>(num_cluster, 0);
     cycle_counters.did_dma_read_miss = std::vector<uint32_t>(num_cluster, 0);
@@ -43,9 +47,9 @@ StatisticDcma::StatisticDcma(ISS* core) : StatisticBase(core) {
 void StatisticDcma::tick() {
     StatisticBase::tick();
 
-    uint32_t number_cluster = VPRO_CFG::CLUSTERS;
+    uint32_t number_cluster = core->getHWConfig().clusters;
 
-    std::vector<uint32_t> sum(6, 0);
+    uint32_t sum[6]{};
     // count dma accesses in last cycle
     for (int i = 0; i < number_cluster; ++i) {
         sum[0] += cycle_counters.did_dma_read_hit[i];
@@ -76,20 +80,36 @@ void StatisticDcma::tick() {
     counters.write_hit_but_busy_cyle_counter += sum[4];
     counters.write_miss_cycle_counter += sum[5];
 
-    cycle_counters.did_dma_read_hit = std::vector<uint32_t>(number_cluster, 0);
-    cycle_counters.did_dma_read_hit_but_busy = std::vector<uint32_t>(number_cluster, 0);
-    cycle_counters.did_dma_read_miss = std::vector<uint32_t>(number_cluster, 0);
-    cycle_counters.did_dma_write_hit = std::vector<uint32_t>(number_cluster, 0);
-    cycle_counters.did_dma_write_hit_but_busy = std::vector<uint32_t>(number_cluster, 0);
-    cycle_counters.did_dma_write_miss = std::vector<uint32_t>(number_cluster, 0);
+    for (auto* flags : {&cycle_counters.did_dma_read_hit,
+             &cycle_counters.did_dma_read_hit_but_busy,
+             &cycle_counters.did_dma_read_miss,
+             &cycle_counters.did_dma_write_hit,
+             &cycle_counters.did_dma_write_hit_but_busy,
+             &cycle_counters.did_dma_write_miss}) {
+        std::fill(flags->begin(), flags->end(), 0);
+    }
 
     if (core->dcma->isBusy()) counters.dcma_busy_cycles++;
 }
 
+void StatisticDcma::tickIdle(uint64_t ticks) {
+    if (ticks == 0) return;
+    // consumes the accesses of the last cycle
+    tick();
+    ticks--;
+
+    // no dma accesses in remaining cycles
+    StatisticBase::tickIdle(ticks);
+    counters.dma_read_hit_cycle_counter[0] += ticks;
+    counters.dma_read_stall_cycle_counter[0] += 2 * ticks;
+    counters.dma_write_hit_cycle_counter[0] += ticks;
+    counters.dma_write_stall_cycle_counter[0] += 2 * ticks;
+}
+
 void StatisticDcma::reset() {
     StatisticBase::reset();
 
-    uint32_t number_cluster = VPRO_CFG::CLUSTERS;
+    uint32_t number_cluster = core->getHWConfig().clusters;
     cycle_counters = CycleCounters();
     counters = AllCounters();
     cycle_counters.did_dma_read_hit = std::vector<uint32_t>(number_cluster, 0);
@@ -110,10 +130,82 @@ void StatisticDcma::reset() {
     dma_access_counter.read_miss_cycles = std::vector<uint32_t>(number_cluster, 0);
     dma_access_counter.write_hit_cycles = std::vector<uint32_t>(number_cluster, 0);
     dma_access_counter.write_miss_cycles = std::vector<uint32_t>(number_cluster, 0);
+    misses = MissCounters();
+    set_misses.clear();
+    region_misses.clear();
+    open_regions.clear();
+}
+
+void StatisticDcma::countMiss(uint32_t set, MissClass miss_class) {
+    if (set >= set_misses.size()) set_misses.resize(set + 1);
+    misses.count[miss_class]++;
+    set_misses[set].count[miss_class]++;
+}
+
+void StatisticDcma::markerBegin(const char* name) {
+    RegionMisses region;
+    strncpy(region.name, name, sizeof(region.name) - 1);
+    region.misses = misses;
+    open_regions.push_back(region_misses.size());
+    region_misses.push_back(region);
+}
+
+void StatisticDcma::markerEnd() {
+    if (open_regions.empty()) return;  // begin before a reset
+    MissCounters& region = region_misses[open_regions.back()].misses;
+    for (int c = 0; c < MISS_CLASSES; ++c) {
+        region.count[c] = misses.count[c] - region.count[c];
+    }
+    open_regions.pop_back();
+}
+
+void StatisticDcma::printMisses(QTextStream& out) {
+    static const char* names[MISS_CLASSES] = {"Compulsory", "Capacity", "Conflict"};
+    uint32_t total = misses.total();
+    out << "  Miss Classification (demand line fills, fully associative LRU reference)\n";
+    for (int c = 0; c < MISS_CLASSES; ++c) {
+        out << "      " << QString(names[c]).append(":").leftJustified(22) << misses.count[c]
+            << "  [" << 100 * float(misses.count[c]) / float(total) << "%]\n";
+    }
+
+    // conflict misses concentrated on few sets: set index bits of the mm layout (netgen),
+    // spread over all sets: associativity
+    std::vector<uint32_t> sets;
+    for (uint32_t set = 0; set < set_misses.size(); ++set) {
+        if (set_misses[set].count[CONFLICT] > 0) sets.push_back(set);
+    }
+    std::stable_sort(sets.begin(), sets.end(), [this](uint32_t a, uint32_t b) {
+        return set_misses[a].count[CONFLICT] > set_misses[b].count[CONFLICT];
+    });
+    uint32_t nr_sets = core->dcma->getNrRams() * core->dcma->getRamSize() /
+                       (core->dcma->getLineSize() * core->dcma->getAssociativity());
+    out << "  Sets with Conflict Misses: " << sets.size() << " (of " << nr_sets << ")\n";
+    if (!sets.empty()) {
+        out << "      Set: Compulsory / Capacity / Conflict (most conflict misses first)\n";
+    }
+    for (size_t i = 0; i < std::min<size_t>(sets.size(), 8); ++i) {
+        const auto& set = set_misses[sets[i]];
+        out << "      " << QString::number(sets[i]).rightJustified(5) << ": "
+            << set.count[COMPULSORY] << " / " << set.count[CAPACITY] << " / "
+            << set.count[CONFLICT] << "\n";
+    }
+
+    if (!region_misses.empty()) {
+        out << "  Per Marker: Compulsory / Capacity / Conflict\n";
+    }
+    for (size_t i = 0; i < region_misses.size(); ++i) {
+        if (std::find(open_regions.begin(), open_regions.end(), i) != open_regions.end())
+            continue;
+        const auto& region = region_misses[i];
+        out << "      " << QString(region.name).append(":").leftJustified(30)
+            << region.misses.count[COMPULSORY] << " / " << region.misses.count[CAPACITY]
+            << " / " << region.misses.count[CONFLICT] << "\n";
+    }
+    out << "\n";
 }
 
 void StatisticDcma::print(QString& output) {
-    uint32_t number_cluster = VPRO_CFG::CLUSTERS;
+    uint32_t number_cluster = core->getHWConfig().clusters;
     QTextStream out(&output);
     out.setRealNumberNotation(QTextStream::FixedNotation);
     out.setRealNumberPrecision(2);
@@ -208,12 +300,133 @@ void StatisticDcma::print(QString& output) {
                float(core->dcma->bus_dataword_length_byte) / float(core->getDCMAClockPeriod())
         << "\n";
     out << "\n";
+
+    if (counters.prefetch_issued > 0) {
+        // accuracy: share of prefetches used, coverage: share of line fills a dma found prefetched
+        uint32_t fills = counters.demand_line_fills + counters.prefetch_useful;
+        out << "  Prefetch Counters\n";
+        out << "      Demand Line Fills:    " << counters.demand_line_fills << "\n";
+        out << "      Prefetches:           " << counters.prefetch_issued << "\n";
+        out << "      Useful:               " << counters.prefetch_useful << "\n";
+        out << "      Replaced Unused:      " << counters.prefetch_unused << "\n";
+        out << "  Prefetch Accuracy:        "
+            << 100 * float(counters.prefetch_useful) / float(counters.prefetch_issued) << "%\n";
+        out << "  Prefetch Coverage:        "
+            << (fills > 0 ? 100 * float(counters.prefetch_useful) / float(fills) : 0.f)
+            << "%\n\n";
+    }
+
+    if (misses.total() > 0) printMisses(out);
 }
 
 void StatisticDcma::print_json(QString& output) {
     QTextStream out(&output);
     out << JSON_OBJ_BEGIN;
     out << JSON_FIELD_FLOAT("clock_period", core->getDCMAClockPeriod()) << ",";
-    out << JSON_FIELD_INT("total_ticks", total_ticks);
+    out << JSON_FIELD_INT("total_ticks", total_ticks) << ",";
+    out << JSON_FIELD_INT("demand_line_fills", counters.demand_line_fills) << ",";
+    out << JSON_FIELD_INT("prefetch_issued", counters.prefetch_issued) << ",";
+    out << JSON_FIELD_INT("prefetch_useful", counters.prefetch_useful) << ",";
+    out << JSON_FIELD_INT("prefetch_unused", counters.prefetch_unused) << ",";
+    out << JSON_FIELD_INT("compulsory_misses", misses.count[COMPULSORY]) << ",";
+    out << JSON_FIELD_INT("capacity_misses", misses.count[CAPACITY]) << ",";
+    out << JSON_FIELD_INT("conflict_misses", misses.count[CONFLICT]) << ",";
+    // [compulsory, capacity, conflict] per set / marker
+    out << JSON_ID("set_misses") << JSON_ARRAY_BEGIN;
+    for (size_t i = 0; i < set_misses.size(); ++i) {
+        const auto& set = set_misses[i];
+        out << (i > 0 ? "," : "") << JSON_ARRAY_BEGIN << set.count[COMPULSORY] << ","
+            << set.count[CAPACITY] << "," << set.count[CONFLICT] << JSON_ARRAY_END;
+    }
+    out << JSON_ARRAY_END << ",";
+    out << JSON_ID("marker_misses") << JSON_ARRAY_BEGIN;
+    for (size_t i = 0; i < region_misses.size(); ++i) {
+        const auto& region = region_misses[i];
+        out << (i > 0 ? "," : "") << JSON_OBJ_BEGIN << JSON_FIELD_STRING("name", region.name)
+            << "," << JSON_ID("misses") << JSON_ARRAY_BEGIN
+            << region.misses.count[COMPULSORY] << "," << region.misses.count[CAPACITY] << ","
+            << region.misses.count[CONFLICT] << JSON_ARRAY_END << JSON_OBJ_END;
+    }
+    out << JSON_ARRAY_END;
     out << JSON_OBJ_END;
 }
+
+void StatisticDcma::saveCheckpoint(QDataStream& out) const {
+    StatisticBase::saveCheckpoint(out);
+    Checkpoint::write(out, cycle_counters.did_dma_read_hit);
+    Checkpoint::write(out, cycle_counters.did_dma_read_hit_but_busy);
+    Checkpoint::write(out, cycle_counters.did_dma_read_miss);
+    Checkpoint::write(out, cycle_counters.did_dma_write_hit);
+    Checkpoint::write(out, cycle_counters.did_dma_write_hit_but_busy);
+    Checkpoint::write(out, cycle_counters.did_dma_write_miss);
+    Checkpoint::write(out, counters.read_hit_cyle_counter);
+    Checkpoint::write(out, counters.read_hit_but_busy_cycle_counter);
+    Checkpoint::write(out, counters.read_miss_cycle_counter);
+    Checkpoint::write(out, counters.write_hit_cycle_counter);
+    Checkpoint::write(out, counters.write_hit_but_busy_cyle_counter);
+    Checkpoint::write(out, counters.write_miss_cycle_counter);
+    Checkpoint::write(out, counters.dma_read_hit_cycle_counter);
+    Checkpoint::write(out, counters.dma_read_stall_cycle_counter);
+    Checkpoint::write(out, counters.dma_write_hit_cycle_counter);
+    Checkpoint::write(out, counters.dma_write_stall_cycle_counter);
+    Checkpoint::write(out, counters.bus_write_cycles);
+    Checkpoint::write(out, counters.bus_read_cycles);
+    Checkpoint::write(out, counters.bus_wait_cycles);
+    Checkpoint::write(out, counters.dcma_busy_cycles);
+    Checkpoint::write(out, counters.read_hit_access_counter);
+    Checkpoint::write(out, counters.read_miss_access_counter);
+    Checkpoint::write(out, counters.write_hit_access_counter);
+    Checkpoint::write(out, counters.write_miss_access_counter);
+    Checkpoint::write(out, counters.demand_line_fills);
+    Checkpoint::write(out, counters.prefetch_issued);
+    Checkpoint::write(out, counters.prefetch_useful);
+    Checkpoint::write(out, counters.prefetch_unused);
+    Checkpoint::write(out, misses);
+    Checkpoint::write(out, set_misses);
+    Checkpoint::write(out, region_misses);
+    Checkpoint::write(out, open_regions);
+    Checkpoint::write(out, dma_access_counter.read_hit_cycles);
+    Checkpoint::write(out, dma_access_counter.read_miss_cycles);
+    Checkpoint::write(out, dma_access_counter.write_hit_cycles);
+    Checkpoint::write(out, dma_access_counter.write_miss_cycles);
+}
+
+void StatisticDcma::restoreCheckpoint(QDataStream& in) {
+    StatisticBase::restoreCheckpoint(in);
+    Checkpoint::read(in, cycle_counters.did_dma_read_hit);
+    Checkpoint::read(in, cycle_counters.did_dma_read_hit_but_busy);
+    Checkpoint::read(in, cycle_counters.did_dma_read_miss);
+    Checkpoint::read(in, cycle_counters.did_dma_write_hit);
+    Checkpoint::read(in, cycle_counters.did_dma_write_hit_but_busy);
+    Checkpoint::read(in, cycle_counters.did_dma_write_miss);
+    Checkpoint::read(in, counters.read_hit_cyle_counter);
+    Checkpoint::read(in, counters.read_hit_but_busy_cycle_counter);
+    Checkpoint::read(in, counters.read_miss_cycle_counter);
+    Checkpoint::read(in, counters.write_hit_cycle_counter);
+    Checkpoint::read(in, counters.write_hit_but_busy_cyle_counter);
+    Checkpoint::read(in, counters.write_miss_cycle_counter);
+    Checkpoint::read(in, counters.dma_read_hit_cycle_counter);
+    Checkpoint::read(in, counters.dma_read_stall_cycle_counter);
+    Checkpoint::read(in, counters.dma_write_hit_cycle_counter);
+    Checkpoint::read(in, counters.dma_write_stall_cycle_counter);
+    Checkpoint::read(in, counters.bus_write_cycles);
+    Checkpoint::read(in, counters.bus_read_cycles);
+    Checkpoint::read(in, counters.bus_wait_cycles);
+    Checkpoint::read(in, counters.dcma_busy_cycles);
+    Checkpoint::read(in, counters.read_hit_access_counter);
+    Checkpoint::read(in, counters.read_miss_access_counter);
+    Checkpoint::read(in, counters.write_hit_access_counter);
+    Checkpoint::read(in, counters.write_miss_access_counter);
+    Checkpoint::read(in, counters.demand_line_fills);
+    Checkpoint::read(in, counters.prefetch_issued);
+    Checkpoint::read(in, counters.prefetch_useful);
+    Checkpoint::read(in, counters.prefetch_unused);
+    Checkpoint::read(in, misses);
+    Checkpoint::read(in, set_misses);
+    Checkpoint::read(in, region_misses);
+    Checkpoint::read(in, open_regions);
+    Checkpoint::read(in, dma_access_counter.read_hit_cycles);
+    Checkpoint::read(in, dma_access_counter.read_miss_cycles);
+    Checkpoint::read(in, dma_access_counter.write_hit_cycles);
+    Checkpoint::read(in, dma_access_counter.write_miss_cycles);
+}
@@ -52,8 +52,30 @@ class StatisticDcma : public StatisticBase {
         uint32_t read_miss_access_counter = 0;
         uint32_t write_hit_access_counter = 0;
         uint32_t write_miss_access_counter = 0;
+        // line fills (Cache), prefetch: DCMA prefetcher
+        uint32_t demand_line_fills = 0;
+        uint32_t prefetch_issued = 0;
+        uint32_t prefetch_useful = 0;  // prefetched line accessed by a dma
+        uint32_t prefetch_unused = 0;  // prefetched line replaced without access
     } counters;
 
+    // classification of demand line fills (Cache, hwConfig dcma_miss_classification)
+    enum MissClass { COMPULSORY, CAPACITY, CONFLICT, MISS_CLASSES };
+    struct MissCounters {
+        uint32_t count[MISS_CLASSES]{};
+        uint32_t total() const {
+            return count[COMPULSORY] + count[CAPACITY] + count[CONFLICT];
+        }
+    };
+    MissCounters misses;
+    std::vector<MissCounters> set_misses;  // per cache set
+    // per runtime marker (sim_timeline_begin / sim_timeline_end, e.g. yololite layers)
+    struct RegionMisses {
+        char name[48]{};
+        MissCounters misses;  // counters at begin, misses within the region after end
+    };
+    std::vector<RegionMisses> region_misses;
+
     struct DmaAccessCounters {
         std::vector<uint32_t> read_hit_cycles;
         std::vector<uint32_t> read_miss_cycles;
@@ -64,11 +86,24 @@ class StatisticDcma : public StatisticBase {
     explicit StatisticDcma(ISS* core);
 
     void tick() override;
+    void tickIdle(uint64_t ticks) override;
 
     void print(QString& output) override;
     void print_json(QString& output) override;
 
     void reset() override;
+
+    void countMiss(uint32_t set, MissClass miss_class);
+    void markerBegin(const char* name);
+    void markerEnd();
+
+    void saveCheckpoint(QDataStream& out) const override;
+    void restoreCheckpoint(QDataStream& in) override;
+
+   private:
+    std::vector<uint64_t> open_regions;  // indices in region_misses, innermost last
+
+    void printMisses(QTextStream& out);
 };
 
 #endif  //CONV2DADD_STATISTICDCMA_H
@@ -14,11 +14,13 @@
 
 #include "StatisticDma.h"
 #include "../../../simulator/ISS.h"
+#include "../../../simulator/helper/checkpoint.h"
 #include "../../../simulator/helper/debugHelper.h"
 
 #include "JSONHelpers.h"
 
-StatisticDma::StatisticDma(ISS* core) : StatisticBase(core) {}
+StatisticDma::StatisticDma(ISS* core)
+    : StatisticBase(core), clusters(core->getHWConfig().clusters) {}
 
 void StatisticDma::tick() {
     StatisticBase::tick();
@@ -38,6 +40,18 @@ void StatisticDma::tick() {
     }
 }
 
+void StatisticDma::tickIdle(uint64_t ticks) {
+    StatisticBase::tickIdle(ticks);
+    // busy dmas are stalled while ticks are skipped (ISS wait for main memory)
+    uint64_t active = 0;
+    for (auto cluster : core->getClusters()) {
+        if (cluster->dma->isBusy()) active++;
+    }
+    totalDMAActive += ticks * active;
+    totalDMAInActive += ticks * (clusters - active);
+    if (active > 0) anyDMAActive += ticks;
+}
+
 void StatisticDma::addExecutedCommand(const CommandDMA* cmd, const int& cluster) {
     uint32_t elements = cmd->x_size * cmd->y_size;
 
@@ -66,7 +80,7 @@ void StatisticDma::addExecutedCommand(const CommandDMA* cmd, const int& cluster)
 }
 
 void StatisticDma::print(QString& output) {
-    unsigned long DMAsTotal = total_ticks * VPRO_CFG::CLUSTERS;
+    unsigned long DMAsTotal = total_ticks * clusters;
 
     QTextStream out(&output);
     out.setRealNumberNotation(QTextStream::FixedNotation);
@@ -78,7 +92,7 @@ void StatisticDma::print(QString& output) {
 
     // DMA commands stats
     executedCommands_s allCmds;
-    for (int i = 0; i < VPRO_CFG::CLUSTERS; ++i) {
+    for (uint32_t i = 0; i < clusters; ++i) {
         allCmds += executedCommands[i];
     }
     out << "  Executed Commands: \n";
@@ -97,12 +111,12 @@ void StatisticDma::print(QString& output) {
     out << "    Average DMA Bandwidth: " << total_bandwidth << " MB/s\n";
 
     // !busy + active + src stall + dst stall = 100 %
-    if (100 * (double)(totalDMAActive) / (anyDMAActive * VPRO_CFG::CLUSTERS) < 99) {
+    if (100 * (double)(totalDMAActive) / (anyDMAActive * clusters) < 99) {
         out << "  [Parallel Architecture utilization] (total DMA active of at least one DMA active "
                "cycles "
             << "[over all clusters]):\n";
         out << "      DMAs:  " << ORANGE
-            << 100 * (double)(totalDMAActive) / (anyDMAActive * VPRO_CFG::CLUSTERS) << "%"
+            << 100 * (double)(totalDMAActive) / (anyDMAActive * clusters) << "%"
             << RESET_COLOR << " (not all DMAs are active together)\n"
             << LIGHT;
         out << "      Possible Reason: DMA instruction issue has offset between Clusters, "
@@ -120,7 +134,7 @@ void StatisticDma::print(QString& output) {
 }
 
 void StatisticDma::print_json(QString& output) {
-    unsigned long DMAsTotal = total_ticks * VPRO_CFG::CLUSTERS;
+    unsigned long DMAsTotal = total_ticks * clusters;
 
     QTextStream out(&output);
     out << JSON_OBJ_BEGIN;
@@ -128,11 +142,11 @@ void StatisticDma::print_json(QString& output) {
     out << JSON_FIELD_INT("total_ticks", total_ticks) << ",";
     out << JSON_FIELD_INT("total_active", totalDMAActive) << ",";
     out << JSON_FIELD_INT("any_active", anyDMAActive) << ",";
-    out << JSON_FIELD_INT("dma_count", VPRO_CFG::CLUSTERS) << ",";
+    out << JSON_FIELD_INT("dma_count", clusters) << ",";
     out << JSON_FIELD_INT("total_dma_ticks", DMAsTotal) << ",";
 
     out << JSON_FIELD_FLOAT("architecture_utilization",
-               (double)(totalDMAActive) / (anyDMAActive * VPRO_CFG::CLUSTERS))
+               (double)(totalDMAActive) / (anyDMAActive * clusters))
         << ",";
     out << JSON_FIELD_FLOAT("algorithm_utilization", (double)totalDMAActive / DMAsTotal);
     out << JSON_OBJ_END;
@@ -145,3 +159,19 @@ void StatisticDma::reset() {
     totalDMAInActive = 0;
     anyDMAActive = 0;
 }
+
+void StatisticDma::saveCheckpoint(QDataStream& out) const {
+    StatisticBase::saveCheckpoint(out);
+    Checkpoint::write(out, totalDMAActive);
+    Checkpoint::write(out, totalDMAInActive);
+    Checkpoint::write(out, anyDMAActive);
+    Checkpoint::write(out, executedCommands);
+}
+
+void StatisticDma::restoreCheckpoint(QDataStream& in) {
+    StatisticBase::restoreCheckpoint(in);
+    Checkpoint::read(in, totalDMAActive);
+    Checkpoint::read(in, totalDMAInActive);
+    Checkpoint::read(in, anyDMAActive);
+    Checkpoint::read(in, executedCommands);
+}
@@ -45,6 +45,7 @@ class StatisticDma : public StatisticBase {
     explicit StatisticDma(ISS* core);
 
     void tick() override;
+    void tickIdle(uint64_t ticks) override;
     void addExecutedCommand(const CommandDMA* cmd, const int& cluster);
 
     void print(QString& output) override;
@@ -52,7 +53,12 @@ class StatisticDma : public StatisticBase {
 
     void reset() override;
 
+    void saveCheckpoint(QDataStream& out) const override;
+    void restoreCheckpoint(QDataStream& in) override;
+
    private:
+    const uint32_t clusters;  // runtime geometry (HWConfig)
+
     unsigned long totalDMAActive = 0;
     unsigned long totalDMAInActive = 0;
     unsigned long anyDMAActive = 0;
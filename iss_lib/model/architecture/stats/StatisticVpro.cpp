@@ -14,108 +14,121 @@
 
 #include "StatisticVpro.h"
 #include "../../../simulator/ISS.h"
+#include "../../../simulator/helper/checkpoint.h"
 #include "../../../simulator/helper/debugHelper.h"
 
 #include "JSONHelpers.h"
 
-StatisticVpro::StatisticVpro(ISS* core) : StatisticBase(core) {
-    typeCount = std::vector<std::map<CommandVPRO::TYPE, double[2]>>(VPRO_CFG::LANES + 1);
+VproLaneCounters& VproLaneCounters::operator+=(const VproLaneCounters& other) {
+    for (int t = 0; t < CommandVPRO::enumTypeEnd; t++) {
+        instructions[t] += other.instructions[t];
+        cycles[t] += other.cycles[t];
+    }
+    active += other.active;
+    src_stall += other.src_stall;
+    dst_stall += other.dst_stall;
+    inactive += other.inactive;
+    blocking += other.blocking;
+    return *this;
 }
 
-void StatisticVpro::tick() {
-    StatisticBase::tick();
-
-    bool L0active = false;
-    bool L1active = false;
-    bool LSactive = false;
-
-    for (auto cluster : core->getClusters()) {
-        for (auto unit : cluster->getUnits()) {
-            auto lane0 = unit->getLanes()[0];
-            if (lane0->isBusy()) {
-                L0active = true;
-                if (lane0->is_src_lane_stalling()) {
-                    totalL0LanesSrcStall++;
-                } else if (lane0->is_dst_lane_stalling()) {
-                    totalL0LanesDstStall++;
-                } else {
-                    totalL0LanesActive++;
-                }
-                if (lane0->isBlocking()) {
-                    totalLSLanesBlocking++;
-                }
-            } else {
-                totalL0LanesInActive++;
+StatisticVpro::StatisticVpro(ISS* core)
+    : StatisticBase(core),
+      clusters(int(core->getHWConfig().clusters)),
+      units(int(core->getHWConfig().units)),
+      lanes(int(core->getHWConfig().lanes) + 1),
+      anyLaneActive(lanes),
+      laneActive(lanes) {
+    laneCounters.resize(size_t(clusters) * units * lanes);
+    auto& cluster_list = core->getClusters();
+    for (size_t c = 0; c < cluster_list.size(); c++) {
+        auto& unit_list = cluster_list[c]->getUnits();
+        for (size_t u = 0; u < unit_list.size(); u++) {
+            auto& lane_list = unit_list[u]->getLanes();
+            for (size_t l = 0; l < lane_list.size(); l++) {
+                lane_list[l]->setStatCounters(&counters(int(c), int(u), int(l)));
             }
+        }
+    }
+}
 
-            auto lane1 = unit->getLanes()[1];
-            if (lane1->isBusy()) {
-                L1active = true;
-                if (lane1->is_src_lane_stalling()) {
-                    totalL1LanesSrcStall++;
-                } else if (lane1->is_dst_lane_stalling()) {
-                    totalL1LanesDstStall++;
-                } else {
-                    totalL1LanesActive++;
-                }
-                if (lane1->isBlocking()) {
-                    totalLSLanesBlocking++;
-                }
-            } else {
-                totalL1LanesInActive++;
-            }
+void StatisticVpro::tick() {
+    StatisticBase::tick();
 
-            auto& lanels = unit->getLSLane();
-            if (lanels.isBusy()) {
-                LSactive = true;
-                if (lanels.is_src_lane_stalling()) {
-                    totalLSLanesSrcStall++;
-                } else if (lanels.is_dst_lane_stalling()) {
-                    totalLSLanesDstStall++;
+    std::fill(laneActive.begin(), laneActive.end(), 0);
+
+    auto& cluster_list = core->getClusters();
+    for (size_t c = 0; c < cluster_list.size(); c++) {
+        auto& unit_list = cluster_list[c]->getUnits();
+        for (size_t u = 0; u < unit_list.size(); u++) {
+            auto& lane_list = unit_list[u]->getLanes();
+            for (size_t l = 0; l < lane_list.size(); l++) {
+                auto& lane = *lane_list[l];
+                auto& count = counters(int(c), int(u), int(l));
+                if (lane.isBusy()) {
+                    laneActive[l] = 1;
+                    if (lane.is_src_lane_stalling()) {
+                        count.src_stall++;
+                    } else if (lane.is_dst_lane_stalling()) {
+                        count.dst_stall++;
+                    } else {
+                        count.active++;
+                    }
+                    if (lane.isBlocking()) {
+                        count.blocking++;
+                    }
                 } else {
-                    totalLSLanesActive++;
-                }
-                if (lanels.isBlocking()) {
-                    totalLSLanesBlocking++;
+                    count.inactive++;
                 }
-            } else {
-                totalLSLanesInActive++;
             }
-            //            }
         }
     }
 
-    if (L0active) anyL0LaneActive++;
-    if (L1active) anyL1LaneActive++;
-    if (LSactive) anyLSLaneActive++;
+    for (int l = 0; l < lanes; l++) {
+        if (laneActive[l]) anyLaneActive[l]++;
+    }
 }
 
-double StatisticVpro::getCyclesNotNONE(int lane) {
-    double sum = 0;
-    for (auto& it : typeCount[lane]) {
-        sum += it.second[1];
+void StatisticVpro::tickIdle(uint64_t ticks) {
+    StatisticBase::tickIdle(ticks);
+
+    for (auto& count : laneCounters) {
+        count.inactive += ticks;
     }
-    sum -= getCyclesNONE(lane);
-    return sum;
 }
 
-double StatisticVpro::getCyclesNONE(int lane) {
-    if (typeCount[lane].find(CommandVPRO::NONE) == typeCount[lane].end()) return 0;
-    return typeCount[lane][CommandVPRO::NONE][1];
+VproLaneCounters StatisticVpro::laneSum(int lane) {
+    VproLaneCounters sum;
+    for (int c = 0; c < clusters; c++) {
+        for (int u = 0; u < units; u++) {
+            sum += counters(c, u, lane);
+        }
+    }
+    return sum;
 }
 
-void StatisticVpro::addExecutedCmdQueue(CommandVPRO* cmd, int vector_lane_id) {
-    typeCount[vector_lane_id][cmd->type][0]++;
+VproLaneCounters StatisticVpro::unitSum(int cluster, int unit) {
+    VproLaneCounters sum;
+    for (int l = 0; l < lanes; l++) {
+        sum += counters(cluster, unit, l);
+    }
+    return sum;
 }
 
-void StatisticVpro::addExecutedCmdTick(CommandVPRO* cmd, int vector_lane_id) {
-    typeCount[vector_lane_id][cmd->type][1]++;
+QString StatisticVpro::laneName(int lane) const {
+    if (lane == lanes - 1) return "LS";
+    return "L" + QString::number(lane);
 }
 
 void StatisticVpro::print(QString& output) {
-    uint32_t parallelUnits = VPRO_CFG::UNITS * VPRO_CFG::CLUSTERS;
+    uint32_t parallelUnits = units * clusters;
     unsigned long LaneTotal = total_ticks * parallelUnits;
 
+    std::vector<VproLaneCounters> sums;
+    for (int lane = 0; lane < lanes; lane++) {
+        sums.push_back(laneSum(lane));
+    }
+
     QTextStream out(&output);
     out.setRealNumberNotation(QTextStream::FixedNotation);
     out.setRealNumberPrecision(2);
@@ -132,31 +145,26 @@ void StatisticVpro::print(QString& output) {
     out.setRealNumberNotation(QTextStream::FixedNotation);
     out.setRealNumberPrecision(2);
     out.setFieldWidth(5);
+    auto laneLabel = [this](int lane) {
+        return (lane == lanes - 1 ? QString("LS:") : QString::number(lane) + ":")
+            .leftJustified(4);
+    };
     // !busy + active + src stall + dst stall = 100 %
-    if (100 * (double)(totalL0LanesActive + totalL0LanesSrcStall + totalL0LanesDstStall) /
-                (anyL0LaneActive * parallelUnits) <
-            99 ||
-        100 * (double)(totalL1LanesActive + totalL1LanesSrcStall + totalL1LanesDstStall) /
-                (anyL1LaneActive * parallelUnits) <
-            99 ||
-        100 * (double)(totalLSLanesActive + totalLSLanesSrcStall + totalLSLanesDstStall) /
-                (anyLSLaneActive * parallelUnits) <
-            99) {
+    std::vector<double> parallel_utilization;
+    bool underutilized = false;
+    for (int lane = 0; lane < lanes; lane++) {
+        auto& sum = sums[lane];
+        parallel_utilization.push_back(100 * (double)(sum.active + sum.src_stall + sum.dst_stall) /
+                                       (anyLaneActive[lane] * parallelUnits));
+        if (parallel_utilization.back() < 99) underutilized = true;
+    }
+    if (underutilized) {
         out << "  [Parallel Architecture utilization] (lane<x> active cycles of max. possible "
                "active cycles [over all units/clusters]):"
             << RESET_COLOR << "\n";
-        out << "      Lane 0:  " << ORANGE
-            << 100 * (double)(totalL0LanesActive + totalL0LanesSrcStall + totalL0LanesDstStall) /
-                   (anyL0LaneActive * parallelUnits)
-            << "%" << RESET_COLOR << " (should be @ 100%!)\n";
-        out << "      Lane 1:  " << ORANGE
-            << 100 * (double)(totalL1LanesActive + totalL1LanesSrcStall + totalL1LanesDstStall) /
-                   (anyL1LaneActive * parallelUnits)
-            << "%" << RESET_COLOR << " (should be @ 100%!)\n";
-        out << "      Lane LS: " << ORANGE
-            << 100 * (double)(totalLSLanesActive + totalLSLanesSrcStall + totalLSLanesDstStall) /
-                   (anyLSLaneActive * parallelUnits)
-            << "%" << RESET_COLOR << " (should be @ 100%!)\n";
+        for (int lane = 0; lane < lanes; lane++) {
+            out << "      Lane " + laneLabel(lane) << ORANGE << parallel_utilization[lane] << "%" << RESET_COLOR << " (should be @ 100%!)\n";
+        }
         out << LIGHT << "      Possible Reason: Cluster / Unit Mask is set" << RESET_COLOR
             << "\n\n";
     } else {
@@ -166,15 +174,12 @@ void StatisticVpro::print(QString& output) {
     out << "\n  [Algorithm utilization] (active cycles of total cycles, average on all "
            "corresponding lanes, higher is better):"
         << RESET_COLOR << "\n";
-    out << "      Lane 0:  " << 100 * (double)totalL0LanesActive / LaneTotal
-        << " % ,dst stall: " << 100 * (double)totalL0LanesDstStall / LaneTotal
-        << " %, src stall: " << 100 * (double)totalL0LanesSrcStall / LaneTotal << "%      \n";
-    out << "      Lane 1:  " << 100 * (double)totalL1LanesActive / LaneTotal
-        << " % ,dst stall: " << 100 * (double)totalL1LanesDstStall / LaneTotal
-        << " %, src stall: " << 100 * (double)totalL1LanesSrcStall / LaneTotal << "%      \n";
-    out << "      Lane LS: " << 100 * (double)totalLSLanesActive / LaneTotal
-        << " % ,dst stall: " << 100 * (double)totalLSLanesDstStall / LaneTotal
-        << " %, src stall: " << 100 * (double)totalLSLanesSrcStall / LaneTotal << "%      \n";
+    for (int lane = 0; lane < lanes; lane++) {
+        auto& sum = sums[lane];
+        out << "      Lane " + laneLabel(lane) << 100 * (double)sum.active / LaneTotal
+            << " % ,dst stall: " << 100 * (double)sum.dst_stall / LaneTotal
+            << " %, src stall: " << 100 * (double)sum.src_stall / LaneTotal << "%      \n";
+    }
     out << LIGHT
         << "        A Lane counts as active if its pipeline has a command in any stage which is "
            "not NONE"
@@ -184,49 +189,34 @@ void StatisticVpro::print(QString& output) {
     out.setFieldAlignment(QTextStream::AlignRight);
     out.setFieldWidth(16);
     out.setRealNumberPrecision(0);
-    for (int lane = 0; lane < VPRO_CFG::LANES + 1; lane++) {
-        QString prefix;
-        switch (lane) {
-            case 0:
-                prefix = "      L0 ";
-                break;
-            case 1:
-                prefix = "      L1 ";
-                break;
-            case 2:
-                prefix = "      LS ";
-                break;
-            default:
-                prefix = "      [unknown Lane] ";
-        }
-        auto sum = new double[2]();
-        for (auto& it : typeCount[lane]) {
-            sum[0] += it.second[0];
-            sum[1] += it.second[1];
-        }
-
-        for (auto& it : typeCount[lane]) {
-            out << prefix + CommandVPRO::getType(it.first) + "       = ";
-            if (it.first == CommandVPRO::NONE) {
-                out << "                                 " << it.second[1] / parallelUnits
-                    << " clock cycles \n";
+    for (int lane = 0; lane < lanes; lane++) {
+        QString prefix = "      " + laneName(lane) + " ";
+        auto& count = sums[lane];
+        double sum[2]{};
+
+        for (int t = 0; t < CommandVPRO::enumTypeEnd; t++) {
+            if (count.instructions[t] == 0 && count.cycles[t] == 0) continue;
+            sum[0] += count.instructions[t];
+            sum[1] += count.cycles[t];
+            auto type = CommandVPRO::TYPE(t);
+            out << prefix + CommandVPRO::getType(type) + "       = ";
+            if (type == CommandVPRO::NONE) {
+                out << "                                 "
+                    << double(count.cycles[t]) / parallelUnits << " clock cycles \n";
             } else {
-                out << it.second[0] / parallelUnits << " Instructions,  "
-                    << it.second[1] / parallelUnits << " clock cycles\n";
+                out << double(count.instructions[t]) / parallelUnits << " Instructions,  "
+                    << double(count.cycles[t]) / parallelUnits << " clock cycles\n";
             }
         }
-        //        out << "%s Sum                = %10.0lf (%10.0lf clock cycles)\n", prefix.c_str(), sum[0]/parallelUnits, sum[1]/parallelUnits);
-        if (typeCount[lane].find(CommandVPRO::NONE) != typeCount[lane].end()) {
-            sum[0] -= typeCount[lane][CommandVPRO::NONE][0];
-            sum[1] -= typeCount[lane][CommandVPRO::NONE][1];
+        if (count.instructions[CommandVPRO::NONE] != 0 || count.cycles[CommandVPRO::NONE] != 0) {
+            sum[0] -= count.instructions[CommandVPRO::NONE];
+            sum[1] -= count.cycles[CommandVPRO::NONE];
             out << prefix + " Sum (not NONE) = " << sum[0] / parallelUnits << " Instructions,  "
                 << sum[1] / parallelUnits << " clock cycles\n";
         }
         out << "      "
                "-----------------------------------------------------------------------------------"
                "-\n";
-
-        delete[] sum;
     }
     out << "\n";
 }
@@ -236,61 +226,31 @@ void StatisticVpro::print_json(QString& output) {
     out << JSON_OBJ_BEGIN;
     out << JSON_FIELD_FLOAT("clock_period", core->getVPROClockPeriod()) << ",";
     out << JSON_FIELD_INT("total_ticks", total_ticks) << ',';
-    for (int lane = 0; lane < VPRO_CFG::LANES + 1; lane++) {
+    for (int lane = 0; lane < lanes; lane++) {
         json_print_lane_stats(out, lane);
-        if (lane != VPRO_CFG::LANES) {
-            out << ",";
-        }
+        out << ",";
     }
+    json_print_cluster_stats(out);
     out << JSON_OBJ_END;
 }
 
 void StatisticVpro::json_print_lane_stats(QTextStream& out, int lane) {
-    QString lane_identifier;
-    uint64_t total_active;
-    uint64_t total_src_stall;
-    uint64_t total_dst_stall;
-    uint64_t any_active;
-    switch (lane) {
-        case 0:
-            lane_identifier = "L0";
-            total_active = totalL0LanesActive;
-            total_src_stall = totalL0LanesSrcStall;
-            total_dst_stall = totalL0LanesDstStall;
-            any_active = anyL0LaneActive;
-            break;
-        case 1:
-            lane_identifier = "L1";
-            total_active = totalL1LanesActive;
-            total_src_stall = totalL1LanesSrcStall;
-            total_dst_stall = totalL1LanesDstStall;
-            any_active = anyL1LaneActive;
-            break;
-        case 2:
-            lane_identifier = "LS";
-            total_active = totalLSLanesActive;
-            total_src_stall = totalLSLanesSrcStall;
-            total_dst_stall = totalLSLanesDstStall;
-            any_active = anyLSLaneActive;
-            break;
-        default:
-            return;
-    }
+    auto sum = laneSum(lane);
 
-    uint64_t count = VPRO_CFG::UNITS * VPRO_CFG::CLUSTERS;
+    uint64_t count = units * clusters;
     uint64_t total_parallel_ticks = total_ticks * count;
 
     double architecture_utilization =
-        (double)(total_active + total_src_stall + total_dst_stall) / (any_active * count);
+        (double)(sum.active + sum.src_stall + sum.dst_stall) / (anyLaneActive[lane] * count);
 
-    double algorithm_utilization = (double)total_active / total_parallel_ticks;
-    double src_stall_ratio = (double)total_src_stall / total_parallel_ticks;
-    double dst_stall_ratio = (double)total_dst_stall / total_parallel_ticks;
+    double algorithm_utilization = (double)sum.active / total_parallel_ticks;
+    double src_stall_ratio = (double)sum.src_stall / total_parallel_ticks;
+    double dst_stall_ratio = (double)sum.dst_stall / total_parallel_ticks;
 
-    out << JSON_FIELD_OBJ(lane_identifier);
-    out << JSON_FIELD_INT("any_active", any_active) << ",";
-    out << JSON_FIELD_INT("src_stall", total_src_stall) << ",";
-    out << JSON_FIELD_INT("dst_stall", total_dst_stall) << ",";
+    out << JSON_FIELD_OBJ(laneName(lane));
+    out << JSON_FIELD_INT("any_active", anyLaneActive[lane]) << ",";
+    out << JSON_FIELD_INT("src_stall", sum.src_stall) << ",";
+    out << JSON_FIELD_INT("dst_stall", sum.dst_stall) << ",";
 
     out << JSON_FIELD_FLOAT("architecture_utilization", architecture_utilization) << ",";
     out << JSON_FIELD_FLOAT("algorithm_utilization", algorithm_utilization) << ",";
@@ -301,20 +261,22 @@ void StatisticVpro::json_print_lane_stats(QTextStream& out, int lane) {
 }
 
 void StatisticVpro::json_print_lane_instruction_stats(QTextStream& out, int lane) {
-    uint64_t count = VPRO_CFG::UNITS * VPRO_CFG::CLUSTERS;
+    auto sum = laneSum(lane);
+    uint64_t count = units * clusters;
 
     uint64_t total_instructions = 0;
     uint64_t total_instruction_cycles = 0;
-    for (auto& it : typeCount[lane]) {
-        total_instructions += (uint64_t)it.second[0];
-        total_instruction_cycles += (uint64_t)it.second[1];
+    for (int t = 0; t < CommandVPRO::enumTypeEnd; t++) {
+        total_instructions += sum.instructions[t];
+        total_instruction_cycles += sum.cycles[t];
     }
 
     out << JSON_FIELD_OBJ("instructions");
-    for (auto& it : typeCount[lane]) {
-        out << JSON_FIELD_OBJ(CommandVPRO::getType(it.first).trimmed());
-        out << JSON_FIELD_INT("instructions", it.second[0] / count) << ",";
-        out << JSON_FIELD_INT("cycles", it.second[1] / count);
+    for (int t = 0; t < CommandVPRO::enumTypeEnd; t++) {
+        if (sum.instructions[t] == 0 && sum.cycles[t] == 0) continue;
+        out << JSON_FIELD_OBJ(CommandVPRO::getType(CommandVPRO::TYPE(t)).trimmed());
+        out << JSON_FIELD_INT("instructions", sum.instructions[t] / count) << ",";
+        out << JSON_FIELD_INT("cycles", sum.cycles[t] / count);
         out << JSON_OBJ_END << ",";
     }
 
@@ -325,41 +287,91 @@ void StatisticVpro::json_print_lane_instruction_stats(QTextStream& out, int lane
 
     out << JSON_FIELD_OBJ("not_none");
     out << JSON_FIELD_INT(
-               "instructions", (total_instructions - typeCount[lane][CommandVPRO::NONE][0]) / count)
+               "instructions", (total_instructions - sum.instructions[CommandVPRO::NONE]) / count)
         << ",";
     out << JSON_FIELD_INT(
-        "cycles", (total_instruction_cycles - typeCount[lane][CommandVPRO::NONE][1]) / count);
+        "cycles", (total_instruction_cycles - sum.cycles[CommandVPRO::NONE]) / count);
     out << JSON_OBJ_END;
     out << JSON_OBJ_END;
 }
 
-void StatisticVpro::reset() {
-    StatisticBase::reset();
+/**
+ * active / stall counters and ratios of a group of lanes (unit / cluster)
+ * @param lane_count number of lanes in sum
+ */
+void StatisticVpro::json_print_utilization(
+    QTextStream& out, const VproLaneCounters& sum, uint64_t lane_count) {
+    uint64_t total_parallel_ticks = total_ticks * lane_count;
 
-    totalL0LanesSrcStall = 0;
-    totalL1LanesSrcStall = 0;
-    totalLSLanesSrcStall = 0;
+    uint64_t instructions = 0;
+    for (int t = 0; t < CommandVPRO::enumTypeEnd; t++) {
+        if (t != CommandVPRO::NONE) instructions += sum.instructions[t];
+    }
 
-    totalL0LanesDstStall = 0;
-    totalL1LanesDstStall = 0;
-    totalLSLanesDstStall = 0;
+    out << JSON_FIELD_INT("active", sum.active) << ",";
+    out << JSON_FIELD_INT("src_stall", sum.src_stall) << ",";
+    out << JSON_FIELD_INT("dst_stall", sum.dst_stall) << ",";
+    out << JSON_FIELD_INT("inactive", sum.inactive) << ",";
+    out << JSON_FIELD_INT("instructions", instructions) << ",";
+    out << JSON_FIELD_FLOAT("algorithm_utilization", (double)sum.active / total_parallel_ticks)
+        << ",";
+    out << JSON_FIELD_FLOAT("busy_ratio",
+               (double)(sum.active + sum.src_stall + sum.dst_stall) / total_parallel_ticks)
+        << ",";
+    out << JSON_FIELD_FLOAT("src_stall_ratio", (double)sum.src_stall / total_parallel_ticks)
+        << ",";
+    out << JSON_FIELD_FLOAT("dst_stall_ratio", (double)sum.dst_stall / total_parallel_ticks);
+}
 
-    totalL0LanesActive = 0;
-    totalL1LanesActive = 0;
-    totalLSLanesActive = 0;
+/**
+ * "clusters": [{..., "units": [{...}, ...]}, ...] -> utilization of each cluster and unit (all lanes)
+ */
+void StatisticVpro::json_print_cluster_stats(QTextStream& out) {
+    out << JSON_ID("clusters") << JSON_ARRAY_BEGIN;
+    for (int c = 0; c < clusters; c++) {
+        std::vector<VproLaneCounters> unit_sums;
+        VproLaneCounters cluster_sum;
+        for (int u = 0; u < units; u++) {
+            unit_sums.push_back(unitSum(c, u));
+            cluster_sum += unit_sums.back();
+        }
+
+        out << JSON_OBJ_BEGIN;
+        out << JSON_FIELD_INT("id", c) << ",";
+        json_print_utilization(out, cluster_sum, units * lanes);
+        out << "," << JSON_ID("units") << JSON_ARRAY_BEGIN;
+        for (int u = 0; u < units; u++) {
+            out << JSON_OBJ_BEGIN;
+            out << JSON_FIELD_INT("id", u) << ",";
+            json_print_utilization(out, unit_sums[u], lanes);
+            out << JSON_OBJ_END;
+            if (u != units - 1) out << ",";
+        }
+        out << JSON_ARRAY_END;
+        out << JSON_OBJ_END;
+        if (c != clusters - 1) out << ",";
+    }
+    out << JSON_ARRAY_END;
+}
 
-    totalL0LanesInActive = 0;
-    totalL1LanesInActive = 0;
-    totalLSLanesInActive = 0;
+void StatisticVpro::reset() {
+    StatisticBase::reset();
 
-    anyL0LaneActive = 0;
-    anyL1LaneActive = 0;
-    anyLSLaneActive = 0;
+    // in place, the lanes hold pointers to their counters
+    for (auto& count : laneCounters) {
+        count = VproLaneCounters();
+    }
+    std::fill(anyLaneActive.begin(), anyLaneActive.end(), 0);
+}
 
-    totalL0LanesBlocking = 0;
-    totalL1LanesBlocking = 0;
-    totalLSLanesBlocking = 0;
+void StatisticVpro::saveCheckpoint(QDataStream& out) const {
+    StatisticBase::saveCheckpoint(out);
+    Checkpoint::writeArray(out, anyLaneActive.data(), anyLaneActive.size());
+    Checkpoint::writeArray(out, laneCounters.data(), laneCounters.size());
+}
 
-    typeCount.clear();
-    typeCount = std::vector<std::map<CommandVPRO::TYPE, double[2]>>(VPRO_CFG::LANES + 1);
+void StatisticVpro::restoreCheckpoint(QDataStream& in) {
+    StatisticBase::restoreCheckpoint(in);
+    Checkpoint::readArray(in, anyLaneActive.data(), anyLaneActive.size());
+    Checkpoint::readArray(in, laneCounters.data(), laneCounters.size());
 }
@@ -15,59 +15,76 @@
 #ifndef CONV2DADD_STATISTICVPRO_H
 #define CONV2DADD_STATISTICVPRO_H
 
-#include <map>
+#include <vector>
 #include "../../commands/CommandVPRO.h"
 #include "StatisticBase.h"
+#include "vpro/vpro_globals.h"
 
 #include <QTextStream>
 
-class StatisticVpro : public StatisticBase {
-   private:
-    unsigned long totalL0LanesSrcStall = 0;
-    unsigned long totalL1LanesSrcStall = 0;
-    unsigned long totalLSLanesSrcStall = 0;
-
-    unsigned long totalL0LanesDstStall = 0;
-    unsigned long totalL1LanesDstStall = 0;
-    unsigned long totalLSLanesDstStall = 0;
+/**
+ * statistic counters of a single lane, incremented by the lane itself (VectorLane::setStatCounters)
+ * -> no lookup on the hot path, only written by the thread of the lanes cluster
+ */
+struct alignas(64) VproLaneCounters {
+    uint64_t instructions[CommandVPRO::enumTypeEnd]{};  // processed commands (queue)
+    uint64_t cycles[CommandVPRO::enumTypeEnd]{};        // clock ticks per command type
+
+    // StatisticVpro::tick
+    uint64_t active{};
+    uint64_t src_stall{};
+    uint64_t dst_stall{};
+    uint64_t inactive{};
+    uint64_t blocking{};
+
+    VproLaneCounters& operator+=(const VproLaneCounters& other);
+};
 
-    unsigned long totalL0LanesActive = 0;
-    unsigned long totalL1LanesActive = 0;
-    unsigned long totalLSLanesActive = 0;
+class StatisticVpro final : public StatisticBase {
+   private:
+    // flat [cluster][unit][lane] (incl. LS lane), allocated once -> lanes keep their pointers
+    std::vector<VproLaneCounters> laneCounters;
 
-    unsigned long totalL0LanesInActive = 0;
-    unsigned long totalL1LanesInActive = 0;
-    unsigned long totalLSLanesInActive = 0;
+    // runtime geometry (HWConfig), lanes incl. LS lane
+    const int clusters, units, lanes;
 
-    unsigned long anyL0LaneActive = 0;
-    unsigned long anyL1LaneActive = 0;
-    unsigned long anyLSLaneActive = 0;
+    std::vector<uint64_t> anyLaneActive;
+    std::vector<uint8_t> laneActive;  // tick(), any lane of this index busy
 
-    // isBlocking
-    unsigned long totalL0LanesBlocking = 0;
-    unsigned long totalL1LanesBlocking = 0;
-    unsigned long totalLSLanesBlocking = 0;  // never?
+    VproLaneCounters& counters(int cluster, int unit, int lane) {
+        return laneCounters[(size_t(cluster) * units + unit) * lanes + lane];
+    }
 
-    std::vector<std::map<CommandVPRO::TYPE, double[2]>> typeCount;  // queue + clockticks
+    // sum of all lanes with this index (over all units/clusters)
+    VproLaneCounters laneSum(int lane);
+    // sum of all lanes of a unit
+    VproLaneCounters unitSum(int cluster, int unit);
 
-    double getCyclesNotNONE(int lane);
-    double getCyclesNONE(int lane);
+    QString laneName(int lane) const;
 
     void json_print_lane_stats(QTextStream& out, int lane);
     void json_print_lane_instruction_stats(QTextStream& out, int lane);
+    void json_print_utilization(QTextStream& out, const VproLaneCounters& sum, uint64_t lane_count);
+    void json_print_cluster_stats(QTextStream& out);
 
    public:
     explicit StatisticVpro(ISS* core);
 
     void tick() override;
-
-    void addExecutedCmdTick(CommandVPRO* cmd, int vector_lane_id);
-    void addExecutedCmdQueue(CommandVPRO* cmd, int vector_lane_id);
+    void tickIdle(uint64_t ticks) override;
 
     void print(QString& output) override;
     void print_json(QString& output) override;
 
     void reset() override;
+
+    // flat [cluster][unit][lane] (e.g. digest of the simulation result)
+    const std::vector<VproLaneCounters>& getLaneCounters() const {
+        return laneCounters;
+    }
+
+    void saveCheckpoint(QDataStream& out) const override;
+    void restoreCheckpoint(QDataStream& in) override;
 };
 
 #endif  //CONV2DADD_STATISTICVPRO_H
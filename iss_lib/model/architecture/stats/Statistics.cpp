@@ -21,6 +21,7 @@
 
 #include "JSONHelpers.h"
 
+// the type of each clock domains statistic is fixed here (static_cast on dispatch)
 void Statistics::initialize(ISS* c) {
     core = c;
     stats[AXI] = new StatisticAxi(c);
@@ -37,25 +38,52 @@ void Statistics::initialize(ISS* c) {
 void Statistics::tick(clock_domains clock) {
     switch (clock) {
         case AXI:
-            dynamic_cast<StatisticAxi*>(stats[clock])->tick();
+            static_cast<StatisticAxi*>(stats[clock])->tick();
             break;
         case DCMA:
-            dynamic_cast<StatisticDcma*>(stats[clock])->tick();
+            static_cast<StatisticDcma*>(stats[clock])->tick();
             break;
         case DMA:
-            dynamic_cast<StatisticDma*>(stats[clock])->tick();
+            static_cast<StatisticDma*>(stats[clock])->tick();
             break;
         case VPRO:
-            dynamic_cast<StatisticVpro*>(stats[clock])->tick();
+            static_cast<StatisticVpro*>(stats[clock])->tick();
             break;
         case RISC:
-            dynamic_cast<StatisticRisc*>(stats[clock])->tick();
+            static_cast<StatisticRisc*>(stats[clock])->tick();
             break;
         default:
             stats[clock]->tick();
     }
 }
 
+/**
+ * process multiple ticks of an idle system (ISS skipped these ticks) in given clock domain
+ * @param clock domain
+ * @param ticks number of skipped ticks
+ */
+void Statistics::tickIdle(clock_domains clock, uint64_t ticks) {
+    switch (clock) {
+        case AXI:
+            static_cast<StatisticAxi*>(stats[clock])->tickIdle(ticks);
+            break;
+        case DCMA:
+            static_cast<StatisticDcma*>(stats[clock])->tickIdle(ticks);
+            break;
+        case DMA:
+            static_cast<StatisticDma*>(stats[clock])->tickIdle(ticks);
+            break;
+        case VPRO:
+            static_cast<StatisticVpro*>(stats[clock])->tickIdle(ticks);
+            break;
+        case RISC:
+            static_cast<StatisticRisc*>(stats[clock])->tickIdle(ticks);
+            break;
+        default:
+            stats[clock]->tickIdle(ticks);
+    }
+}
+
 void Statistics::print() {
     QString output;
     print(output);
@@ -71,19 +99,19 @@ void Statistics::print(QString& output) {
 inline void Statistics::print(clock_domains clock, QString& output) {
     switch (clock) {
         case AXI:
-            dynamic_cast<StatisticAxi*>(stats[clock])->print(output);
+            static_cast<StatisticAxi*>(stats[clock])->print(output);
             break;
         case DCMA:
-            dynamic_cast<StatisticDcma*>(stats[clock])->print(output);
+            static_cast<StatisticDcma*>(stats[clock])->print(output);
             break;
         case DMA:
-            dynamic_cast<StatisticDma*>(stats[clock])->print(output);
+            static_cast<StatisticDma*>(stats[clock])->print(output);
             break;
         case VPRO:
-            dynamic_cast<StatisticVpro*>(stats[clock])->print(output);
+            static_cast<StatisticVpro*>(stats[clock])->print(output);
             break;
         case RISC:
-            dynamic_cast<StatisticRisc*>(stats[clock])->print(output);
+            static_cast<StatisticRisc*>(stats[clock])->print(output);
             break;
         default:
             stats[clock]->print(output);
@@ -113,23 +141,23 @@ void Statistics::print_json(clock_domains clock, QString& output) {
     switch (clock) {
         case AXI:
             out << JSON_ID("axi");
-            dynamic_cast<StatisticAxi*>(stats[clock])->print_json(output);
+            static_cast<StatisticAxi*>(stats[clock])->print_json(output);
             break;
         case DCMA:
             out << JSON_ID("dcma");
-            dynamic_cast<StatisticDcma*>(stats[clock])->print_json(output);
+            static_cast<StatisticDcma*>(stats[clock])->print_json(output);
             break;
         case DMA:
             out << JSON_ID("dma");
-            dynamic_cast<StatisticDma*>(stats[clock])->print_json(output);
+            static_cast<StatisticDma*>(stats[clock])->print_json(output);
             break;
         case VPRO:
             out << JSON_ID("vpro");
-            dynamic_cast<StatisticVpro*>(stats[clock])->print_json(output);
+            static_cast<StatisticVpro*>(stats[clock])->print_json(output);
             break;
         case RISC:
             out << JSON_ID("risc");
-            dynamic_cast<StatisticRisc*>(stats[clock])->print_json(output);
+            static_cast<StatisticRisc*>(stats[clock])->print_json(output);
             break;
         default:
             stats[clock]->print(output);
@@ -178,21 +206,33 @@ void Statistics::reset() {
 void Statistics::reset(Statistics::clock_domains clock) {
     switch (clock) {
         case AXI:
-            dynamic_cast<StatisticAxi*>(stats[clock])->reset();
+            static_cast<StatisticAxi*>(stats[clock])->reset();
             break;
         case DCMA:
-            dynamic_cast<StatisticDcma*>(stats[clock])->reset();
+            static_cast<StatisticDcma*>(stats[clock])->reset();
             break;
         case DMA:
-            dynamic_cast<StatisticDma*>(stats[clock])->reset();
+            static_cast<StatisticDma*>(stats[clock])->reset();
             break;
         case VPRO:
-            dynamic_cast<StatisticVpro*>(stats[clock])->reset();
+            static_cast<StatisticVpro*>(stats[clock])->reset();
             break;
         case RISC:
-            dynamic_cast<StatisticRisc*>(stats[clock])->reset();
+            static_cast<StatisticRisc*>(stats[clock])->reset();
             break;
         default:
             stats[clock]->reset();
     }
 }
+
+void Statistics::saveCheckpoint(QDataStream& out) const {
+    for (auto stat : stats) {
+        stat->saveCheckpoint(out);
+    }
+}
+
+void Statistics::restoreCheckpoint(QDataStream& in) {
+    for (auto stat : stats) {
+        stat->restoreCheckpoint(in);
+    }
+}
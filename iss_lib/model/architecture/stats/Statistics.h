@@ -51,18 +51,19 @@ class Statistics {
     void operator=(Statistics const&) = delete;
 
     StatisticDcma* getDCMAStat() {
-        return dynamic_cast<StatisticDcma*>(stats[clock_domains::DCMA]);
+        return static_cast<StatisticDcma*>(stats[clock_domains::DCMA]);
     }
 
     StatisticVpro* getVPROStat() {
-        return dynamic_cast<StatisticVpro*>(stats[clock_domains::VPRO]);
+        return static_cast<StatisticVpro*>(stats[clock_domains::VPRO]);
     }
 
     StatisticDma* getDMAStat() {
-        return dynamic_cast<StatisticDma*>(stats[clock_domains::DMA]);
+        return static_cast<StatisticDma*>(stats[clock_domains::DMA]);
     }
 
     void tick(clock_domains clock);
+    void tickIdle(clock_domains clock, uint64_t ticks);
 
     void print();
     void print(QString& output);
@@ -78,6 +79,10 @@ class Statistics {
     void reset();
     void reset(clock_domains clock);
 
+    // simulator checkpoint of all clock domains
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
    private:
     StatisticBase* stats[clock_domains::end];
     ISS* core;
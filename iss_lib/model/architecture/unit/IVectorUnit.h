@@ -34,6 +34,14 @@ class IVectorUnit {
     virtual void tick() = 0;
     virtual void update() = 0;
     [[nodiscard]] virtual bool isBusy() = 0;
+    [[nodiscard]] virtual bool isIdle() = 0;
+    virtual void tickIdle(uint64_t ticks) = 0;
+    virtual void setFunctional(bool enable) = 0;
+    virtual bool tickFunctional() = 0;
+
+    // simulator checkpoint (local memory and lanes of an idle unit)
+    virtual void saveCheckpoint(QDataStream& out) const = 0;
+    virtual void restoreCheckpoint(QDataStream& in) = 0;
 
     // Command Queue interface
     [[nodiscard]] virtual bool isCmdQueueFull() = 0;
@@ -23,6 +23,7 @@
 #include <vector>
 using std::vector;
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
 using std::get;
@@ -30,42 +31,56 @@ using std::get;
 #include "../../../core_wrapper.h"
 #include "../../../simulator/ISS.h"
 #include "../../../simulator/helper/debugHelper.h"
+#include "../../../simulator/helper/timeline.h"
 #include "../../../simulator/helper/typeConversion.h"
 
 namespace Unit {
 
-bool chains_from_src(CommandVPRO cmd, uint32_t src_sel) {
+bool chains_from_src(const CommandVPRO& cmd, uint32_t src_sel) {
     return (cmd.src1.sel == src_sel || cmd.src2.sel == src_sel || cmd.dst.sel == src_sel);
 }
 
 void update_offsets(
-    VectorLane& vl, std::shared_ptr<CommandVPRO> cmd, uint32_t src_sel, VectorLane& chaining_src) {
+    VectorLane& vl, PipelineDate& pipe, uint32_t src_sel, VectorLane& chaining_src) {
     if (src_sel != SRC_SEL_INDIRECT_LEFT && src_sel != SRC_SEL_INDIRECT_RIGHT &&
         src_sel != SRC_SEL_INDIRECT_LS) {
         return;  // no indirect addressing, don't update offsets
     }
-    if (chains_from_src(*cmd, src_sel)) {
+    if (chains_from_src(*pipe.cmd, src_sel)) {
         uint32_t offset =
-            get<0>(chaining_src.fifo.pop());  // read from FIFO of left neighboring lane
+            get<0>(chaining_src.popChain());  // read from FIFO of left neighboring lane
         offset = *__32to10(offset);
-        cmd->src1.offset = (cmd->src1.sel == src_sel) ? offset : cmd->src1.offset;
-        cmd->src2.offset = (cmd->src2.sel == src_sel) ? offset : cmd->src2.offset;
-        cmd->dst.offset = (cmd->dst.sel == src_sel) ? offset : cmd->dst.offset;
+        pipe.src1_offset = (pipe.cmd->src1.sel == src_sel) ? offset : pipe.src1_offset;
+        pipe.src2_offset = (pipe.cmd->src2.sel == src_sel) ? offset : pipe.src2_offset;
+        pipe.dst_offset = (pipe.cmd->dst.sel == src_sel) ? offset : pipe.dst_offset;
     }
 }
 
 PipeObject::PipeObject(int size, int pipelineALUDepth)
     : accu(0),
+      pipelineALUDepth(pipelineALUDepth),
       data(vector<PipelineDate>(size)),
-      pipelineALUDepth(pipelineALUDepth)
-
-{}
+      ring_size(std::min(5 + pipelineALUDepth + 2, size)),
+      descriptors(vector<CommandVPRO>(size + 1)),
+      descriptor_refs(size + 1, 0) {
+    for (auto& pipe : data) {
+        pipe.cmd = &none_descriptor;
+    }
+}
 
 const PipelineDate& PipeObject::operator[](int index) const {
+    if (index < ring_size) {
+        index += ring_head;
+        if (index >= ring_size) index -= ring_size;
+    }
     return data[index];
 }
 
 PipelineDate& PipeObject::operator[](int index) {
+    if (index < ring_size) {
+        index += ring_head;
+        if (index >= ring_size) index -= ring_size;
+    }
     return data[index];
 }
 
@@ -77,179 +92,190 @@ void PipeObject::resetMinMax(uint32_t value) {
     minmax_value = value;
 }
 
+/**
+ * clock tick to process lanes command/pipeline
+ */
 void PipeObject::tick_pipeline(VectorLane& vl, int from, int until) {
     for (int stage = from; stage <= until; stage++) {
-        // Addressing Units (Stage 0..3) for address calc
-        // Local Memory Address Computation, base address (stage 3),
-        // Chaining Write Enable (stage 4)
-        // ALU Input Operands (stage 4) e.g. chain, imm
-        // ALU Input Operands (stage 5) (assign to alu) e.g., src1_rdata
-        // Local Memory Interface (stage 5) e.g. is_load/store, addr, wdata
-        // ALU (stages 5..8)
-        // Condition Check (stage 6) e.g., z_v, n_v
-        // Data Write-Back Buffer (stage 8) e.g., rf_write_data <= lm_data/alu_result  chain_data_o <= alu_result
-        // Chaining Output (stage 9)
-        //        chain_sync_o <= enable(4) and (not enable(5)) and cmd_reg_pipe(4)(cmd_is_chain_c); -- 3 cycles latency between sync and actual data!!
-        // Register File (read: stage 3..5; write: stage 9)
-
-        PipelineDate& pipe = data[stage];
+        PipelineDate& pipe = (*this)[stage];
         if (pipe.cmd->type == CommandVPRO::NONE) continue;
+        tick_stage(vl, pipe, stage);
+        if (Timeline::enabled && stage == 5 + pipelineALUDepth + 1 && pipe.x == pipe.cmd->x_end &&
+            pipe.y == pipe.cmd->y_end && pipe.z == pipe.cmd->z_end)
+            vl.timelineWriteback();
+    }
+}
 
-        if (stage == 0) {  // calc addresses
-            // result address in rf for regular instructions
-            pipe.rf_addr = pipe.cmd->dst.alpha * pipe.cmd->x + pipe.cmd->dst.beta * pipe.cmd->y +
-                           pipe.cmd->dst.gamma * pipe.cmd->z;
-        } else if (stage == 3) {  // indirect addressing (chained offsets)
-
-            check_indirect_addressing(pipe.cmd);
-            update_offsets(vl, pipe.cmd, SRC_SEL_INDIRECT_LS, vl.getLSLane());
-            update_offsets(vl, pipe.cmd, SRC_SEL_INDIRECT_LEFT, vl.getLeftNeighbor());
-            update_offsets(vl, pipe.cmd, SRC_SEL_INDIRECT_RIGHT, vl.getRightNeighbor());
-
-            // add offset to destination address
-            pipe.rf_addr += pipe.cmd->dst.offset;
-        } else if (stage == 4) {  // read chain input, read rf <?>
-            auto data_a = vl.get_operand(pipe.cmd->src1, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z);
-            auto data_b = vl.get_operand(pipe.cmd->src2, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z);
-            if (pipe.cmd->type == CommandVPRO::MACL || pipe.cmd->type == CommandVPRO::MACH) {
-                // for MAC initialization
-                addr_field_t src1_addr = pipe.cmd->src1;
-                if (vl.architecture_state->MAC_ACCU_INIT_SOURCE == VPRO::MAC_INIT_SOURCE::ADDR) {
-                    src1_addr.sel = SRC_SEL_ADDR;
-                    pipe.opc =
-                        get<0>(vl.get_operand(src1_addr, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z));
-                } else if (vl.architecture_state->MAC_ACCU_INIT_SOURCE ==
-                           VPRO::MAC_INIT_SOURCE::IMM) {
-                    src1_addr.sel = SRC_SEL_IMM;
-                    pipe.opc =
-                        get<0>(vl.get_operand(src1_addr, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z));
-                }
-                // else ZERO (default of opc)
-                pipe.opc = *__24to32signed(pipe.opc);
+void PipeObject::tick_stage(VectorLane& vl, PipelineDate& pipe, int stage) {
+    // Addressing Units (Stage 0..3) for address calc
+    // Local Memory Address Computation, base address (stage 3),
+    // Chaining Write Enable (stage 4)
+    // ALU Input Operands (stage 4) e.g. chain, imm
+    // ALU Input Operands (stage 5) (assign to alu) e.g., src1_rdata
+    // Local Memory Interface (stage 5) e.g. is_load/store, addr, wdata
+    // ALU (stages 5..8)
+    // Condition Check (stage 6) e.g., z_v, n_v
+    // Data Write-Back Buffer (stage 8) e.g., rf_write_data <= lm_data/alu_result  chain_data_o <= alu_result
+    // Chaining Output (stage 9)
+    //        chain_sync_o <= enable(4) and (not enable(5)) and cmd_reg_pipe(4)(cmd_is_chain_c); -- 3 cycles latency between sync and actual data!!
+    // Register File (read: stage 3..5; write: stage 9)
+
+    if (stage == 0) {  // calc addresses
+        // result address in rf for regular instructions
+        pipe.rf_addr = pipe.cmd->dst.alpha * pipe.x + pipe.cmd->dst.beta * pipe.y +
+                       pipe.cmd->dst.gamma * pipe.z;
+    } else if (stage == 3) {  // indirect addressing (chained offsets)
+
+        check_indirect_addressing(*pipe.cmd);
+        update_offsets(vl, pipe, SRC_SEL_INDIRECT_LS, vl.getLSLane());
+        update_offsets(vl, pipe, SRC_SEL_INDIRECT_LEFT, vl.getLeftNeighbor());
+        update_offsets(vl, pipe, SRC_SEL_INDIRECT_RIGHT, vl.getRightNeighbor());
+
+        // add offset to destination address
+        pipe.rf_addr += pipe.dst_offset;
+    } else if (stage == 4) {  // read chain input, read rf <?>
+        auto data_a = vl.get_operand(pipe.getSrc1(), pipe.x, pipe.y, pipe.z);
+        auto data_b = vl.get_operand(pipe.getSrc2(), pipe.x, pipe.y, pipe.z);
+        if (pipe.cmd->type == CommandVPRO::MACL || pipe.cmd->type == CommandVPRO::MACH) {
+            // for MAC initialization
+            addr_field_t src1_addr = pipe.getSrc1();
+            if (vl.architecture_state->MAC_ACCU_INIT_SOURCE == VPRO::MAC_INIT_SOURCE::ADDR) {
+                src1_addr.sel = SRC_SEL_ADDR;
+                pipe.opc =
+                    get<0>(vl.get_operand(src1_addr, pipe.x, pipe.y, pipe.z));
+            } else if (vl.architecture_state->MAC_ACCU_INIT_SOURCE ==
+                       VPRO::MAC_INIT_SOURCE::IMM) {
+                src1_addr.sel = SRC_SEL_IMM;
+                pipe.opc =
+                    get<0>(vl.get_operand(src1_addr, pipe.x, pipe.y, pipe.z));
             }
-            pipe.opa = get<0>(data_a);
-            pipe.opa = *__24to32signed(pipe.opa);
-            pipe.opb = get<0>(data_b);
-
-            // only 18 bit for SRC2 if mac operation
-            if (pipe.cmd->type == CommandVPRO::MULL || pipe.cmd->type == CommandVPRO::MULH ||
-                pipe.cmd->type == CommandVPRO::MACL || pipe.cmd->type == CommandVPRO::MACH ||
-                pipe.cmd->type == CommandVPRO::MACL_PRE ||
-                pipe.cmd->type == CommandVPRO::MACH_PRE ||
-                pipe.cmd->type == CommandVPRO::MULL_NEG ||
-                pipe.cmd->type == CommandVPRO::MULH_NEG ||
-                pipe.cmd->type == CommandVPRO::MULL_POS ||
-                pipe.cmd->type == CommandVPRO::MULH_POS) {
-                auto tmp = *__24to32signed(pipe.opb);
-                pipe.opb = *__18to32signed(pipe.opb);
-                if (tmp != pipe.opb) {
-                    pipe.cmd->print();
-                    printf_warning(
-                        "MUL* only takes 18-bit for second operand (SRC2)/OPB. Loaded Data got "
-                        "cut... %i (soll) != %i (18-bit cut)\n",
-                        tmp,
-                        pipe.opb);
-                }
-
-            } else {
-                pipe.opb = *__24to32signed(pipe.opb);
+            // else ZERO (default of opc)
+            pipe.opc = *__24to32signed(pipe.opc);
+        }
+        pipe.opa = get<0>(data_a);
+        pipe.opa = *__24to32signed(pipe.opa);
+        pipe.opb = get<0>(data_b);
+
+        // only 18 bit for SRC2 if mac operation
+        if (pipe.cmd->type == CommandVPRO::MULL || pipe.cmd->type == CommandVPRO::MULH ||
+            pipe.cmd->type == CommandVPRO::MACL || pipe.cmd->type == CommandVPRO::MACH ||
+            pipe.cmd->type == CommandVPRO::MACL_PRE ||
+            pipe.cmd->type == CommandVPRO::MACH_PRE ||
+            pipe.cmd->type == CommandVPRO::MULL_NEG ||
+            pipe.cmd->type == CommandVPRO::MULH_NEG ||
+            pipe.cmd->type == CommandVPRO::MULL_POS ||
+            pipe.cmd->type == CommandVPRO::MULH_POS) {
+            auto tmp = *__24to32signed(pipe.opb);
+            pipe.opb = *__18to32signed(pipe.opb);
+            if (tmp != pipe.opb) {
+                pipe.cmd->print();
+                printf_warning(
+                    "MUL* only takes 18-bit for second operand (SRC2)/OPB. Loaded Data got "
+                    "cut... %i (soll) != %i (18-bit cut)\n",
+                    tmp,
+                    pipe.opb);
             }
 
-            // update move flag to print correctly in execute stage // differs from HW!
-            switch (pipe.cmd->type) {
-                case CommandVPRO::MV_ZE:
-                    pipe.move = get<1>(data_a);  // z ==1
-                    break;
-                case CommandVPRO::MV_NZ:
-                    pipe.move = !(get<1>(data_a));  // z == 0
-                    break;
-                case CommandVPRO::MV_MI:
-                case CommandVPRO::MULL_NEG:
-                case CommandVPRO::MULH_NEG:
-                case CommandVPRO::SHIFT_AR_NEG:
-                    pipe.move = get<2>(data_a);  // n == 1
-                    break;
-                case CommandVPRO::MV_PL:
-                case CommandVPRO::MULL_POS:
-                case CommandVPRO::MULH_POS:
-                case CommandVPRO::SHIFT_AR_POS:
-                    pipe.move = !(get<2>(data_a));  // n == 0
-                    break;
-                default:
-                    pipe.move = true;
-                    break;
-            }
-        } else if (stage == 5) {  // execute alu, write lm
-            if ((vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::ONCE &&
-                    pipe.cmd->x == 0 && pipe.cmd->y == 0 && pipe.cmd->z == 0) ||
-                (vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::Z_INCREMENT &&
-                    pipe.cmd->x == 0 && pipe.cmd->y == 0) ||
-                (vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::Y_INCREMENT &&
-                    pipe.cmd->x == 0) ||
-                (vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::X_INCREMENT)) {
-                if (pipe.cmd->type == CommandVPRO::MACL_PRE ||
-                    pipe.cmd->type == CommandVPRO::MACH_PRE) {
-                    resetAccu();  // accu = 0
-                } else if (pipe.cmd->type == CommandVPRO::MACL ||
-                           pipe.cmd->type == CommandVPRO::MACH) {
-                    if (vl.architecture_state->MAC_ACCU_INIT_SOURCE ==
-                            VPRO::MAC_INIT_SOURCE::ADDR ||
-                        vl.architecture_state->MAC_ACCU_INIT_SOURCE == VPRO::MAC_INIT_SOURCE::IMM ||
-                        vl.architecture_state->MAC_ACCU_INIT_SOURCE ==
-                            VPRO::MAC_INIT_SOURCE::ZERO) {
-                        if (pipe.cmd->type == CommandVPRO::MACH) {
-                            //resetAccu(pipe.opc << vl.architecture_state->ACCU_MAC_HIGH_BIT_SHIFT);
-                            resetAccu(int64_t(pipe.opc)
-                                      << vl.architecture_state->ACCU_MAC_HIGH_BIT_SHIFT);
-                        } else {
-                            resetAccu(pipe.opc);
-                        }
+        } else {
+            pipe.opb = *__24to32signed(pipe.opb);
+        }
+
+        // update move flag to print correctly in execute stage // differs from HW!
+        switch (pipe.cmd->type) {
+            case CommandVPRO::MV_ZE:
+                pipe.move = get<1>(data_a);  // z ==1
+                break;
+            case CommandVPRO::MV_NZ:
+                pipe.move = !(get<1>(data_a));  // z == 0
+                break;
+            case CommandVPRO::MV_MI:
+            case CommandVPRO::MULL_NEG:
+            case CommandVPRO::MULH_NEG:
+            case CommandVPRO::SHIFT_AR_NEG:
+                pipe.move = get<2>(data_a);  // n == 1
+                break;
+            case CommandVPRO::MV_PL:
+            case CommandVPRO::MULL_POS:
+            case CommandVPRO::MULH_POS:
+            case CommandVPRO::SHIFT_AR_POS:
+                pipe.move = !(get<2>(data_a));  // n == 0
+                break;
+            default:
+                pipe.move = true;
+                break;
+        }
+    } else if (stage == 5) {  // execute alu, write lm
+        if ((vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::ONCE &&
+                pipe.x == 0 && pipe.y == 0 && pipe.z == 0) ||
+            (vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::Z_INCREMENT &&
+                pipe.x == 0 && pipe.y == 0) ||
+            (vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::Y_INCREMENT &&
+                pipe.x == 0) ||
+            (vl.architecture_state->MAC_ACCU_RESET_MODE == VPRO::MAC_RESET_MODE::X_INCREMENT)) {
+            if (pipe.cmd->type == CommandVPRO::MACL_PRE ||
+                pipe.cmd->type == CommandVPRO::MACH_PRE) {
+                resetAccu();  // accu = 0
+            } else if (pipe.cmd->type == CommandVPRO::MACL ||
+                       pipe.cmd->type == CommandVPRO::MACH) {
+                if (vl.architecture_state->MAC_ACCU_INIT_SOURCE ==
+                        VPRO::MAC_INIT_SOURCE::ADDR ||
+                    vl.architecture_state->MAC_ACCU_INIT_SOURCE == VPRO::MAC_INIT_SOURCE::IMM ||
+                    vl.architecture_state->MAC_ACCU_INIT_SOURCE ==
+                        VPRO::MAC_INIT_SOURCE::ZERO) {
+                    if (pipe.cmd->type == CommandVPRO::MACH) {
+                        //resetAccu(pipe.opc << vl.architecture_state->ACCU_MAC_HIGH_BIT_SHIFT);
+                        resetAccu(int64_t(pipe.opc)
+                                  << vl.architecture_state->ACCU_MAC_HIGH_BIT_SHIFT);
+                    } else {
+                        resetAccu(pipe.opc);
                     }
                 }
-                // TODO: ..._PRE instruction needed? -> yes for non ls source (reset not possible)
             }
-            if (pipe.cmd->x == 0 && pipe.cmd->y == 0 &&
-                (pipe.cmd->type == CommandVPRO::MIN_VECTOR ||
-                    pipe.cmd->type == CommandVPRO::MAX_VECTOR)) {
-                minmax_value = pipe.opa;
-                minmax_index =
-                    pipe.cmd->src1.alpha * pipe.cmd->x + pipe.cmd->src1.beta * pipe.cmd->y;
+            // TODO: ..._PRE instruction needed? -> yes for non ls source (reset not possible)
+        }
+        if (pipe.x == 0 && pipe.y == 0 &&
+            (pipe.cmd->type == CommandVPRO::MIN_VECTOR ||
+                pipe.cmd->type == CommandVPRO::MAX_VECTOR)) {
+            minmax_value = pipe.opa;
+            minmax_index =
+                pipe.cmd->src1.alpha * pipe.x + pipe.cmd->src1.beta * pipe.y;
+        }
+        execute_cmd(vl, pipe);
+        if (pipe.cmd->type == CommandVPRO::MULL_NEG ||
+            pipe.cmd->type == CommandVPRO::MULH_NEG ||
+            pipe.cmd->type == CommandVPRO::SHIFT_AR_NEG ||
+            pipe.cmd->type == CommandVPRO::MULL_POS ||
+            pipe.cmd->type == CommandVPRO::MULH_POS ||
+            pipe.cmd->type == CommandVPRO::SHIFT_AR_POS)
+            if (!pipe.move) {
+                pipe.pre_data = pipe.opa;
+                pipe.move =
+                    true;  // only mv_x will not write RF, others do always but conditional take Operand a if condition fails
             }
-            execute_cmd(vl, pipe);
-            if (pipe.cmd->type == CommandVPRO::MULL_NEG ||
-                pipe.cmd->type == CommandVPRO::MULH_NEG ||
-                pipe.cmd->type == CommandVPRO::SHIFT_AR_NEG ||
-                pipe.cmd->type == CommandVPRO::MULL_POS ||
-                pipe.cmd->type == CommandVPRO::MULH_POS ||
-                pipe.cmd->type == CommandVPRO::SHIFT_AR_POS)
-                if (!pipe.move) {
-                    pipe.pre_data = pipe.opa;
-                    pipe.move =
-                        true;  // only mv_x will not write RF, others do always but conditional take Operand a if condition fails
-                }
 
-            pipe.flag[0] = __is_zero(pipe.pre_data);
-            pipe.flag[1] = __is_negative(pipe.pre_data);
-        }
+        pipe.flag[0] = __is_zero(pipe.pre_data);
+        pipe.flag[1] = __is_negative(pipe.pre_data);
+    }
 
-        if (stage == 5 + pipelineALUDepth + 1) {  //usually stage: 9
-            if (pipe.cmd->isWriteRF()) {
-                if (pipe.move) {
-                    vl.regFile.set_rf_data_nxt(pipe.rf_addr, pipe.data);
-                    // Update FLAGs (two steps... to allow chaining)
-                    if (pipe.cmd->flag_update) {
-                        vl.regFile.set_rf_flag_nxt(pipe.rf_addr, 0, pipe.flag[0]);
-                        vl.regFile.set_rf_flag_nxt(pipe.rf_addr, 1, pipe.flag[1]);
-                    }
+    if (stage == 5 + pipelineALUDepth + 1) {  //usually stage: 9
+        if (pipe.cmd->isWriteRF()) {
+            if (pipe.move && vl.functional) {
+                vl.delayRegisterWrite(pipe);
+            } else if (pipe.move) {
+                vl.regFile.set_rf_data_nxt(pipe.rf_addr, pipe.data);
+                // Update FLAGs (two steps... to allow chaining)
+                if (pipe.cmd->flag_update) {
+                    vl.regFile.set_rf_flag_nxt(pipe.rf_addr, 0, pipe.flag[0]);
+                    vl.regFile.set_rf_flag_nxt(pipe.rf_addr, 1, pipe.flag[1]);
                 }
             }
+        }
 
-            if (pipe.cmd->is_chain) {
-                //printf("FIFO PUSH Stage: %d", stage);
-                vl.fifo.push(std::tie(pipe.data, pipe.flag[0], pipe.flag[1]));
-            }
-        }  // stage wb
-    }      // stages
+        if (pipe.cmd->is_chain) {
+            //printf("FIFO PUSH Stage: %d", stage);
+            vl.pushChain(std::tie(pipe.data, pipe.flag[0], pipe.flag[1]));
+        }
+    }  // stage wb
 }
 
 /**
@@ -389,12 +415,12 @@ void PipeObject::execute_cmd(VectorLane& vl, PipelineDate& pipe) {
             // SRC2(0, -, -) == return value
             if ((int32_t)pipe.opa < (int32_t)minmax_value) {
                 minmax_value = pipe.opa;
-                rf_addr_src1 = pipe.cmd->src2.alpha * pipe.cmd->x +
-                               pipe.cmd->src2.beta * pipe.cmd->y +
-                               pipe.cmd->src2.gamma * pipe.cmd->z;
+                rf_addr_src1 = pipe.cmd->src2.alpha * pipe.x +
+                               pipe.cmd->src2.beta * pipe.y +
+                               pipe.cmd->src2.gamma * pipe.z;
                 minmax_index = rf_addr_src1;
             }
-            if ((pipe.cmd->src2.offset & 0b1u) == 1u)
+            if ((pipe.src2_offset & 0b1u) == 1u)
                 res = minmax_index;
             else
                 res = minmax_value;
@@ -410,12 +436,12 @@ void PipeObject::execute_cmd(VectorLane& vl, PipelineDate& pipe) {
             // SRC2(0, -, -) == return value
             if ((int32_t)pipe.opa > (int32_t)minmax_value) {
                 minmax_value = pipe.opa;
-                rf_addr_src1 = pipe.cmd->src1.alpha * pipe.cmd->x +
-                               pipe.cmd->src1.beta * pipe.cmd->y +
-                               pipe.cmd->src1.gamma * pipe.cmd->z;
+                rf_addr_src1 = pipe.cmd->src1.alpha * pipe.x +
+                               pipe.cmd->src1.beta * pipe.y +
+                               pipe.cmd->src1.gamma * pipe.z;
                 minmax_index = rf_addr_src1;
             }
-            if ((pipe.cmd->src2.offset & 0b1u) == 1u)
+            if ((pipe.src2_offset & 0b1u) == 1u)
                 res = minmax_index;
             else
                 res = minmax_value;
@@ -457,7 +483,7 @@ void PipeObject::execute_cmd(VectorLane& vl, PipelineDate& pipe) {
             break;
         default:
             printf_error("Lane Command Execution: Error in Command TYPE: ");
-            print_cmd(pipe.cmd.get());
+            print_cmd(pipe.cmd);
             printf("\n");
             break;
     }
@@ -467,240 +493,235 @@ void PipeObject::execute_cmd(VectorLane& vl, PipelineDate& pipe) {
 }
 
 /**
- * clock tick to process lanes command/pipeline
+ * one pipeline stage of a load / store command
  */
-void LSPipeObject::tick_pipeline(VectorLane& vl, int from, int until) {
-    for (int stage = from; stage <= until; stage++) {
-        // Addressing Units (Stage 0..3) for address calc
-        // Local Memory Address Computation, base address (stage 3),
-        // Chaining Write Enable (stage 4)
-        // ALU Input Operands (stage 4) e.g. chain, imm
-        // ALU Input Operands (stage 5) (assign to alu) e.g., src1_rdata
-        // Local Memory Interface (stage 5) e.g. is_load/store, addr, wdata
-        // ALU (stages 5..8)
-        // Condition Check (stage 6) e.g., z_v, n_v
-        // Data Write-Back Buffer (stage 8) e.g., rf_write_data <= lm_data/alu_result  chain_data_o <= alu_result
-        // Chaining Output (stage 9)
-        //        chain_sync_o <= enable(4) and (not enable(5)) and cmd_reg_pipe(4)(cmd_is_chain_c); -- 3 cycles latency between sync and actual data!!
-        // Register File (read: stage 3..5; write: stage 9)
-
-        PipelineDate& pipe = data[stage];
-        if (pipe.cmd->type == CommandVPRO::NONE) continue;
-
-        if (pipe.cmd->type != CommandVPRO::NONE && !pipe.cmd->isLS())
-            printf_warning("LS Pipeline Tick got a NON-LS Cmd!");
+void LSPipeObject::tick_stage(VectorLane& vl, PipelineDate& pipe, int stage) {
+    // Addressing Units (Stage 0..3) for address calc
+    // Local Memory Address Computation, base address (stage 3),
+    // Chaining Write Enable (stage 4)
+    // ALU Input Operands (stage 4) e.g. chain, imm
+    // ALU Input Operands (stage 5) (assign to alu) e.g., src1_rdata
+    // Local Memory Interface (stage 5) e.g. is_load/store, addr, wdata
+    // ALU (stages 5..8)
+    // Condition Check (stage 6) e.g., z_v, n_v
+    // Data Write-Back Buffer (stage 8) e.g., rf_write_data <= lm_data/alu_result  chain_data_o <= alu_result
+    // Chaining Output (stage 9)
+    //        chain_sync_o <= enable(4) and (not enable(5)) and cmd_reg_pipe(4)(cmd_is_chain_c); -- 3 cycles latency between sync and actual data!!
+    // Register File (read: stage 3..5; write: stage 9)
+
+    if (pipe.cmd->type != CommandVPRO::NONE && !pipe.cmd->isLS())
+        printf_warning("LS Pipeline Tick got a NON-LS Cmd!");
+
+    if (stage == 0) {  // calc addresses
+        // result address in rf for regular instructions
+        // for LM
+        /**
+         * SRC1 is complex addr
+         */
+        pipe.lm_addr = pipe.cmd->src1.alpha * pipe.x + pipe.cmd->src1.beta * pipe.y +
+                       pipe.cmd->src1.gamma * pipe.z;
+
+        if (pipe.cmd->type == CommandVPRO::STORE_SHIFT_LEFT ||
+            pipe.cmd->type == CommandVPRO::STORE_SHIFT_RIGHT) {
+            if (pipe.cmd->src2.sel != SRC_SEL_IMM)
+                printf_error("Shift in Store; only by immediate!\n");
+            pipe.opb =
+                get<0>(vl.get_operand(pipe.getSrc2(), pipe.x, pipe.y, pipe.z));
+            pipe.opb = *__24to32signed(pipe.opb);
+        }
+        if (pipe.cmd->type == CommandVPRO::LOAD_REVERSE ||
+            pipe.cmd->type == CommandVPRO::STORE_REVERSE) {
+            // TODO: z always added?
+            auto imm = pipe.getDst().getImm();
+            if (imm == 0b00)
+                pipe.lm_addr = pipe.cmd->src1.alpha * pipe.x +
+                               pipe.cmd->src1.beta * pipe.y +
+                               pipe.cmd->src1.gamma * pipe.z;
+            if (imm == 0b01)
+                pipe.lm_addr = pipe.cmd->src1.alpha * pipe.x -
+                               pipe.cmd->src1.beta * pipe.y +
+                               pipe.cmd->src1.gamma * pipe.z;
+            if (imm == 0b10)
+                pipe.lm_addr = -pipe.cmd->src1.alpha * pipe.x +
+                               pipe.cmd->src1.beta * pipe.y +
+                               pipe.cmd->src1.gamma * pipe.z;
+            if (imm == 0b11)
+                pipe.lm_addr = -pipe.cmd->src1.alpha * pipe.x -
+                               pipe.cmd->src1.beta * pipe.y +
+                               pipe.cmd->src1.gamma * pipe.z;
+        }
+    } else if (stage == 3) {  // indirect addressing (chained offsets)
+        check_indirect_addressing(*pipe.cmd);
 
-        if (stage == 0) {  // calc addresses
-            // result address in rf for regular instructions
-            // for LM
-            /**
-             * SRC1 is complex addr
-             */
-            pipe.lm_addr = pipe.cmd->src1.alpha * pipe.cmd->x + pipe.cmd->src1.beta * pipe.cmd->y +
-                           pipe.cmd->src1.gamma * pipe.cmd->z;
-
-            if (pipe.cmd->type == CommandVPRO::STORE_SHIFT_LEFT ||
-                pipe.cmd->type == CommandVPRO::STORE_SHIFT_RIGHT) {
-                if (pipe.cmd->src2.sel != SRC_SEL_IMM)
-                    printf_error("Shift in Store; only by immediate!\n");
-                pipe.opb =
-                    get<0>(vl.get_operand(pipe.cmd->src2, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z));
-                pipe.opb = *__24to32signed(pipe.opb);
-            }
-            if (pipe.cmd->type == CommandVPRO::LOAD_REVERSE ||
-                pipe.cmd->type == CommandVPRO::STORE_REVERSE) {
-                // TODO: z always added?
-                auto imm = pipe.cmd->dst.getImm();
-                if (imm == 0b00)
-                    pipe.lm_addr = pipe.cmd->src1.alpha * pipe.cmd->x +
-                                   pipe.cmd->src1.beta * pipe.cmd->y +
-                                   pipe.cmd->src1.gamma * pipe.cmd->z;
-                if (imm == 0b01)
-                    pipe.lm_addr = pipe.cmd->src1.alpha * pipe.cmd->x -
-                                   pipe.cmd->src1.beta * pipe.cmd->y +
-                                   pipe.cmd->src1.gamma * pipe.cmd->z;
-                if (imm == 0b10)
-                    pipe.lm_addr = -pipe.cmd->src1.alpha * pipe.cmd->x +
-                                   pipe.cmd->src1.beta * pipe.cmd->y +
-                                   pipe.cmd->src1.gamma * pipe.cmd->z;
-                if (imm == 0b11)
-                    pipe.lm_addr = -pipe.cmd->src1.alpha * pipe.cmd->x -
-                                   pipe.cmd->src1.beta * pipe.cmd->y +
-                                   pipe.cmd->src1.gamma * pipe.cmd->z;
-            }
-        } else if (stage == 3) {  // indirect addressing (chained offsets)
-            check_indirect_addressing(pipe.cmd);
+        if (pipe.cmd->src1.sel == SRC_SEL_INDIRECT_RIGHT) {
+            int i = 0;
+        }
+        update_offsets(vl, pipe, SRC_SEL_INDIRECT_LEFT, vl.getLeftNeighbor());
+        update_offsets(vl, pipe, SRC_SEL_INDIRECT_RIGHT, vl.getRightNeighbor());
 
-            if (pipe.cmd->src1.sel == SRC_SEL_INDIRECT_RIGHT) {
-                int i = 0;
-            }
-            update_offsets(vl, pipe.cmd, SRC_SEL_INDIRECT_LEFT, vl.getLeftNeighbor());
-            update_offsets(vl, pipe.cmd, SRC_SEL_INDIRECT_RIGHT, vl.getRightNeighbor());
+        pipe.lm_addr += pipe.src1_offset;
+    }
 
-            pipe.lm_addr += pipe.cmd->src1.offset;
+    else if (stage == 4) {  // read chain input, read rf <?>
+        /**
+             * DST encodes Data
+             */
+        if (pipe.cmd->type == CommandVPRO::STORE ||
+            pipe.cmd->type == CommandVPRO::STORE_SHIFT_LEFT ||
+            pipe.cmd->type == CommandVPRO::STORE_SHIFT_RIGHT ||
+            pipe.cmd->type == CommandVPRO::STORE_REVERSE) {
+            pipe.pre_data =
+                get<0>(vl.get_operand(pipe.getDst(), pipe.x, pipe.y, pipe.z));
+            pipe.pre_data = *__24to32signed(pipe.pre_data);
+            pipe.pre_data = *__16to24(pipe.pre_data);
+        }
+        if (pipe.cmd->type ==
+            CommandVPRO::STORE_SHIFT_LEFT) {  // MUX of different shifted datas
+            pipe.pre_data = uint32_t(int32_t(pipe.pre_data) << pipe.opb);
+            pipe.pre_data = *__24to32signed(pipe.pre_data);
+            pipe.pre_data = *__16to24(pipe.pre_data);
+        }
+        if (pipe.cmd->type == CommandVPRO::STORE_SHIFT_RIGHT) {
+            pipe.pre_data = uint32_t(int32_t(pipe.pre_data) >> pipe.opb);
+            pipe.pre_data = *__24to32signed(pipe.pre_data);
+            pipe.pre_data = *__16to24(pipe.pre_data);
         }
 
-        else if (stage == 4) {  // read chain input, read rf <?>
-            /**
-                 * DST encodes Data
-                 */
-            if (pipe.cmd->type == CommandVPRO::STORE ||
-                pipe.cmd->type == CommandVPRO::STORE_SHIFT_LEFT ||
-                pipe.cmd->type == CommandVPRO::STORE_SHIFT_RIGHT ||
-                pipe.cmd->type == CommandVPRO::STORE_REVERSE) {
+        // LOAD or Write: SRC1: Chain from other __LS__
+        if (pipe.cmd->dst.chain_ls) {
+            if (pipe.cmd->dst.chain_left) {
                 pipe.pre_data =
-                    get<0>(vl.get_operand(pipe.cmd->dst, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z));
-                pipe.pre_data = *__24to32signed(pipe.pre_data);
-                pipe.pre_data = *__16to24(pipe.pre_data);
-            }
-            if (pipe.cmd->type ==
-                CommandVPRO::STORE_SHIFT_LEFT) {  // MUX of different shifted datas
-                pipe.pre_data = uint32_t(int32_t(pipe.pre_data) << pipe.opb);
-                pipe.pre_data = *__24to32signed(pipe.pre_data);
-                pipe.pre_data = *__16to24(pipe.pre_data);
-            }
-            if (pipe.cmd->type == CommandVPRO::STORE_SHIFT_RIGHT) {
-                pipe.pre_data = uint32_t(int32_t(pipe.pre_data) >> pipe.opb);
-                pipe.pre_data = *__24to32signed(pipe.pre_data);
-                pipe.pre_data = *__16to24(pipe.pre_data);
-            }
-
-            // LOAD or Write: SRC1: Chain from other __LS__
-            if (pipe.cmd->dst.chain_ls) {
-                if (pipe.cmd->dst.chain_left) {
-                    pipe.pre_data =
-                        std::get<0>(vl.vector_unit->getLeftNeighbor()->getLSLane().fifo.pop());
-                } else if (pipe.cmd->dst.chain_right) {
-                    pipe.pre_data =
-                        std::get<0>(vl.vector_unit->getRightNeighbor()->getLSLane().fifo.pop());
-                } else
-                    printf_error(
-                        "Chain from LS LOAD stage 4 gets data but no direction specified!");
-            }
+                    std::get<0>(vl.vector_unit->getLeftNeighbor()->getLSLane().popChain());
+            } else if (pipe.cmd->dst.chain_right) {
+                pipe.pre_data =
+                    std::get<0>(vl.vector_unit->getRightNeighbor()->getLSLane().popChain());
+            } else
+                printf_error(
+                    "Chain from LS LOAD stage 4 gets data but no direction specified!");
+        }
 
-            /**
-             * SRC2 Imm (LM Addr)
-             */
-            // add immediate from SRC2 or chained offset    -> TODO: implement in hardware
-            switch (pipe.cmd->src2.sel) {
-                case SRC_SEL_IMM:
+        /**
+         * SRC2 Imm (LM Addr)
+         */
+        // add immediate from SRC2 or chained offset    -> TODO: implement in hardware
+        switch (pipe.cmd->src2.sel) {
+            case SRC_SEL_IMM:
+                pipe.lm_addr += get<0>(
+                    vl.get_operand(pipe.getSrc2(), pipe.x, pipe.y, pipe.z));
+                break;
+            case SRC_SEL_LEFT:
+            case SRC_SEL_RIGHT:
+                if (pipe.cmd->isLoad()) {
                     pipe.lm_addr += get<0>(
-                        vl.get_operand(pipe.cmd->src2, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z));
-                    break;
-                case SRC_SEL_LEFT:
-                case SRC_SEL_RIGHT:
-                    if (pipe.cmd->isLoad()) {
-                        pipe.lm_addr += get<0>(
-                            vl.get_operand(pipe.cmd->src2, pipe.cmd->x, pipe.cmd->y, pipe.cmd->z));
-                    } else {
-                        printf_error("Cannot chain offset for store instruction");
-                    }
-                    break;
-                default:
-                    printf_error("Invalid operand sel for LS Instruction");
-            }
-        } else if (stage == 5) {  // execute alu, write lm
-            if (pipe.cmd->isWriteLM()) {
-                // STORE: SRC1: Addr, Src2: Imm (or chained indirect offset)
-                pipe.data = pipe.pre_data;
-            } else {
-                // LOAD
-                if (!pipe.cmd->dst.chain_ls) {  // no LS -> LS chain    // TODO: Load of IMMEDIATE?
-                    switch (pipe.cmd->type) {
-                        case CommandVPRO::LOAD:
-                        case CommandVPRO::LOADS:
-                        case CommandVPRO::LOADS_SHIFT_LEFT:
-                        case CommandVPRO::LOADS_SHIFT_RIGHT:
-                        case CommandVPRO::LOADB:
-                        case CommandVPRO::LOADBS:
-                        case CommandVPRO::LOAD_REVERSE:
-                            pipe.pre_data = vl.vector_unit->getLocalMemoryData(pipe.lm_addr);
-                        default:
-                            break;
-                    }
+                        vl.get_operand(pipe.getSrc2(), pipe.x, pipe.y, pipe.z));
                 } else {
-                    // pre_data already received (chain from LS)
+                    printf_error("Cannot chain offset for store instruction");
                 }
+                break;
+            default:
+                printf_error("Invalid operand sel for LS Instruction");
+        }
+    } else if (stage == 5) {  // execute alu, write lm
+        if (pipe.cmd->isWriteLM()) {
+            // STORE: SRC1: Addr, Src2: Imm (or chained indirect offset)
+            pipe.data = pipe.pre_data;
+        } else {
+            // LOAD
+            if (!pipe.cmd->dst.chain_ls) {  // no LS -> LS chain    // TODO: Load of IMMEDIATE?
+                switch (pipe.cmd->type) {
+                    case CommandVPRO::LOAD:
+                    case CommandVPRO::LOADS:
+                    case CommandVPRO::LOADS_SHIFT_LEFT:
+                    case CommandVPRO::LOADS_SHIFT_RIGHT:
+                    case CommandVPRO::LOADB:
+                    case CommandVPRO::LOADBS:
+                    case CommandVPRO::LOAD_REVERSE:
+                        pipe.pre_data = vl.vector_unit->getLocalMemoryData(pipe.lm_addr);
+                    default:
+                        break;
+                }
+            } else {
+                // pre_data already received (chain from LS)
             }
+        }
 
-            switch (pipe.cmd->type) {
-                case CommandVPRO::LOAD:
-                    pipe.pre_data = *__16to24(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-                case CommandVPRO::LOADS:
-                    pipe.pre_data = *__16to24signed(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-                case CommandVPRO::LOADS_SHIFT_LEFT:  //data on stage 9
-                    pipe.pre_data = *__16to24signed(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    //stage 7
-                    pipe.pre_data = int32_t(pipe.pre_data) << pipe.cmd->dst.offset;
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-                case CommandVPRO::LOADS_SHIFT_RIGHT:  //data on stage 9
-                    pipe.pre_data = *__16to24signed(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    //stage 7
-                    pipe.pre_data = int32_t(pipe.pre_data) >> pipe.cmd->dst.offset;
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-                case CommandVPRO::LOADB:
-                    pipe.pre_data = *__8to24(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-                case CommandVPRO::LOADBS:
-                    pipe.pre_data = *__8to24signed(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-                case CommandVPRO::LOAD_REVERSE:
-                    pipe.pre_data = *__8to24signed(pipe.pre_data);
-                    pipe.pre_data = *__24to32signed(pipe.pre_data);
-                    break;
-
-                case CommandVPRO::STORE:
-                    vl.vector_unit->writeLocalMemoryData(pipe.lm_addr, pipe.data);
-                    pipe.pre_data = pipe.data;
-                    break;
-                case CommandVPRO::STORE_SHIFT_LEFT:
-                    printf_error("VPRO_SIM ERROR: STORE_SHIFT_LEFT instruction not implemented \n");
-                    break;
-                case CommandVPRO::STORE_SHIFT_RIGHT:
-                    printf_error(
-                        "VPRO_SIM ERROR: STORE_SHIFT_RIGHT instruction not implemented \n");
-                    break;
-                case CommandVPRO::STORE_REVERSE:
-                    printf_error("VPRO_SIM ERROR: STORE_REVERSE instruction not implemented \n");
-                    break;
-                default:
-                    break;
-            }
-            pipe.flag[0] = __is_zero(pipe.pre_data);
-            pipe.flag[1] = __is_negative(pipe.pre_data);
-
-            // for LS chain data source:
-            //  pipe.data = pipe.pre_data;
-            //  take chained data as own result
-            // TODO: this is done in stage end-1, could happen earlier here to save some cycles on chain LS
-            //  to LS if following command get stalled due to load delay from this Load
-        } else if (stage == 8) {
-            //delay 2 stages (data access in stage 8)
-            switch (pipe.cmd->type) {
-                case CommandVPRO::LOAD:
-                case CommandVPRO::LOADS:
-                case CommandVPRO::LOADS_SHIFT_LEFT:
-                case CommandVPRO::LOADS_SHIFT_RIGHT:
-                case CommandVPRO::LOADB:
-                case CommandVPRO::LOADBS:
-                case CommandVPRO::LOAD_REVERSE:
-                    vl.fifo.push(std::tie(pipe.pre_data, pipe.flag[0], pipe.flag[1]));
-                    break;
-                default:
-                    break;
-            }
+        switch (pipe.cmd->type) {
+            case CommandVPRO::LOAD:
+                pipe.pre_data = *__16to24(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+            case CommandVPRO::LOADS:
+                pipe.pre_data = *__16to24signed(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+            case CommandVPRO::LOADS_SHIFT_LEFT:  //data on stage 9
+                pipe.pre_data = *__16to24signed(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                //stage 7
+                pipe.pre_data = int32_t(pipe.pre_data) << pipe.dst_offset;
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+            case CommandVPRO::LOADS_SHIFT_RIGHT:  //data on stage 9
+                pipe.pre_data = *__16to24signed(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                //stage 7
+                pipe.pre_data = int32_t(pipe.pre_data) >> pipe.dst_offset;
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+            case CommandVPRO::LOADB:
+                pipe.pre_data = *__8to24(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+            case CommandVPRO::LOADBS:
+                pipe.pre_data = *__8to24signed(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+            case CommandVPRO::LOAD_REVERSE:
+                pipe.pre_data = *__8to24signed(pipe.pre_data);
+                pipe.pre_data = *__24to32signed(pipe.pre_data);
+                break;
+
+            case CommandVPRO::STORE:
+                vl.vector_unit->writeLocalMemoryData(pipe.lm_addr, pipe.data);
+                pipe.pre_data = pipe.data;
+                break;
+            case CommandVPRO::STORE_SHIFT_LEFT:
+                printf_error("VPRO_SIM ERROR: STORE_SHIFT_LEFT instruction not implemented \n");
+                break;
+            case CommandVPRO::STORE_SHIFT_RIGHT:
+                printf_error(
+                    "VPRO_SIM ERROR: STORE_SHIFT_RIGHT instruction not implemented \n");
+                break;
+            case CommandVPRO::STORE_REVERSE:
+                printf_error("VPRO_SIM ERROR: STORE_REVERSE instruction not implemented \n");
+                break;
+            default:
+                break;
         }
-    }  // for stages
+        pipe.flag[0] = __is_zero(pipe.pre_data);
+        pipe.flag[1] = __is_negative(pipe.pre_data);
+
+        // for LS chain data source:
+        //  pipe.data = pipe.pre_data;
+        //  take chained data as own result
+        // TODO: this is done in stage end-1, could happen earlier here to save some cycles on chain LS
+        //  to LS if following command get stalled due to load delay from this Load
+    } else if (stage == 8) {
+        //delay 2 stages (data access in stage 8)
+        switch (pipe.cmd->type) {
+            case CommandVPRO::LOAD:
+            case CommandVPRO::LOADS:
+            case CommandVPRO::LOADS_SHIFT_LEFT:
+            case CommandVPRO::LOADS_SHIFT_RIGHT:
+            case CommandVPRO::LOADB:
+            case CommandVPRO::LOADBS:
+            case CommandVPRO::LOAD_REVERSE:
+                vl.pushChain(std::tie(pipe.pre_data, pipe.flag[0], pipe.flag[1]));
+                break;
+            default:
+                break;
+        }
+    }
 }
 
 void LSPipeObject::execute_cmd(VectorLane& vl, PipelineDate& pipe) {
@@ -714,45 +735,117 @@ void LSPipeObject::execute_cmd(VectorLane& vl, PipelineDate& pipe) {
  * after execution the result of the command is pushed to the pipeline to be able to be accessed from another lane
  * @param newElement Pipeline_data type of result
  */
-void PipeObject::process(std::shared_ptr<CommandVPRO> newElement) {
+void PipeObject::process(const std::shared_ptr<CommandVPRO>& newElement) {
     //@INFO !KOM
-    // shift each element and append new
-    for (int i = 5 + pipelineALUDepth + 1; i > 0; i--) {
-        data[i] = data[i - 1];
-    }
-    PipelineDate pipe;
-    pipe.cmd = std::make_shared<CommandVPRO>(newElement.get());
-    data[0] = pipe;
+    // shift each element and append new (the last stage of the ring becomes the first one)
+    updateRing();
+    ring_head = (ring_head == 0) ? ring_size - 1 : ring_head - 1;
+    PipelineDate& pipe = data[ring_head];
+    release(pipe.cmd);  // left the last stage of the ring
+    pipe = PipelineDate();
+    pipe.cmd = getDescriptor(newElement);
+    retain(pipe.cmd);
+    pipe.x = newElement->x;
+    pipe.y = newElement->y;
+    pipe.z = newElement->z;
+    pipe.src1_offset = newElement->src1.offset;
+    pipe.src2_offset = newElement->src2.offset;
+    pipe.dst_offset = newElement->dst.offset;
+    pipe.blocking = newElement->blocking;
 }
 
 void PipeObject::processInStall(int from) {
     // process later half of pipeline that is not affected by missing input data of stalling source lane
-    for (int i = 5 + pipelineALUDepth + 1; i > from; i--) {  // process half Pipeline
-        data[i] = data[i - 1];  // shift each element and append new empty
+    updateRing();
+    ring_head = (ring_head == 0) ? ring_size - 1 : ring_head - 1;
+    release((*this)[0].cmd);  // left the last stage of the ring, stages 1 ... from move down one
+    for (int i = 0; i < from; i++) {  // first half stays in its stages
+        (*this)[i] = (*this)[i + 1];
     }
-    PipelineDate pipe;
-    pipe.cmd = std::make_shared<CommandVPRO>();
     // fill the empty pipeline stage with a none cmd
-    data[from] = pipe;
+    PipelineDate& pipe = (*this)[from];
+    pipe = PipelineDate();
+    pipe.cmd = &none_descriptor;
+}
+
+void PipeObject::executeElement(VectorLane& vl, CommandVPRO& cmd) {
+    pipelineALUDepth = int(cmd.pipelineALUDepth);
+    PipelineDate pipe;
+    pipe.cmd = &cmd;
+    pipe.x = cmd.x;
+    pipe.y = cmd.y;
+    pipe.z = cmd.z;
+    pipe.src1_offset = cmd.src1.offset;
+    pipe.src2_offset = cmd.src2.offset;
+    pipe.dst_offset = cmd.dst.offset;
+    pipe.blocking = cmd.blocking;
+    for (int stage = 0; stage <= 5 + pipelineALUDepth + 1; stage++) {
+        tick_stage(vl, pipe, stage);
+        if (stage == 5 + pipelineALUDepth) pipe.data = pipe.pre_data;  // update()
+    }
+}
+
+void PipeObject::updateRing() {
+    int size = std::min(5 + pipelineALUDepth + 2, int(data.size()));
+    if (size == ring_size) return;
+    // linear order again, stages behind the new write back stage keep their content
+    std::rotate(data.begin(), data.begin() + ring_head, data.begin() + ring_size);
+    ring_head = 0;
+    ring_size = size;
+}
+
+CommandVPRO* PipeObject::getDescriptor(const std::shared_ptr<CommandVPRO>& newElement) {
+    // same command as before (only x/y/z changed, kept per stage)
+    if (newElement == descriptor_src) return descriptor_last;
+
+    for (size_t i = 0; i < descriptors.size(); i++) {
+        size_t slot = next_descriptor;
+        next_descriptor = (next_descriptor + 1) % descriptors.size();
+        if (descriptor_refs[slot] == 0) {
+            CommandVPRO* descriptor = &descriptors[slot];
+            *descriptor = *newElement;
+            descriptor_src = newElement;
+            descriptor_last = descriptor;
+            return descriptor;
+        }
+    }
+    printf_error("Pipeline: no free command descriptor!\n");
+    exit(EXIT_FAILURE);
+}
+
+void PipeObject::retain(const CommandVPRO* descriptor) {
+    if (descriptor != &none_descriptor) descriptor_refs[descriptor - descriptors.data()]++;
+}
+
+void PipeObject::release(const CommandVPRO* descriptor) {
+    if (descriptor != &none_descriptor) descriptor_refs[descriptor - descriptors.data()]--;
 }
 
 bool PipeObject::isBusy() const {
     bool pipeline_busy = false;
     for (int i = 0; i < 5 + pipelineALUDepth + 1; i++) {
-        pipeline_busy |= (data[i].cmd->type != CommandVPRO::NONE);
+        pipeline_busy |= ((*this)[i].cmd->type != CommandVPRO::NONE);
     }
     return pipeline_busy;
 }
 
+bool PipeObject::isEmpty() const {
+    for (int i = 0; i <= 5 + pipelineALUDepth + 1; i++) {
+        if ((*this)[i].cmd->type != CommandVPRO::NONE) return false;
+    }
+    return true;
+}
+
 void PipeObject::update() {
     //*********************************************
     // Update Registers
     //*********************************************
-    data[5 + pipelineALUDepth].data = data[5 + pipelineALUDepth].pre_data;
+    PipelineDate& pipe = (*this)[5 + pipelineALUDepth];
+    pipe.data = pipe.pre_data;
 }
 
 bool PipeObject::isChaining() const {
-    return data[5 + pipelineALUDepth].cmd->is_chain;
+    return (*this)[5 + pipelineALUDepth].cmd->is_chain;
 }
 
 bool PipeObject::isBlocking(int chain_target_stage) const {
@@ -760,12 +853,12 @@ bool PipeObject::isBlocking(int chain_target_stage) const {
     bool blocking = false;
     for (int stage = 0; stage <= 5 + pipelineALUDepth - 1 - (chain_target_stage); stage++) {
         //stage 0...3
-        blocking |= data[stage].cmd->blocking;
+        blocking |= (*this)[stage].blocking;
     }
     return blocking;
 }
 
-void PipeObject::check_indirect_addressing(CommandVPRO cmd) {
+void PipeObject::check_indirect_addressing(const CommandVPRO& cmd) {
     bool chain_offset_vl =
         chains_from_src(cmd, SRC_SEL_INDIRECT_LEFT) || chains_from_src(cmd, SRC_SEL_INDIRECT_RIGHT);
     bool chain_offset_ls = chains_from_src(cmd, SRC_SEL_INDIRECT_LS);
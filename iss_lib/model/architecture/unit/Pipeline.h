@@ -28,33 +28,47 @@ namespace Unit {
 
 class VectorLane;  //fw declaration
 
+/**
+ * one pipeline stage entry (plain data, no ownership)
+ * the command itself is an immutable descriptor (pool of the PipeObject), the iteration state
+ * of the command in this stage (x/y/z, offsets updated by indirect addressing, blocking) is kept per stage
+ */
 struct PipelineDate {
     // result (got in stage of alu finish)
-    uint32_t data;
+    uint32_t data{0};
     // in sim the result is calc in one cycle / loaded in same. stored (tmp) here
-    uint32_t pre_data;
-    std::shared_ptr<CommandVPRO> cmd;
-
-    uint32_t opa, opb, opc;
-    uint32_t res;
-    int rf_addr, lm_addr;
-    bool move;
-
-    bool flag[2];
-
-    PipelineDate() {
-        data = 0;
-        opa = 0;
-        opb = 0;
-        opc = 0;
-        rf_addr = 0;
-        lm_addr = 0;
-        move = false;
-        cmd = std::make_shared<CommandVPRO>();
-        flag[0] = false;
-        flag[1] = false;
-        res = 0;
-    };
+    uint32_t pre_data{0};
+    // descriptor of the command in this stage (never nullptr once inserted into a PipeObject)
+    CommandVPRO* cmd{nullptr};
+
+    // iteration state of cmd in this stage
+    uint32_t x{0}, y{0}, z{0};
+    uint32_t src1_offset{0}, src2_offset{0}, dst_offset{0};
+    bool blocking{false};
+
+    uint32_t opa{0}, opb{0}, opc{0};
+    uint32_t res{0};
+    int rf_addr{0}, lm_addr{0};
+    bool move{false};
+
+    bool flag[2]{false, false};
+
+    // address fields of cmd with the offsets of this stage
+    addr_field_t getSrc1() const {
+        addr_field_t field = cmd->src1;
+        field.offset = src1_offset;
+        return field;
+    }
+    addr_field_t getSrc2() const {
+        addr_field_t field = cmd->src2;
+        field.offset = src2_offset;
+        return field;
+    }
+    addr_field_t getDst() const {
+        addr_field_t field = cmd->dst;
+        field.offset = dst_offset;
+        return field;
+    }
 };
 
 class PipeObject {
@@ -79,28 +93,57 @@ class PipeObject {
     const PipelineDate& operator[](int index) const;
     void resetAccu(int64_t value = 0);
     void resetMinMax(uint32_t value);
-    virtual void tick_pipeline(VectorLane& vl, int from, int until);
-    void process(std::shared_ptr<CommandVPRO> newElement);
+    void tick_pipeline(VectorLane& vl, int from, int until);
+    // processing of pipe (command element) in stage
+    virtual void tick_stage(VectorLane& vl, PipelineDate& pipe, int stage);
+    void process(const std::shared_ptr<CommandVPRO>& newElement);
     void processInStall(int from);
+    // functional execution (sim_init argument --functional): all stages of the current element of
+    // cmd on a separate pipeline entry, the pipeline itself is not used
+    void executeElement(VectorLane& vl, CommandVPRO& cmd);
     bool isBusy() const;
+    // no command in any stage (including the last write back stage)
+    bool isEmpty() const;
     void update();
     bool isChaining() const;
     bool isBlocking(int chain_target_stage) const;
-    void check_indirect_addressing(CommandVPRO cmd);
+    void check_indirect_addressing(const CommandVPRO& cmd);
 
    protected:
     // the processing needs PIPELINE_DEPTH cycles. each cycle the last entry from pipeline is written into rf_data!
     // on parsing a new command, a new pipeline entry is inserted with currently read data from rf
     // PipelineDate results_pipeline[11];
+    // stages 0..ring_size-1 are a ring starting at ring_head, stages behind are stored linear
     std::vector<PipelineDate> data;
+    int ring_head{0};
+    int ring_size{0};
 
    private:
     virtual void execute_cmd(VectorLane& vl, PipelineDate& pipe);
+
+    // (re)build the ring if the pipeline depth has changed since the last shift
+    void updateRing();
+    // copy of newElement in a free descriptor slot (reused if newElement has been inserted before)
+    CommandVPRO* getDescriptor(const std::shared_ptr<CommandVPRO>& newElement);
+    // reference count of a descriptor: stage entered / left (none_descriptor is not counted)
+    void retain(const CommandVPRO* descriptor);
+    void release(const CommandVPRO* descriptor);
+
+    // descriptor of empty stages
+    CommandVPRO none_descriptor;
+    // one slot more than stages -> always a free one
+    std::vector<CommandVPRO> descriptors;
+    // number of stages referencing each descriptor, slots with 0 are free
+    std::vector<uint32_t> descriptor_refs;
+    size_t next_descriptor{0};
+    // command of the last allocated descriptor (kept alive to detect the same command)
+    std::shared_ptr<CommandVPRO> descriptor_src;
+    CommandVPRO* descriptor_last{nullptr};
 };
 
 class LSPipeObject : public PipeObject {
    public:
-    void tick_pipeline(VectorLane& vl, int from, int until) override;
+    void tick_stage(VectorLane& vl, PipelineDate& pipe, int stage) override;
     LSPipeObject() = delete;
     LSPipeObject(int size, int pipelineALUDepth) : PipeObject(size, pipelineALUDepth) {}
 
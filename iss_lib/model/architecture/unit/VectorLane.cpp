@@ -22,10 +22,13 @@
 #include <iostream>
 #include "../../../core_wrapper.h"
 #include "../../../simulator/ISS.h"
+#include "../../../simulator/helper/checkpoint.h"
 #include "../../../simulator/helper/debugHelper.h"
+#include "../../../simulator/helper/timeline.h"
 #include "../../../simulator/helper/typeConversion.h"
 #include "../../../simulator/setting.h"
 #include "../Cluster.h"
+#include "../stats/StatisticVpro.h"
 #include "VectorUnit.h"
 
 #include <tuple>
@@ -57,11 +60,14 @@ VectorLane::VectorLane(int id,
       regFile(vector_unit->cluster_id,
           vector_unit->vector_unit_id,
           vector_lane_id,
-          VPRO_CFG::RF_SIZE,
-          (id == 1 << VPRO_CFG::LANES)) {
+          vector_unit->hw.rf_size,
+          (id == 1 << vector_unit->hw.lanes)) {
     current_cmd = std::make_shared<CommandVPRO>();
     new_cmd = std::make_shared<CommandVPRO>();
     noneCmd = std::make_shared<CommandVPRO>();
+    fetch_buffers[0] = std::make_shared<CommandVPRO>();
+    fetch_buffers[1] = std::make_shared<CommandVPRO>();
+    delay_cmd = std::make_shared<CommandVPRO>();
     pipeObj = std::make_unique<PipeObject>(5 + CommandVPRO::MAX_ALU_DEPTH, 3);
 }
 
@@ -70,12 +76,30 @@ VectorLane::VectorLane(int id,
  * @return bool
  */
 bool VectorLane::isBusy() const {
-    return isBlocking() || pipeObj->isBusy();
+    return isBlocking() || pipeObj->isBusy() || functional_active;
 }
 bool VectorLane::isBlocking() const {
     return blocking;
 }
 
+bool VectorLane::isIdle() const {
+    if (functional) return !functional_active;
+    if (blocking || src_lane_stall || dst_lane_stall || adr_lane_stall || fifo.wasRead())
+        return false;
+    // the units none command is fetched each cycle (and processed as done)
+    if (current_cmd != new_cmd || current_cmd != vector_unit->getNoneCmd()) return false;
+    if (!current_cmd->is_done()) return false;
+    return pipeObj->pipelineALUDepth == int(current_cmd->pipelineALUDepth) && pipeObj->isEmpty();
+}
+
+void VectorLane::tickIdle(uint64_t ticks) {
+    // tick() counts the none cmd, update() -> processCMD() finishes it again
+    stat_counters->instructions[CommandVPRO::NONE] += ticks;
+    stat_counters->cycles[CommandVPRO::NONE] += ticks;
+    current_cmd->z += ticks;
+    clock_cycle += long(ticks);
+}
+
 std::shared_ptr<CommandVPRO> VectorLane::getCmd() {
     return current_cmd;
 }
@@ -150,7 +174,7 @@ void VectorLane::check_stall_conditions() {  //kombinatorische
 void VectorLane::fetchCMD() {
     if (current_cmd->is_done()) {  // Get a new command if the "old" is done
         if (new_cmd->is_done()) {
-            new_cmd = vector_unit->getNextCommandForLane(vector_lane_id);
+            new_cmd = vector_unit->getNextCommandForLane(*this);
         }  // if there is already a new cmd fetched...
         if (new_cmd->pipelineALUDepth <
             pipeObj->pipelineALUDepth) {  // check whether to delay the start?
@@ -161,8 +185,9 @@ void VectorLane::fetchCMD() {
                     vector_lane_id);
             });
             pipeObj->pipelineALUDepth--;  // maybe next tick
-            current_cmd = std::make_shared<CommandVPRO>();
-            current_cmd->id_mask = 1u << uint(vector_lane_id);
+            *delay_cmd = CommandVPRO();
+            delay_cmd->id_mask = 1u << uint(vector_lane_id);
+            current_cmd = delay_cmd;
         } else {
             pipeObj->pipelineALUDepth = new_cmd->pipelineALUDepth;
             current_cmd = new_cmd;
@@ -170,26 +195,205 @@ void VectorLane::fetchCMD() {
     }
 }
 
+std::shared_ptr<CommandVPRO> const& VectorLane::nextFetchBuffer() {
+    next_fetch_buffer ^= 1;
+    return fetch_buffers[next_fetch_buffer];
+}
+
 /**
  * process X, Y and Z SEQ
  */
 void VectorLane::processCMD() {
-    current_cmd->x++;
-    if (current_cmd->x > current_cmd->x_end) {
-        current_cmd->x = 0;
-        current_cmd->y++;
-        if (current_cmd->y > current_cmd->y_end) {
-            current_cmd->y = 0;
-            current_cmd->z++;
-            if (current_cmd->z > current_cmd->z_end) {
-                Statistics::get().getVPROStat()->addExecutedCmdQueue(
-                    current_cmd.get(), vector_lane_id);
-                current_cmd->done = true;
+    processCMD(*current_cmd);
+}
+
+void VectorLane::processCMD(CommandVPRO& cmd) {
+    if (Timeline::enabled && cmd.type != CommandVPRO::NONE && cmd.x == 0 && cmd.y == 0 &&
+        cmd.z == 0) {
+        cmd.start_time = Timeline::get().now();
+    }
+    cmd.x++;
+    if (cmd.x > cmd.x_end) {
+        cmd.x = 0;
+        cmd.y++;
+        if (cmd.y > cmd.y_end) {
+            cmd.y = 0;
+            cmd.z++;
+            if (cmd.z > cmd.z_end) {
+                stat_counters->instructions[cmd.type]++;
+                cmd.done = true;
+                if (Timeline::enabled && cmd.type != CommandVPRO::NONE) timelineSpan(cmd);
             }
         }
     }
 }
 
+void VectorLane::timelineSpan(const CommandVPRO& cmd) {
+    timeline_pending.push_back({cmd.type, cmd.issue_time, cmd.start_time});
+    if (functional) timelineWriteback();
+}
+
+void VectorLane::timelineWriteback() {
+    if (timeline_pending.empty()) return;  // finished while the timeline was disabled
+    auto& timeline = Timeline::get();
+    const TimelineCmd& cmd = timeline_pending.front();
+    timeline.span(Timeline::VPRO,
+        uint16_t(vector_unit->cluster_id),
+        timeline.laneTrack(vector_unit->vector_unit_id, vector_lane_id),
+        cmd.type,
+        cmd.start_time,
+        timeline.now(),
+        uint64_t((cmd.start_time - cmd.issue_time) * 1000));
+    timeline_pending.pop_front();
+}
+
+void VectorLane::saveCheckpoint(QDataStream& out) const {
+    regFile.saveCheckpoint(out);
+    Checkpoint::write(out, pipeObj->accu);
+    Checkpoint::write(out, pipeObj->minmax_index);
+    Checkpoint::write(out, pipeObj->minmax_value);
+    Checkpoint::write(out, clock_cycle);
+}
+
+void VectorLane::restoreCheckpoint(QDataStream& in) {
+    regFile.restoreCheckpoint(in);
+    Checkpoint::read(in, pipeObj->accu);
+    Checkpoint::read(in, pipeObj->minmax_index);
+    Checkpoint::read(in, pipeObj->minmax_value);
+    Checkpoint::read(in, clock_cycle);
+}
+
+bool VectorLane::isFunctionalReady(CommandVPRO& cmd) {
+    if (is_indirect_addr(cmd.src1) && !get_lane_from_src(cmd.src1).hasChainData()) return false;
+    if (is_indirect_addr(cmd.src2) && !get_lane_from_src(cmd.src2).hasChainData()) return false;
+    if (is_indirect_addr(cmd.dst) && !get_lane_from_src(cmd.dst).hasChainData()) return false;
+
+    if (isLSLane()) {
+        if (cmd.isWriteLM()) {
+            if (!vector_unit->getLanes()[cmd.dst.gamma]->hasChainData()) return false;
+        } else if (cmd.dst.chain_ls) {
+            if (cmd.dst.chain_left &&
+                !vector_unit->getLeftNeighbor()->getLSLane().hasChainData())
+                return false;
+            if (cmd.dst.chain_right &&
+                !vector_unit->getRightNeighbor()->getLSLane().hasChainData())
+                return false;
+        }
+        if (cmd.isLoad() && is_src_chaining(cmd.src2) &&
+            !get_lane_from_src(cmd.src2).hasChainData())
+            return false;
+    } else {
+        if (is_src_chaining(cmd.src1) && !get_lane_from_src(cmd.src1).hasChainData())
+            return false;
+        if (is_src_chaining(cmd.src2) && !get_lane_from_src(cmd.src2).hasChainData())
+            return false;
+    }
+    return true;
+}
+
+void VectorLane::startFunctional(const CommandVPRO& cmd) {
+    functional_cmd = cmd;
+    functional_active = true;
+    // fetchCMD(): a lower pipeline depth is reached by one none cycle per stage
+    if (int(cmd.pipelineALUDepth) < pipeObj->pipelineALUDepth)
+        functional_slot += pipeObj->pipelineALUDepth - int(cmd.pipelineALUDepth);
+    pipeObj->pipelineALUDepth = int(cmd.pipelineALUDepth);
+}
+
+bool VectorLane::tickFunctional() {
+    bool progress = false;
+    while (functional_active && isFunctionalReady(functional_cmd)) {
+        retireFunctionalWrites();
+        stat_counters->cycles[functional_cmd.type]++;
+        pipeObj->executeElement(*this, functional_cmd);
+        functional_slot++;
+        clock_cycle++;
+        processCMD(functional_cmd);
+        progress = true;
+        if (functional_cmd.is_done()) {
+            functional_active = false;
+            // next command is issued once the blocking one left the first stages
+            if (functional_cmd.blocking) drainFunctional();
+        }
+    }
+    return progress;
+}
+
+void VectorLane::drainFunctional() {
+    for (size_t i = 0; i < functional_writes_count; i++) {
+        commitFunctionalWrite(
+            functional_writes[(functional_writes_head + i) % functional_writes.size()]);
+    }
+}
+
+void VectorLane::delayRegisterWrite(const PipelineDate& pipe) {
+    if (functional_writes_count == functional_writes.size()) {
+        printf_error("Functional execution: register write window overflow!\n");
+        exit(EXIT_FAILURE);
+    }
+    auto& write = functional_writes[(functional_writes_head + functional_writes_count) %
+                                    functional_writes.size()];
+    functional_writes_count++;
+    write.slot = functional_slot + pipeObj->pipelineALUDepth + 3;
+    write.rf_addr = pipe.rf_addr;
+    write.data = pipe.data;
+    write.flag_update = pipe.cmd->flag_update;
+    write.flag[0] = pipe.flag[0];
+    write.flag[1] = pipe.flag[1];
+    write.committed = false;
+}
+
+void VectorLane::commitFunctionalWrite(FunctionalWrite& write) {
+    if (write.committed) return;
+    regFile.set_rf_data(write.rf_addr, write.data);
+    if (write.flag_update) {
+        regFile.set_rf_flag(write.rf_addr, 0, write.flag[0]);
+        regFile.set_rf_flag(write.rf_addr, 1, write.flag[1]);
+    }
+    write.committed = true;
+}
+
+void VectorLane::retireFunctionalWrites() {
+    while (functional_writes_count > 0 &&
+           functional_writes[functional_writes_head].slot <= functional_slot) {
+        commitFunctionalWrite(functional_writes[functional_writes_head]);
+        functional_writes_head = (functional_writes_head + 1) % functional_writes.size();
+        functional_writes_count--;
+    }
+}
+
+void VectorLane::checkFunctionalHazard(int rf_addr) {
+    for (size_t i = 0; i < functional_writes_count; i++) {
+        if (functional_writes[(functional_writes_head + i) % functional_writes.size()].rf_addr ==
+            rf_addr) {
+            functional_hazards++;
+            return;
+        }
+    }
+}
+
+void VectorLane::pushChain(const std::tuple<word_t, bool, bool>& data) {
+    if (functional)
+        functional_chain.push_back(data);
+    else
+        fifo.push(data);
+}
+
+std::tuple<word_t, bool, bool> VectorLane::popChain() {
+    if (!functional) return fifo.pop();
+    auto data = functional_chain[functional_chain_head++];
+    if (functional_chain_head == functional_chain.size()) {  // keeps the capacity
+        functional_chain.clear();
+        functional_chain_head = 0;
+    }
+    return data;
+}
+
+bool VectorLane::hasChainData() const {
+    if (functional) return functional_chain_head < functional_chain.size();
+    return !fifo._is_empty();
+}
+
 /**
      * clock tick to process lanes command/pipeline
      */
@@ -201,26 +405,26 @@ void VectorLane::tick() {
     //*********************************************
 
     if (!adr_lane_stall && !src_lane_stall && !dst_lane_stall) {  // run all
-        Statistics::get().getVPROStat()->addExecutedCmdTick(current_cmd.get(), vector_lane_id);
+        stat_counters->cycles[current_cmd->type]++;
         pipeObj->process(current_cmd);
         pipeObj->tick_pipeline(
             *this, 0, 5 + pipeObj->pipelineALUDepth + 1);  // execute ALL pipeline stages
     } else if (adr_lane_stall && !src_lane_stall && !dst_lane_stall) {  // run from stage 3
-        Statistics::get().getVPROStat()->addExecutedCmdTick(noneCmd.get(), vector_lane_id);
+        stat_counters->cycles[noneCmd->type]++;
         int from = chain_target_stage;
         pipeObj->processInStall(from);
         pipeObj->tick_pipeline(
             *this, from, 4 + pipeObj->pipelineALUDepth + 1);  // execute later pipeline stages
     } else if (src_lane_stall && !adr_lane_stall && !dst_lane_stall) {  // run from src if SRC wait
-        Statistics::get().getVPROStat()->addExecutedCmdTick(noneCmd.get(), vector_lane_id);
+        stat_counters->cycles[noneCmd->type]++;
         int from = chain_target_stage + 1;  // 3+1=4 the "fifth" pipeline stage
         pipeObj->processInStall(from);
         pipeObj->tick_pipeline(
             *this, from, 5 + pipeObj->pipelineALUDepth + 1);  // execute later pipeline stages
     } else if (src_lane_stall && dst_lane_stall) {            // run nothing if both stall
-        Statistics::get().getVPROStat()->addExecutedCmdTick(noneCmd.get(), vector_lane_id);
+        stat_counters->cycles[noneCmd->type]++;
     } else if (!src_lane_stall && dst_lane_stall) {  // run nothing if DST stall
-        Statistics::get().getVPROStat()->addExecutedCmdTick(noneCmd.get(), vector_lane_id);
+        stat_counters->cycles[noneCmd->type]++;
     }
 
     //*********************************************
@@ -228,7 +432,7 @@ void VectorLane::tick() {
     //*********************************************
 
     if (!dst_lane_stall) {  // run later part! (all)
-        (*pipeObj)[5 + pipeObj->pipelineALUDepth + 1].cmd->blocking = false;
+        (*pipeObj)[5 + pipeObj->pipelineALUDepth + 1].blocking = false;
     }
 }
 /**
@@ -348,14 +552,14 @@ std::tuple<word_t, bool, bool> VectorLane::get_operand(
         case SRC_SEL_INDIRECT_LS:
         case SRC_SEL_INDIRECT_LEFT:
         case SRC_SEL_INDIRECT_RIGHT:
-        case SRC_SEL_ADDR:
-            op_data =
-                regFile.get_rf_data(src.offset + src.alpha * x + src.beta * y + src.gamma * z);
-            z_flag =
-                regFile.get_rf_flag(src.offset + src.alpha * x + src.beta * y + src.gamma * z, 0);
-            n_flag =
-                regFile.get_rf_flag(src.offset + src.alpha * x + src.beta * y + src.gamma * z, 1);
+        case SRC_SEL_ADDR: {
+            int rf_addr = int(src.offset + src.alpha * x + src.beta * y + src.gamma * z);
+            if (functional) checkFunctionalHazard(rf_addr);
+            op_data = regFile.get_rf_data(rf_addr);
+            z_flag = regFile.get_rf_flag(rf_addr, 0);
+            n_flag = regFile.get_rf_flag(rf_addr, 1);
             break;
+        }
         case SRC_SEL_IMM:
             op_data = src.getImm();
             if (uint8_t(op_data >> ISA_COMPLEX_LENGTH_3D) >
@@ -370,10 +574,10 @@ std::tuple<word_t, bool, bool> VectorLane::get_operand(
         case SRC_SEL_LS:
             if (isLSLane()) {  // LS store data
                 get_operand_debug_chaining_msg(*vector_unit->getLanes()[src.gamma]);
-                std::tie(op_data, z_flag, n_flag) = vector_unit->getLanes()[src.gamma]->fifo.pop();
+                std::tie(op_data, z_flag, n_flag) = vector_unit->getLanes()[src.gamma]->popChain();
             } else {  // processing lane
                 get_operand_debug_chaining_msg(get_lane_from_src(src));
-                std::tie(op_data, z_flag, n_flag) = get_lane_from_src(src).fifo.pop();
+                std::tie(op_data, z_flag, n_flag) = get_lane_from_src(src).popChain();
             }
             break;
         default:
@@ -412,10 +616,10 @@ void VectorLane::print_pipeline(const QString prefix) {
             printf(ORANGE);
         } else {
             int cmd_vector_pos =
-                (*pipeObj)[stage].cmd->z *
+                (*pipeObj)[stage].z *
                     (((*pipeObj)[stage].cmd->x_end + 1) * ((*pipeObj)[stage].cmd->y_end + 1)) +
-                (*pipeObj)[stage].cmd->y * ((*pipeObj)[stage].cmd->x_end + 1) +
-                (*pipeObj)[stage].cmd->x;
+                (*pipeObj)[stage].y * ((*pipeObj)[stage].cmd->x_end + 1) +
+                (*pipeObj)[stage].x;
             if (src_lane_stall || dst_lane_stall) printf("\e[100m");
             if (cmd_vector_pos == 0) printf("\e[44m");
             printf("%3i ", cmd_vector_pos);
@@ -431,8 +635,9 @@ void VectorLane::print_pipeline(const QString prefix) {
     if (src_lane_stall) printf("  STALL_SRC ");
     printf("\n");
     printf(RESET_COLOR);
-    if (vector_unit->cluster_id == VPRO_CFG::CLUSTERS - 1 &&
-        vector_unit->vector_unit_id == VPRO_CFG::UNITS - 1 && vector_lane_id == VPRO_CFG::LANES)
+    const HWConfig& hw = vector_unit->hw;
+    if (vector_unit->cluster_id == int(hw.clusters) - 1 &&
+        vector_unit->vector_unit_id == int(hw.units) - 1 && vector_lane_id == int(hw.lanes))
         printf("\n");
 }
 
@@ -26,6 +26,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <array>
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,6 +41,8 @@
 #include "../RegisterFile.h"
 #include "Pipeline.h"
 
+struct VproLaneCounters;
+
 namespace Unit {
 
 // to be included in cpp
@@ -89,6 +93,64 @@ class VectorLane {
 
     bool isBlocking() const;
 
+    /**
+     * lane without any command (queue, pipeline, chaining) and without stalls.
+     * a tick in this state only increments counters (see tickIdle)
+     */
+    bool isIdle() const;
+
+    /**
+     * equivalent to ticks times tick() + update() while isIdle()
+     * @param ticks number of skipped vpro clock ticks
+     */
+    void tickIdle(uint64_t ticks);
+
+    /**
+     * functional execution (sim_init argument --functional): evaluates the elements of
+     * functional_cmd directly against RF / LM until it is done or a chaining source has no data.
+     * register writes become visible after the pipeline latency of a stall free issue
+     * @return whether any element has been evaluated
+     */
+    bool tickFunctional();
+
+    /**
+     * functional execution: cmd (copy) becomes functional_cmd, pipeline depth changes are
+     * delayed as in fetchCMD()
+     */
+    void startFunctional(const CommandVPRO& cmd);
+
+    /**
+     * functional execution: no further command for this lane, commits the pending register writes
+     * (they stay in the hazard window until their slot is reached)
+     */
+    void drainFunctional();
+
+    // functional execution: register write of pipe becomes visible to the element slot that
+    // reads it after the write back stage (read in stage 4, written in stage 5 + depth + 1)
+    void delayRegisterWrite(const PipelineDate& pipe);
+
+    // chaining output (fifo, in functional execution an unbounded buffer)
+    void pushChain(const std::tuple<word_t, bool, bool>& data);
+    std::tuple<word_t, bool, bool> popChain();
+    bool hasChainData() const;
+
+    // functional execution is used instead of tick() / update() (VectorUnit::setFunctional)
+    bool functional{false};
+    // functional execution: current command (own copy with the x/y/z position)
+    CommandVPRO functional_cmd;
+    bool functional_active{false};
+    // functional execution: index of the next command for this lane in the units queue
+    size_t functional_next{0};
+    // functional execution: register reads of an address written inside the hazard window
+    // (result depends on the pipeline timing, may differ from the cycle model)
+    uint64_t functional_hazards{0};
+
+    /**
+     * simulator checkpoint of an idle lane (isIdle): register file, accu, min/max and cycle counter
+     */
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
     VectorLane& getLeftNeighbor() const {
         return *left_lane;
     }
@@ -99,6 +161,11 @@ class VectorLane {
         return *ls_lane;
     }
 
+    // counters of this lane in StatisticVpro (bound on its creation)
+    void setStatCounters(VproLaneCounters* counters) {
+        stat_counters = counters;
+    }
+
     void setNeighbors(std::shared_ptr<VectorLane> left,
         std::shared_ptr<VectorLane> right,
         std::shared_ptr<VectorLane> ls) {
@@ -128,7 +195,15 @@ class VectorLane {
 
     void print_pipeline(const QString prefix = "");
     void fetchCMD();
+    // preallocated object for the next fetched command (own copy of the units queue entry)
+    std::shared_ptr<CommandVPRO> const& nextFetchBuffer();
     void processCMD();
+    void processCMD(CommandVPRO& cmd);
+    // span of a finished command (Timeline::enabled), ends with the write back of its last element
+    // (timelineWriteback()); functional execution has no pipeline, the span ends with the command
+    void timelineSpan(const CommandVPRO& cmd);
+    // last element of the oldest finished command in the write back stage
+    void timelineWriteback();
 
     uint64_t* getAccu() {
         return &(pipeObj->accu);
@@ -137,6 +212,13 @@ class VectorLane {
    protected:
     long clock_cycle;
 
+    // timeline: finished commands with elements in the pipeline, in order of completion
+    struct TimelineCmd {
+        CommandVPRO::TYPE type;
+        double issue_time, start_time;
+    };
+    std::deque<TimelineCmd> timeline_pending;
+
     int consecutive_DST_stall_counter;
     int consecutive_SRC_stall_counter;
     int consecutive_ADR_stall_counter;
@@ -144,6 +226,10 @@ class VectorLane {
     // reference to parent vector unit (needed for local mem and cmd queue acccess)
     VectorUnit* vector_unit;
     std::shared_ptr<CommandVPRO> current_cmd, new_cmd, noneCmd;
+    // fetched commands, used alternating (current_cmd may still refer to the previous one),
+    // none command inserted while the pipeline depth decreases
+    std::shared_ptr<CommandVPRO> fetch_buffers[2], delay_cmd;
+    int next_fetch_buffer{0};
 
     bool blocking, blocking_nxt;
 
@@ -154,6 +240,8 @@ class VectorLane {
 
     std::unique_ptr<PipeObject> pipeObj;
 
+    VproLaneCounters* stat_counters{};
+
     // flag whether to stall, waiting for src lane chaining output to become rdy
     bool src_lane_stall;
     // flag whether to stall, waiting for src lane chaining offset to become rdy
@@ -180,6 +268,30 @@ class VectorLane {
    private:
     bool additional_check();
 
+    // functional execution: register writes in the pipeline (ring), element slot of the lane
+    struct FunctionalWrite {
+        uint64_t slot;  // first element slot reading the written value
+        int rf_addr;
+        uint32_t data;
+        bool flag_update;
+        bool flag[2];
+        bool committed;
+    };
+    std::array<FunctionalWrite, 5 + CommandVPRO::MAX_ALU_DEPTH + 2> functional_writes{};
+    size_t functional_writes_head{0};
+    size_t functional_writes_count{0};
+    uint64_t functional_slot{0};
+    std::vector<std::tuple<word_t, bool, bool>> functional_chain;
+    size_t functional_chain_head{0};
+
+    void commitFunctionalWrite(FunctionalWrite& write);
+    // commits the writes visible to the current slot and removes them from the hazard window
+    void retireFunctionalWrites();
+    void checkFunctionalHazard(int rf_addr);
+
+    // chain inputs available and chain output fillable (same conditions as the stall checks)
+    bool isFunctionalReady(CommandVPRO& cmd);
+
     void updateDebugMsg();
     void check_stall_conditions_msg(const int pipeline_src_read_stage);
     void check_stall_conditions_msg1() const;
@@ -10,6 +10,7 @@
  */
 #include <tuple>
 #include "../../../simulator/helper/debugHelper.h"
+#include "../../../simulator/hwConfig.h"
 #include "../../../simulator/helper/typeConversion.h"
 #include "../Cluster.h"
 #include "VectorLane.h"
@@ -29,7 +30,7 @@ void VectorLane::updateDebugMsg() {
             printf("\tCMD: NONE \n");
         } else {
             printf("\tCMD: ");
-            print_cmd((*pipeObj)[0].cmd.get());
+            print_cmd((*pipeObj)[0].cmd);
         }
     }
     if (if_debug(DEBUG_PIPELINE) && additional_check()) {
@@ -53,8 +54,8 @@ void VectorLane::updateDebugMsg() {
                 printf("C%2i U%2i LS", vector_unit->cluster_id, vector_unit->vector_unit_id);
                 printf("\t");
                 pipe.cmd->print_type();
-                int cmd_vector_pos = pipe.cmd->z * (pipe.cmd->x_end + 1) * (pipe.cmd->y_end + 1) +
-                                     pipe.cmd->y * (pipe.cmd->x_end + 1) + pipe.cmd->x + 1;
+                int cmd_vector_pos = pipe.z * (pipe.cmd->x_end + 1) * (pipe.cmd->y_end + 1) +
+                                     pipe.y * (pipe.cmd->x_end + 1) + pipe.x + 1;
                 int cmd_vector_length =
                     (pipe.cmd->x_end + 1) * (pipe.cmd->y_end + 1) * (pipe.cmd->z_end + 1);
                 printf("%2i/%2i", cmd_vector_pos, cmd_vector_length);
@@ -88,8 +89,8 @@ void VectorLane::updateDebugMsg() {
                     vector_lane_id);
                 printf("\t");
                 pipe.cmd->print_type();
-                int cmd_vector_pos = pipe.cmd->z * (pipe.cmd->x_end + 1) * (pipe.cmd->y_end + 1) +
-                                     pipe.cmd->y * (pipe.cmd->x_end + 1) + pipe.cmd->x + 1;
+                int cmd_vector_pos = pipe.z * (pipe.cmd->x_end + 1) * (pipe.cmd->y_end + 1) +
+                                     pipe.y * (pipe.cmd->x_end + 1) + pipe.x + 1;
                 int cmd_vector_length =
                     (pipe.cmd->x_end + 1) * (pipe.cmd->y_end + 1) * (pipe.cmd->z_end + 1);
                 printf("%2i/%2i", cmd_vector_pos, cmd_vector_length);
@@ -100,9 +101,9 @@ void VectorLane::updateDebugMsg() {
                         get_lane_from_src(pipe.cmd->src1).vector_lane_id);
                 else
                     printf_info("\tOPA[%4i]=",
-                        (pipe.cmd->src1.offset + pipe.cmd->src1.alpha * pipe.cmd->x +
-                            pipe.cmd->src1.beta * pipe.cmd->y +
-                            pipe.cmd->src1.gamma * pipe.cmd->z));
+                        (pipe.src1_offset + pipe.cmd->src1.alpha * pipe.x +
+                            pipe.cmd->src1.beta * pipe.y +
+                            pipe.cmd->src1.gamma * pipe.z));
                 if (vector_lane_id == 0) printf("\e[48;5;235m");
                 if (vector_lane_id == 1) printf("\e[48;5;238m");
                 printf_info("%9i (0x%08x)\t", int(pipe.opa), pipe.opa);
@@ -115,9 +116,9 @@ void VectorLane::updateDebugMsg() {
                         get_lane_from_src(pipe.cmd->src2).vector_lane_id);
                 else
                     printf_info("OPB[%4i]=",
-                        (pipe.cmd->src2.offset + pipe.cmd->src2.alpha * pipe.cmd->x +
-                            pipe.cmd->src2.beta * pipe.cmd->y +
-                            pipe.cmd->src2.gamma * pipe.cmd->z));
+                        (pipe.src2_offset + pipe.cmd->src2.alpha * pipe.x +
+                            pipe.cmd->src2.beta * pipe.y +
+                            pipe.cmd->src2.gamma * pipe.z));
                 if (vector_lane_id == 0) printf("\e[48;5;235m");
                 if (vector_lane_id == 1) printf("\e[48;5;238m");
                 printf_info("%9i (0x%08x)\t", int(pipe.opb), pipe.opb);
@@ -126,9 +127,9 @@ void VectorLane::updateDebugMsg() {
 
                 if (pipe.cmd->type == CommandVPRO::MACL || pipe.cmd->type == CommandVPRO::MACH) {
                     printf_info("OPC[%4i]=",
-                        (pipe.cmd->src1.offset + pipe.cmd->src1.alpha * pipe.cmd->x +
-                            pipe.cmd->src1.beta * pipe.cmd->y +
-                            pipe.cmd->src1.gamma * pipe.cmd->z));
+                        (pipe.src1_offset + pipe.cmd->src1.alpha * pipe.x +
+                            pipe.cmd->src1.beta * pipe.y +
+                            pipe.cmd->src1.gamma * pipe.z));
                     if (vector_lane_id == 0) printf("\e[48;5;235m");
                     if (vector_lane_id == 1) printf("\e[48;5;238m");
                     printf_info("%9i (0x%08x)\t", int(pipe.opc), pipe.opc);
@@ -230,17 +231,17 @@ void VectorLane::updateDebugMsg() {
             QMap<int, QString> writtenRFs;
             for (int j = chain_target_stage + 1; j <= 5 + pipeObj->pipelineALUDepth; ++j) {
                 if ((*pipeObj)[j].cmd->isWriteRF())
-                    writtenRFs[(*pipeObj)[j].cmd->dst.offset +
-                               (*pipeObj)[j].cmd->dst.alpha * (*pipeObj)[j].cmd->x +
-                               (*pipeObj)[j].cmd->dst.beta * (*pipeObj)[j].cmd->y +
-                               (*pipeObj)[i].cmd->dst.gamma * (*pipeObj)[i].cmd->z] =
+                    writtenRFs[(*pipeObj)[j].dst_offset +
+                               (*pipeObj)[j].cmd->dst.alpha * (*pipeObj)[j].x +
+                               (*pipeObj)[j].cmd->dst.beta * (*pipeObj)[j].y +
+                               (*pipeObj)[i].cmd->dst.gamma * (*pipeObj)[i].z] =
                         (*pipeObj)[j].cmd->get_string();
             }
             if ((*pipeObj)[i].cmd->src1.sel == SRC_SEL_ADDR) {
-                int rf_addr1 = (*pipeObj)[i].cmd->src1.offset +
-                               (*pipeObj)[i].cmd->src1.alpha * (*pipeObj)[i].cmd->x +
-                               (*pipeObj)[i].cmd->src1.beta * (*pipeObj)[i].cmd->y +
-                               (*pipeObj)[i].cmd->src1.gamma * (*pipeObj)[i].cmd->z;
+                int rf_addr1 = (*pipeObj)[i].src1_offset +
+                               (*pipeObj)[i].cmd->src1.alpha * (*pipeObj)[i].x +
+                               (*pipeObj)[i].cmd->src1.beta * (*pipeObj)[i].y +
+                               (*pipeObj)[i].cmd->src1.gamma * (*pipeObj)[i].z;
                 if (writtenRFs.count(rf_addr1) > 0) {
                     printf_warning("Write to RF after Read (WAR conflict!?)\n");
                     printf_warning(
@@ -252,10 +253,10 @@ void VectorLane::updateDebugMsg() {
                 }
             }
             if ((*pipeObj)[i].cmd->src2.sel == SRC_SEL_ADDR) {
-                int rf_addr2 = (*pipeObj)[i].cmd->src2.offset +
-                               (*pipeObj)[i].cmd->src2.alpha * (*pipeObj)[i].cmd->x +
-                               (*pipeObj)[i].cmd->src2.beta * (*pipeObj)[i].cmd->y +
-                               (*pipeObj)[i].cmd->src2.gamma * (*pipeObj)[i].cmd->z;
+                int rf_addr2 = (*pipeObj)[i].src2_offset +
+                               (*pipeObj)[i].cmd->src2.alpha * (*pipeObj)[i].x +
+                               (*pipeObj)[i].cmd->src2.beta * (*pipeObj)[i].y +
+                               (*pipeObj)[i].cmd->src2.gamma * (*pipeObj)[i].z;
                 if (writtenRFs.count(rf_addr2) > 0) {
                     printf_warning("Write to RF after Read (WAR conflict!?)\n");
                     printf_warning(
@@ -423,7 +424,7 @@ void VectorLane::dumpRegisterFile(std::string prefix) {
     printf("DUMP Register File (Vector Lane %i):\n", vector_lane_id);
     printf(LGREEN);
     int printLast = 0;
-    for (int r = 0; r < VPRO_CFG::RF_SIZE * 3; r += 16 * 3) {  // all elements in 16 element blocks
+    for (int r = 0; r < int(vector_unit->hw.rf_size) * 3; r += 16 * 3) {  // all elements in 16 element blocks
         bool hasData = false;
         for (int s = 0; s <= 15 * 3; s += 3) {  // each of the 16 blocks
             auto data = ((uint32_t)(rf_data[r + s]) + (uint32_t)(rf_data[r + s + 1] << 8) +
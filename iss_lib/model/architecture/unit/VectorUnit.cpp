@@ -14,7 +14,10 @@
 #include <QString>
 
 #include "../../../simulator/ISS.h"
+#include "../../../simulator/hwConfig.h"
+#include "../../../simulator/helper/checkpoint.h"
 #include "../../../simulator/helper/debugHelper.h"
+#include "../../../simulator/helper/timeline.h"
 #include "../../../simulator/helper/typeConversion.h"
 #include "VectorUnit.h"
 
@@ -23,16 +26,19 @@ namespace Unit {
 VectorUnit::VectorUnit(int id,
     int cluster_id,
     double& time,
-    std::shared_ptr<ArchitectureState> architecture_state)
+    std::shared_ptr<ArchitectureState> architecture_state,
+    const HWConfig& hw)
     : cluster_id(cluster_id),
+      hw(hw),
       time(time) {
     vector_unit_id = id;
 
     // LM interpretated in 24-bit segments
-    local_memory = new uint8_t[VPRO_CFG::LM_SIZE * (LOCAL_MEMORY_DATA_WIDTH / 8)]();
+    local_memory = new uint8_t[hw.lm_size * (LOCAL_MEMORY_DATA_WIDTH / 8)]();
 
     // create regular Lanes
-    for (int i = 0; i < VPRO_CFG::LANES; i++) {
+    const int lane_count = int(hw.lanes);
+    for (int i = 0; i < lane_count; i++) {
         lanes.push_back(std::make_shared<VectorLane>(
             i, this, architecture_state));
     }
@@ -41,23 +47,27 @@ VectorUnit::VectorUnit(int id,
     lanes.push_back(ls_lane);
 
     // set neighbor info to all Lanes
-    lanes[0]->setNeighbors(lanes[VPRO_CFG::LANES - 1], lanes[1], lanes.back());
-    for (int i = 1; i < VPRO_CFG::LANES - 1; i++) {
+    lanes[0]->setNeighbors(lanes[lane_count - 1], lanes[1], lanes.back());
+    for (int i = 1; i < lane_count - 1; i++) {
         lanes[i]->setNeighbors(lanes[i - 1], lanes[i + 1], ls_lane);
     }
-    lanes[VPRO_CFG::LANES - 1]->setNeighbors(lanes[VPRO_CFG::LANES - 2], lanes[0], ls_lane);
-    lanes.back()->setNeighbors(lanes[0], lanes[VPRO_CFG::LANES - 1], ls_lane);  // this is LS lane
+    lanes[lane_count - 1]->setNeighbors(lanes[lane_count - 2], lanes[0], ls_lane);
+    lanes.back()->setNeighbors(lanes[0], lanes[lane_count - 1], ls_lane);  // this is LS lane
 
     // init commands
     cmd_queue = std::deque<std::shared_ptr<CommandVPRO>>();
     clearCommands();
     noneCmd = std::make_shared<CommandVPRO>();
+    for (int i = 0; i < UNITS_COMMAND_QUEUE_MAX_SIZE + 2; i++) {
+        queue_cmds.push_back(std::make_shared<CommandVPRO>());
+    }
 
     cmdQueueFetchedCmd = false;
+    lane_skipped = std::vector<bool>(lanes.size(), false);
 };
 
 bool VectorUnit::isLaneSelected(CommandVPRO const* cmd, long lane_id) const {
-    if (long(lane_id) > VPRO_CFG::LANES) {  // this is L/S lane check
+    if (lane_id > long(hw.lanes)) {  // this is L/S lane check
         return cmd->isLS();
     }
 
@@ -80,35 +90,67 @@ bool VectorUnit::trySendCMD(const std::shared_ptr<CommandVPRO>& cmd) {
         return false;
     }
 
-    cmd_queue.push_back(cmd);
+    // own copy, the lanes fetch copies of it -> slot is free again once popped
+    auto& entry = queue_cmds[next_queue_cmd];
+    next_queue_cmd = (next_queue_cmd + 1) % queue_cmds.size();
+    *entry = *cmd;
+    if (Timeline::enabled) entry->issue_time = time;
+    cmd_queue.push_back(entry);
 
     return true;
 }
 
 void VectorUnit::clearCommands() {
     cmd_queue.clear();
+    for (auto lane : lanes) {
+        lane->functional_next = 0;
+    }
 }
 
 void VectorUnit::tick() {
-    // cascade
-    for (auto lane : lanes) {
-        lane->tick();
+    // cascade (idle lanes are accounted in update)
+    all_lanes_skipped = true;
+    for (size_t i = 0; i < lanes.size(); i++) {
+        lane_skipped[i] = isLaneSkippable(*lanes[i]);
+        all_lanes_skipped &= lane_skipped[i];
+    }
+    if (all_lanes_skipped) return;
+    for (size_t i = 0; i < lanes.size(); i++) {
+        if (!lane_skipped[i]) lanes[i]->tick();
     }
 }
 
 void VectorUnit::update() {
     cmdQueueFetchedCmd = false;  // enable fetch of one new command in this cycle
-    for (auto lane : lanes) {
-        lane->update();
+    if (all_lanes_skipped) {
+        tickIdle(1);
+        return;
+    }
+    for (size_t i = 0; i < lanes.size(); i++) {
+        if (lane_skipped[i])
+            lanes[i]->tickIdle(1);
+        else
+            lanes[i]->update();
     }
 }
 
+bool VectorUnit::isLaneSkippable(VectorLane& lane) const {
+    if (!SKIP_IDLE_LANE_TICKS) return false;
+    if (debug & (DEBUG_INSTRUCTIONS | DEBUG_PIPELINE | DEBUG_PIPELINE_9 | DEBUG_FIFO_MSG |
+                    DEBUG_LANE_STALLS))
+        return false;
+    if (!lane.isIdle() || !lane.fifo._is_empty()) return false;
+    // fetches the front command in update
+    return cmd_queue.empty() || !isLaneSelected(cmd_queue.front().get(), lane.vector_lane_id);
+}
+
 /**
  * gets command for the lane to process. all lane command queues should be at the same state for x/y/is_done ...
  * @param id Lane
  * @return
  */
-std::shared_ptr<CommandVPRO> VectorUnit::getNextCommandForLane(int id) {
+std::shared_ptr<CommandVPRO> VectorUnit::getNextCommandForLane(VectorLane& lane) {
+    const int id = lane.vector_lane_id;
     if (cmdQueueFetchedCmd) {  // FIFO can only fetch front cmd
         return noneCmd;
     }
@@ -117,11 +159,11 @@ std::shared_ptr<CommandVPRO> VectorUnit::getNextCommandForLane(int id) {
         return noneCmd;
     }
 
-    for (auto lane : lanes) {
+    for (auto const& lane : lanes) {
         if (lane->isBlocking()) return noneCmd;
     }
 
-    auto cmd = cmd_queue.front();
+    auto const& cmd = cmd_queue.front();
     if (isLaneSelected(cmd.get(), id)) {
         // Check minimal vector length + print warning
         if (checkVectorPipelineLength && cmd->fu_sel != CLASS_OTHER && cmd->x == cmd->x_end &&
@@ -137,17 +179,17 @@ std::shared_ptr<CommandVPRO> VectorUnit::getNextCommandForLane(int id) {
             }
         }
 
-        cmd_queue.front()->id_mask &= ~(1u << uint(id));
+        cmd->id_mask &= ~(1u << uint(id));
         // unset the mask bit for this unit so this command dont get assigned to it again
-        if (cmd_queue.front()->id_mask == 0) {
+        auto const& lane_cmd = lane.nextFetchBuffer();
+        *lane_cmd = *cmd;
+        if (cmd->id_mask == 0) {
             // if assigned to all lanes it should be poped from queue
             cmd_queue.pop_front();
             cmdQueueFetchedCmd = true;
-            cmd->id_mask |= (1u << uint(id));
-            return cmd;
-        } else {
-            return std::make_shared<CommandVPRO>(cmd.get());
+            lane_cmd->id_mask |= (1u << uint(id));
         }
+        return lane_cmd;
     }
 
     return noneCmd;
@@ -155,7 +197,7 @@ std::shared_ptr<CommandVPRO> VectorUnit::getNextCommandForLane(int id) {
 
 uint32_t VectorUnit::getLocalMemoryData(const uint32_t addr, const int size) {
     if (addr * (LOCAL_MEMORY_DATA_WIDTH / 8) + size >
-        VPRO_CFG::LM_SIZE * (LOCAL_MEMORY_DATA_WIDTH / 8)) {
+        hw.lm_size * (LOCAL_MEMORY_DATA_WIDTH / 8)) {
         printf_error("Read from Local Memory out of Range! (addr: %d, size: %d)\n", addr, size);
         return 0;
     }
@@ -166,7 +208,7 @@ uint32_t VectorUnit::getLocalMemoryData(const uint32_t addr, const int size) {
 }
 
 void VectorUnit::writeLocalMemoryData(const uint32_t addr, const uint32_t data, const int size) {
-    if (addr + (LOCAL_MEMORY_DATA_WIDTH / 8) > VPRO_CFG::LM_SIZE * (LOCAL_MEMORY_DATA_WIDTH / 8)) {
+    if (addr + (LOCAL_MEMORY_DATA_WIDTH / 8) > hw.lm_size * (LOCAL_MEMORY_DATA_WIDTH / 8)) {
         printf_error("Write to Local Memory out of Range! (addr: %d)\n", addr);
         return;
     }
@@ -182,9 +224,9 @@ void VectorUnit::writeLocalMemoryData(const uint32_t addr, const uint32_t data,
 
 void VectorUnit::writeLocalMemoryData(const uint32_t& addr, const uint8_t* data, const int size) {
     if (addr * (LOCAL_MEMORY_DATA_WIDTH / 8) + (LOCAL_MEMORY_DATA_WIDTH / 8) >
-        VPRO_CFG::LM_SIZE * (LOCAL_MEMORY_DATA_WIDTH / 8)) {
+        hw.lm_size * (LOCAL_MEMORY_DATA_WIDTH / 8)) {
         printf_error(
-            "Write to Local Memory out of Range! (addr: %d) Max: %i\n", addr, VPRO_CFG::LM_SIZE);
+            "Write to Local Memory out of Range! (addr: %d) Max: %i\n", addr, hw.lm_size);
         return;
     }
     if (size > (LOCAL_MEMORY_DATA_WIDTH / 8)) {
@@ -205,6 +247,83 @@ bool VectorUnit::isBusy() {
     return lanes_busy;
 }
 
+bool VectorUnit::isIdle() {
+    if (!cmd_queue.empty() || cmdQueueFetchedCmd) return false;
+    for (auto lane : lanes) {
+        if (!lane->isIdle()) return false;
+    }
+    return true;
+}
+
+void VectorUnit::tickIdle(uint64_t ticks) {
+    for (auto lane : lanes) {
+        lane->tickIdle(ticks);
+    }
+}
+
+void VectorUnit::setFunctional(bool enable) {
+    for (auto lane : lanes) {
+        lane->functional = enable;
+    }
+}
+
+bool VectorUnit::tickFunctional() {
+    // each lane runs through the queued commands for it on its own, lanes only exchange data by
+    // chaining (in order). a command is removed once no lane is left to execute it
+    bool progress = false;
+    for (auto lane : lanes) {
+        while (true) {
+            if (!lane->functional_active) {
+                size_t& next = lane->functional_next;
+                while (next < cmd_queue.size() &&
+                       !isLaneSelected(cmd_queue[next].get(), lane->vector_lane_id)) {
+                    next++;
+                }
+                if (next == cmd_queue.size()) break;
+                lane->startFunctional(*cmd_queue[next]);
+                next++;
+            }
+            if (!lane->tickFunctional()) break;  // waits for chaining data
+            progress = true;
+        }
+    }
+
+    auto isFrontDone = [&]() {
+        for (auto lane : lanes) {
+            if (lane->functional_next == 0 ||
+                (lane->functional_next == 1 && lane->functional_active))
+                return false;
+        }
+        return true;
+    };
+    while (!cmd_queue.empty() && isFrontDone()) {
+        cmd_queue.pop_front();
+        for (auto lane : lanes) {
+            lane->functional_next--;
+        }
+    }
+
+    for (auto lane : lanes) {
+        if (!lane->functional_active && lane->functional_next == cmd_queue.size())
+            lane->drainFunctional();
+    }
+    return progress;
+}
+
+void VectorUnit::saveCheckpoint(QDataStream& out) const {
+    Checkpoint::writeArray(out, local_memory, hw.lm_size * (LOCAL_MEMORY_DATA_WIDTH / 8));
+    for (auto lane : lanes) {
+        lane->saveCheckpoint(out);
+    }
+}
+
+void VectorUnit::restoreCheckpoint(QDataStream& in) {
+    Checkpoint::readArray(in, local_memory, hw.lm_size * (LOCAL_MEMORY_DATA_WIDTH / 8));
+    for (auto lane : lanes) {
+        lane->restoreCheckpoint(in);
+    }
+}
+
 // ***********************************************************************
 // Dump local memory to console
 // ***********************************************************************
@@ -213,7 +332,7 @@ void VectorUnit::dumpLocalMemory(const std::string& prefix) {
     printf("DUMP Local Memory (Vector Unit %i):\n", vector_unit_id);
     printf(LGREEN);
     int printLast = 0;
-    for (int l = 0; l < VPRO_CFG::LM_SIZE; l += 32) {
+    for (int l = 0; l < hw.lm_size; l += 32) {
         bool hasData = false;
         for (int m = 0; m <= 31; m++) {
             uint32_t data = getLocalMemoryData(l + m);
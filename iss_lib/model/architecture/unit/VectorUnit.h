@@ -37,6 +37,7 @@
 
 // to be included in cpp
 class Cluster;
+struct HWConfig;
 
 namespace Unit {
 
@@ -47,10 +48,14 @@ class VectorUnit : public IVectorUnit {
     int vector_unit_id;
     int cluster_id;
 
+    // runtime array geometry (lanes, local memory / register file size)
+    const HWConfig& hw;
+
     VectorUnit(int id,
         int cluster_id,
         double& time,
-        std::shared_ptr<ArchitectureState> architecture_state);
+        std::shared_ptr<ArchitectureState> architecture_state,
+        const HWConfig& hw);
 
     void update_stall_conditions();
     void check_stall_conditions();
@@ -92,7 +97,46 @@ class VectorUnit : public IVectorUnit {
 
     bool isBusy();
 
-    std::shared_ptr<CommandVPRO> getNextCommandForLane(int id);
+    /**
+     * no command in queue and all lanes idle (VectorLane::isIdle)
+     */
+    bool isIdle();
+
+    /**
+     * accounts ticks skipped vpro clock cycles while isIdle()
+     */
+    void tickIdle(uint64_t ticks);
+
+    /**
+     * functional execution (sim_init argument --functional) instead of tick() / update()
+     */
+    void setFunctional(bool enable);
+
+    /**
+     * functional execution: each lane evaluates its queued commands (VectorLane::tickFunctional)
+     * until all are done or it waits for chaining data of another lane
+     * @return whether any element has been evaluated
+     */
+    bool tickFunctional();
+
+    void saveCheckpoint(QDataStream& out) const;
+    void restoreCheckpoint(QDataStream& in);
+
+    std::shared_ptr<CommandVPRO> const& getNoneCmd() const {
+        return noneCmd;
+    }
+
+    /**
+     * front command of the queue if it is for this lane, copied into the lanes fetch buffer
+     * (VectorLane::nextFetchBuffer, no allocation). noneCmd if there is none
+     */
+    std::shared_ptr<CommandVPRO> getNextCommandForLane(VectorLane& lane);
+
+    /**
+     * SKIP_IDLE_LANE_TICKS: the lane does not change its state in this cycle except of its counters
+     * (VectorLane::isIdle, chaining fifo empty and it won't fetch the front command of the queue)
+     */
+    bool isLaneSkippable(VectorLane& lane) const;
 
     std::vector<std::shared_ptr<VectorLane>>& getLanes() {
         return lanes;
@@ -120,6 +164,9 @@ class VectorUnit : public IVectorUnit {
 
     // cmd-queue from this unit.
     std::deque<std::shared_ptr<CommandVPRO>> cmd_queue;
+    // preallocated objects of the queue entries (ring, one more than the queue can hold)
+    std::vector<std::shared_ptr<CommandVPRO>> queue_cmds;
+    size_t next_queue_cmd{0};
 
     // reference to time from sim
     double& time;
@@ -131,6 +178,10 @@ class VectorUnit : public IVectorUnit {
 
     //flag to indicate a command was pulled from cmd queue. in hw only once per cycle a cmd is received from queue...
     bool cmdQueueFetchedCmd;
+
+    // SKIP_IDLE_LANE_TICKS: lanes (same index as lanes) not ticked in this cycle, evaluated in tick()
+    std::vector<bool> lane_skipped;
+    bool all_lanes_skipped{false};
 };
 
 }  // namespace Unit
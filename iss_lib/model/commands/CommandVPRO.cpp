@@ -38,6 +38,8 @@ CommandVPRO::CommandVPRO() : CommandBase(VPRO) {
     id_mask = 0xffffffff;
     cluster = 0;
     done = false;
+    issue_time = 0;
+    start_time = 0;
 
     load_offset = 0;
     dst = addr_field_t();
@@ -68,6 +70,8 @@ CommandVPRO::CommandVPRO(CommandVPRO* ref) : CommandBase(ref->class_type) {
     z = ref->z;
     done = ref->done;
     pipelineALUDepth = ref->pipelineALUDepth;
+    issue_time = ref->issue_time;
+    start_time = ref->start_time;
 }
 CommandVPRO::CommandVPRO(CommandVPRO& ref) : CommandBase(ref.class_type) {
     type = ref.type;
@@ -91,6 +95,8 @@ CommandVPRO::CommandVPRO(CommandVPRO& ref) : CommandBase(ref.class_type) {
     z = ref.z;
     done = ref.done;
     pipelineALUDepth = ref.pipelineALUDepth;
+    issue_time = ref.issue_time;
+    start_time = ref.start_time;
 }
 CommandVPRO::CommandVPRO(std::shared_ptr<CommandVPRO> ref) : CommandBase(ref->class_type) {
     type = ref->type;
@@ -114,6 +120,8 @@ CommandVPRO::CommandVPRO(std::shared_ptr<CommandVPRO> ref) : CommandBase(ref->cl
     z = ref->z;
     done = ref->done;
     pipelineALUDepth = ref->pipelineALUDepth;
+    issue_time = ref->issue_time;
+    start_time = ref->start_time;
 }
 
 void CommandVPRO::printType(CommandVPRO::TYPE t, FILE* out) {
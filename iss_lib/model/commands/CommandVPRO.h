@@ -113,6 +113,10 @@ class CommandVPRO : public CommandBase {
 
     bool done;
 
+    // timeline (helper/timeline.h): push to the unit queue, first element in the lane pipeline
+    double issue_time;
+    double start_time;
+
     CommandVPRO();
     CommandVPRO(CommandVPRO* ref);
     CommandVPRO(CommandVPRO& ref);
@@ -34,6 +34,7 @@
 #include "../model/architecture/stats/Statistics.h"
 #include "ISS.h"
 #include "helper/debugHelper.h"
+#include "helper/hostProfile.h"
 
 struct Dmacmd {
     uint32_t data[11];
@@ -190,6 +191,7 @@ void ISS::gen_direct_dma_instruction(const uint8_t dcache_data_struct[32]) {
 }
 
 uint32_t ISS::io_read(uint32_t addr) {
+    trace_depth++;
 #ifdef ISS_STANDALONE
     runUntilRiscReadyForCmd();
 #endif
@@ -276,7 +278,7 @@ uint32_t ISS::io_read(uint32_t addr) {
             value =
                 dcma_stat->dma_access_counter.write_miss_cycles[dma_access_counter_cluster_pointer];
             dma_access_counter_cluster_pointer++;
-            if (dma_access_counter_cluster_pointer == VPRO_CFG::CLUSTERS)
+            if (dma_access_counter_cluster_pointer == hw_config.clusters)
                 dma_access_counter_cluster_pointer = 0;
             break;
         case VPRO_BUSY_MASKED_VPRO_ADDR:
@@ -352,15 +354,15 @@ uint32_t ISS::io_read(uint32_t addr) {
             break;
         }
         case GP_REGISTERS_ADDR + 3 * 4: {
-            value = VPRO_CFG::CLUSTERS;
+            value = hw_config.clusters;
             break;
         }
         case GP_REGISTERS_ADDR + 4 * 4: {
-            value = VPRO_CFG::UNITS;
+            value = hw_config.units;
             break;
         }
         case GP_REGISTERS_ADDR + 5 * 4: {
-            value = VPRO_CFG::LANES;
+            value = hw_config.lanes;
             break;
         }
         case GP_REGISTERS_ADDR + 6 * 4: {
@@ -440,10 +442,23 @@ uint32_t ISS::io_read(uint32_t addr) {
         }  // vpro io access
     }      // io access
 
+    trace_depth--;
+    if (isTracing()) traceIoRead(addr, value);
     return value;
 }
 
+void ISS::io_wait(uint32_t addr, uint32_t mask, bool risc_step) {
+    if (isTracing()) traceIoWait(addr, mask, risc_step);
+    trace_depth++;
+    while ((io_read(addr) & mask) != 0) {
+        if (risc_step) runUntilRiscReadyForCmd();
+    }
+    trace_depth--;
+}
+
 void ISS::io_write(uint32_t addr, uint32_t value) {
+    HostTimer timer(HostProfile::IO_WRITE);
+    trace_depth++;
 #ifdef ISS_STANDALONE
     if ((addr & 0b1) == 0)  // skip special addresses (sim on host -> ext address 64-bit split)
         runUntilRiscReadyForCmd();
@@ -742,35 +757,7 @@ void ISS::io_write(uint32_t addr, uint32_t value) {
             } else {
                 io_dma_cmd_register.ext = intptr_t(value);
             }
-            std::shared_ptr<CommandDMA> cmdp = std::make_shared<CommandDMA>();
-            cmdp->ext_base = io_dma_cmd_register.ext;
-            cmdp->loc_base = io_dma_cmd_register.loc_addr;
-            cmdp->x_size = io_dma_cmd_register.x_size;
-            cmdp->y_size = io_dma_cmd_register.y_size;
-            cmdp->y_leap = io_dma_cmd_register.x_stride;
-            cmdp->pad[0] = io_dma_cmd_register.pad_flags[0];
-            cmdp->pad[1] = io_dma_cmd_register.pad_flags[1];
-            cmdp->pad[2] = io_dma_cmd_register.pad_flags[2];
-            cmdp->pad[3] = io_dma_cmd_register.pad_flags[3];
-            cmdp->cluster_mask = io_dma_cmd_register.cluster_mask;
-            assert(io_dma_cmd_register.unit_mask != 0);
-            for (size_t i = 0; i < VPRO_CFG::UNITS; i++) {
-                if ((io_dma_cmd_register.unit_mask >> i) & 0x1) {
-                    cmdp->unit.append(i);
-                }
-            }
-            if (addr == IDMA_EXT_BASE_ADDR_L2E_ADDR) {
-                if (io_dma_cmd_register.y_size == 1)
-                    cmdp->type = CommandDMA::TYPE::LOC_1D_TO_EXT_1D;
-                else
-                    cmdp->type = CommandDMA::TYPE::LOC_1D_TO_EXT_2D;
-            } else {  // E2L
-                if (io_dma_cmd_register.y_size == 1)
-                    cmdp->type = CommandDMA::TYPE::EXT_1D_TO_LOC_1D;
-                else
-                    cmdp->type = CommandDMA::TYPE::EXT_2D_TO_LOC_1D;
-            }
-            run_dma_instruction(cmdp);
+            run_dma_instruction(gen_io_dma_command(addr == IDMA_EXT_BASE_ADDR_L2E_ADDR));
             io_dma_cmd_register.ext_addr = 0;
             break;
         }
@@ -830,6 +817,41 @@ void ISS::io_write(uint32_t addr, uint32_t value) {
             break;
         }
     }
+
+    trace_depth--;
+    if (isTracing()) traceIoWrite(addr, value);
+}
+
+std::shared_ptr<CommandDMA> ISS::gen_io_dma_command(bool loc_to_ext) const {
+    std::shared_ptr<CommandDMA> cmdp = std::make_shared<CommandDMA>();
+    cmdp->ext_base = io_dma_cmd_register.ext;
+    cmdp->loc_base = io_dma_cmd_register.loc_addr;
+    cmdp->x_size = io_dma_cmd_register.x_size;
+    cmdp->y_size = io_dma_cmd_register.y_size;
+    cmdp->y_leap = io_dma_cmd_register.x_stride;
+    cmdp->pad[0] = io_dma_cmd_register.pad_flags[0];
+    cmdp->pad[1] = io_dma_cmd_register.pad_flags[1];
+    cmdp->pad[2] = io_dma_cmd_register.pad_flags[2];
+    cmdp->pad[3] = io_dma_cmd_register.pad_flags[3];
+    cmdp->cluster_mask = io_dma_cmd_register.cluster_mask;
+    assert(io_dma_cmd_register.unit_mask != 0);
+    for (size_t i = 0; i < hw_config.units; i++) {
+        if ((io_dma_cmd_register.unit_mask >> i) & 0x1) {
+            cmdp->unit.append(i);
+        }
+    }
+    if (loc_to_ext) {
+        if (io_dma_cmd_register.y_size == 1)
+            cmdp->type = CommandDMA::TYPE::LOC_1D_TO_EXT_1D;
+        else
+            cmdp->type = CommandDMA::TYPE::LOC_1D_TO_EXT_2D;
+    } else {  // E2L
+        if (io_dma_cmd_register.y_size == 1)
+            cmdp->type = CommandDMA::TYPE::EXT_1D_TO_LOC_1D;
+        else
+            cmdp->type = CommandDMA::TYPE::EXT_2D_TO_LOC_1D;
+    }
+    return cmdp;
 }
 
 std::shared_ptr<CommandVPRO> ISS::gen_io_vpro_command() const {
@@ -915,13 +937,13 @@ void ISS::check_vpro_instruction_length(const std::shared_ptr<CommandVPRO>& comm
 
 void ISS::sim_dump_local_memory(uint32_t cluster, uint32_t unit) {
     if (if_debug(DEBUG_USER_DUMP)) {
-        if (unit > VPRO_CFG::UNITS) {
+        if (unit > hw_config.units) {
             printf_warning(
-                "#SIM_DUMP: Invalid unit selection (%d)!. Maximum is %d.", unit, VPRO_CFG::UNITS);
-        } else if (cluster > VPRO_CFG::CLUSTERS) {
+                "#SIM_DUMP: Invalid unit selection (%d)!. Maximum is %d.", unit, hw_config.units);
+        } else if (cluster > hw_config.clusters) {
             printf_warning("#SIM_DUMP: Invalid cluster selection (%d)!. Maximum is %d.",
                 cluster,
-                VPRO_CFG::CLUSTERS);
+                hw_config.clusters);
         } else {
             printf("#SIM_DUMP: Local memory, cluster=%d unit=%d\n", cluster, unit);
             this->clusters[cluster]->dumpLocalMemory(unit);
@@ -931,13 +953,13 @@ void ISS::sim_dump_local_memory(uint32_t cluster, uint32_t unit) {
 
 void ISS::sim_dump_queue(uint32_t cluster, uint32_t unit) {
     if (if_debug(DEBUG_USER_DUMP)) {
-        if (unit > VPRO_CFG::UNITS) {
+        if (unit > hw_config.units) {
             printf_warning(
-                "#SIM_DUMP: Invalid unit selection (%d)!. Maximum is %d.", unit, VPRO_CFG::UNITS);
-        } else if (cluster > VPRO_CFG::CLUSTERS) {
+                "#SIM_DUMP: Invalid unit selection (%d)!. Maximum is %d.", unit, hw_config.units);
+        } else if (cluster > hw_config.clusters) {
             printf_warning("#SIM_DUMP: Invalid cluster selection (%d)!. Maximum is %d.",
                 cluster,
-                VPRO_CFG::CLUSTERS);
+                hw_config.clusters);
         } else {
             printf("#SIM_DUMP: Local memory, cluster=%d unit=%d\n", cluster, unit);
             this->clusters[cluster]->dumpQueue(unit);
@@ -947,16 +969,16 @@ void ISS::sim_dump_queue(uint32_t cluster, uint32_t unit) {
 
 void ISS::sim_dump_register_file(uint32_t cluster, uint32_t unit, uint32_t lane) {
     if (if_debug(DEBUG_USER_DUMP)) {
-        if (unit > VPRO_CFG::UNITS) {
+        if (unit > hw_config.units) {
             printf_warning(
-                "#SIM_DUMP: Invalid unit selection (%d)!. Maximum is %d.", unit, VPRO_CFG::UNITS);
-        } else if (cluster > VPRO_CFG::CLUSTERS) {
+                "#SIM_DUMP: Invalid unit selection (%d)!. Maximum is %d.", unit, hw_config.units);
+        } else if (cluster > hw_config.clusters) {
             printf_warning("#SIM_DUMP: Invalid cluster selection (%d)!. Maximum is %d.",
                 cluster,
-                VPRO_CFG::CLUSTERS);
-        } else if (lane > VPRO_CFG::LANES) {
+                hw_config.clusters);
+        } else if (lane > hw_config.lanes) {
             printf_warning(
-                "#SIM_DUMP: Invalid lane selection (%d)!. Maximum is %d.", lane, VPRO_CFG::LANES);
+                "#SIM_DUMP: Invalid lane selection (%d)!. Maximum is %d.", lane, hw_config.lanes);
         } else {
             printf("#SIM_DUMP: Register file, cluster=%d unit=%d lane=%d\n", cluster, unit, lane);
             this->clusters[cluster]->dumpRegisterFile(unit, lane);
@@ -1002,19 +1024,18 @@ int ISS::bin_file_send(uint32_t addr, int num_bytes, char const* file_name) {
     auto read = fread(buf, 1, num_bytes, pfh);
     fclose(pfh);
 
-    // copy to simulated main memory
-    for (int i = 0; i < (uint32_t)num_bytes; i++) {
-        bus->dbgWrite(addr + i, buf + i);
-        // main memory access in range?
-        if ((addr + i) > (VPRO_CFG::MM_SIZE - 1)) {
-            printf_error("\n#SIM: bin_file_send\n");
-            printf_error("#SIM: Main memory access out of range!\n");
-            printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
-                addr + i,
-                VPRO_CFG::MM_SIZE - 1);
-            exit(1);
-        }
+    // main memory access in range?
+    if (uint64_t(addr) + num_bytes > hw_config.mm_size) {
+        printf_error("\n#SIM: bin_file_send\n");
+        printf_error("#SIM: Main memory access out of range!\n");
+        printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
+            addr + num_bytes - 1,
+            hw_config.mm_size - 1);
+        exit(1);
     }
+    // copy to simulated main memory
+    bus->dbgWriteBlock(addr, buf, num_bytes);
+    if (isTracing()) traceMemWrite(addr, buf, num_bytes);
     free(buf);
     return 0;
 }
@@ -1033,12 +1054,12 @@ uint8_t* ISS::bin_file_return(uint32_t addr, int num_bytes) {
     auto* buf = (uint8_t*)malloc(num_bytes);
     for (int i = 0; i < (uint32_t)num_bytes; i++) {  // copy from simulated main memory
         bus->dbgRead(addr + i, buf + i);
-        if ((addr + i) > (VPRO_CFG::MM_SIZE - 1)) {  // main memory access in range?
+        if ((addr + i) > (hw_config.mm_size - 1)) {  // main memory access in range?
             printf_error("\n#SIM: bin_file_return\n");
             printf_error("#SIM: Main memory access out of range!\n");
             printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
                 addr + i,
-                VPRO_CFG::MM_SIZE - 1);
+                hw_config.mm_size - 1);
             exit(1);
         }
     }
@@ -1053,12 +1074,12 @@ uint16_t* ISS::get_main_memory(uint32_t addr, unsigned int num_elements_16bit) {
     unsigned int num_elements_8bit;
     num_elements_8bit = num_elements_16bit * 2;
     auto* buffer_8bit = (uint8_t*)malloc(num_elements_8bit * sizeof(uint8_t));
-    if ((addr + num_elements_8bit) > (VPRO_CFG::MM_SIZE - 1)) {  // main memory access in range?
+    if ((addr + num_elements_8bit) > (hw_config.mm_size - 1)) {  // main memory access in range?
         printf_error("\n#SIM: bin_file_return\n");
         printf_error("#SIM: Main memory access out of range!\n");
         printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
             addr + num_elements_8bit,
-            VPRO_CFG::MM_SIZE - 1);
+            hw_config.mm_size - 1);
         exit(1);
     }
     for (int i = 0; i < num_elements_8bit; i++) {
@@ -1072,8 +1093,8 @@ uint8_t* ISS::bin_lm_return(uint32_t cluster, uint32_t unit) {
     auto u = this->clusters[cluster]->getUnits().at(unit);
 
     auto lmdata =
-        new uint8_t[VPRO_CFG::LM_SIZE * Unit::VectorUnit::LOCAL_MEMORY_DATA_WIDTH]();
-    for (int lm = 0; lm < VPRO_CFG::LM_SIZE * Unit::VectorUnit::LOCAL_MEMORY_DATA_WIDTH; lm++)
+        new uint8_t[hw_config.lm_size * Unit::VectorUnit::LOCAL_MEMORY_DATA_WIDTH]();
+    for (int lm = 0; lm < hw_config.lm_size * Unit::VectorUnit::LOCAL_MEMORY_DATA_WIDTH; lm++)
         lmdata[lm] = u->getLocalMemoryPtr()[lm];
 
     return lmdata;
@@ -1083,8 +1104,8 @@ uint8_t* ISS::bin_rf_return(uint32_t cluster, uint32_t unit, uint32_t lane) {
     auto u = this->clusters[cluster]->getUnits().at(unit);
     auto l = u->getLanes().at(lane);
 
-    auto rfdata = new uint8_t[VPRO_CFG::RF_SIZE * 3]();
-    for (int lm = 0; lm < VPRO_CFG::RF_SIZE * 3; lm++) {
+    auto rfdata = new uint8_t[hw_config.rf_size * 3]();
+    for (int lm = 0; lm < hw_config.rf_size * 3; lm++) {
         rfdata[lm] = l->getregister()[lm];
     }
     return rfdata;
@@ -1104,17 +1125,15 @@ int ISS::bin_file_dump(uint32_t addr, int num_bytes, char const* file_name) {
 
     auto buf = (uint8_t*)malloc(num_bytes * sizeof(uint8_t));
 
-    for (int i = 0; i < (uint32_t)num_bytes; i++) {  // copy from simulated main memory
-        bus->dbgRead(addr + i, buf + i);
-        if ((addr + i) > (VPRO_CFG::MM_SIZE - 1)) {  // main memory access in range?
-            printf_error("\n#SIM: bin_file_dump\n");
-            printf_error("#SIM: Main memory access out of range!\n");
-            printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
-                addr + i,
-                VPRO_CFG::MM_SIZE - 1);
-            exit(1);
-        }
+    if (uint64_t(addr) + num_bytes > hw_config.mm_size) {  // main memory access in range?
+        printf_error("\n#SIM: bin_file_dump\n");
+        printf_error("#SIM: Main memory access out of range!\n");
+        printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
+            addr + num_bytes - 1,
+            hw_config.mm_size - 1);
+        exit(1);
     }
+    bus->dbgReadBlock(addr, buf, num_bytes);  // copy from simulated main memory
 
     auto pfh = fopen(file_name, "wb+");
     if (pfh == nullptr) {
@@ -1142,14 +1161,15 @@ void ISS::aux_memset(uint32_t base_addr, uint8_t value, uint32_t num_bytes) {
     }
     for (uint i = cmd->addr; i < (cmd->addr + cmd->num_bytes); i++) {
         // main memory access in range?
-        if (i > (VPRO_CFG::MM_SIZE - 1)) {
+        if (i > (hw_config.mm_size - 1)) {
             printf_error("\n#SIM: aux_memset\n");
             printf_error("#SIM: Main memory access out of range!\n");
             printf_error("Access address: 0x%08x, max address: 0x%08x\nAborting.\n",
                 cmd->addr + i,
-                VPRO_CFG::MM_SIZE - 1);
+                hw_config.mm_size - 1);
             exit(1);
         }
         bus->dbgWrite(i, &(cmd->value));
     }
+    if (isTracing()) traceMemSet(cmd->addr, cmd->value, cmd->num_bytes);
 }
@@ -43,7 +43,10 @@ using call_systemc_stop_cb = std::function<void(void)>;
 #endif
 
 #include <QCoreApplication>
+#include <QDataStream>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QMutex>
 #include <QThread>
 #include <QTime>
@@ -60,6 +63,7 @@ using call_systemc_stop_cb = std::function<void(void)>;
 #include "windows/Commands/commandwindow.h"
 
 #include "VectorMain.h"
+#include "hwConfig.h"
 #include "helper/mathHelper.h"
 #include "model/architecture/DMABlockExtractor.h"
 
@@ -124,6 +128,7 @@ class ISS : public QThread {
     void risc_counter_tick();
 
     void setWaitingToFinish(bool waiting) {
+        if (isTracing()) traceWaiting(waiting);
         riscv_sync_waiting = waiting;
     }
 
@@ -150,6 +155,44 @@ class ISS : public QThread {
 
     void sim_wait_step(bool finish = false, char const* msg = "");
 
+    /**
+     * saves / restores the complete simulator state (main memory, DCMA, LMs, RFs, accus, architecture
+     * state, time and statistics). Only possible while no component is busy (isIdle(), e.g. after vpro_sync())
+     * @return 0 on success
+     */
+    int sim_checkpoint_save(char const* file_name);
+    int sim_checkpoint_restore(char const* file_name);
+
+    /**
+     * command trace (helper/commandTrace.h) of all following application accesses: VPRO / DMA
+     * commands, io writes / reads, wait points and main memory writes. Starts with a checkpoint,
+     * so the trace can be replayed without the application (e.g. to benchmark the simulator).
+     * Also started by sim_init with --record-trace=<file>, stopped by sim_stop.
+     * @return 0 on success
+     */
+    int sim_trace_record(char const* file_name);
+    void sim_trace_record_stop();
+
+    /**
+     * replays a command trace (same configuration as the recording, sim_init done)
+     * @param file_name trace file, nullptr: file of --replay-trace=<file> (sim_init)
+     * @return 0 on success
+     */
+    int sim_trace_replay(char const* file_name = nullptr);
+
+    /**
+     * named span on the runtime track of the timeline (helper/timeline.h, sim_init argument
+     * --timeline=<file.json>), e.g. a layer. Markers nest, no-op without timeline
+     */
+    void sim_timeline_begin(char const* name);
+    void sim_timeline_end();
+
+    /**
+     * risc polling loop: io_read(addr) until (value & mask) == 0
+     * @param risc_step additional runUntilRiscReadyForCmd per iteration
+     */
+    void io_wait(uint32_t addr, uint32_t mask, bool risc_step = false);
+
     void check_vpro_instruction_length(const std::shared_ptr<CommandVPRO>& command);
 
     std::vector<Cluster*>& getClusters() {
@@ -184,6 +227,19 @@ class ISS : public QThread {
         return vpro_clock_period;
     }
 
+    [[nodiscard]] uint64_t getMMSize() const {
+        return hw_config.mm_size;
+    }
+
+    // runtime hardware parameters, e.g. array geometry (model sizes)
+    [[nodiscard]] const HWConfig& getHWConfig() const {
+        return hw_config;
+    }
+
+    [[nodiscard]] bool isFunctionalVPRO() const {
+        return functional_vpro;
+    }
+
     void run_vpro_instruction(const std::shared_ptr<CommandVPRO>& command);
     void run_dma_instruction(const std::shared_ptr<CommandDMA>& command, bool skip_tick = false);
 
@@ -286,22 +342,28 @@ class ISS : public QThread {
     // time for different clock domains
     double risc_time, axi_time, dcma_time;
 
-    static constexpr double risc_clock_period = 5;
+    // runtime hardware parameters (sim_init: command line / --hw-config file)
+    HWConfig hw_config;
+
+    // from hw_config (sim_init)
+    double risc_clock_period{hw_config.risc_clock_period};
     static constexpr double risc_io_access_cycles =
         3;  // how many cycles does EIS-V need for issuing an io-access (from hw sim)
-    static constexpr double axi_clock_period = 5;
-    static constexpr double dcma_clock_period = 5;
-    static constexpr double vpro_clock_period = 2.5;
-    static constexpr double dma_clock_period = dcma_clock_period;
+    double axi_clock_period{hw_config.axi_clock_period};
+    double dcma_clock_period{hw_config.dcma_clock_period};
+    double vpro_clock_period{hw_config.vpro_clock_period};
+    double dma_clock_period{hw_config.dma_clock_period};
 
-    static constexpr double iss_clock_tick_period = findGCD(dcma_clock_period,
+    double iss_clock_tick_period{findGCD(dcma_clock_period,
         axi_clock_period,
         risc_clock_period,
         vpro_clock_period,
-        dma_clock_period);
+        dma_clock_period)};
 
     // architecture. top level are clusters
     std::vector<Cluster*> clusters;
+    // lockstep of the cluster worker threads (nullptr if not started)
+    SpinBarrier* cluster_barrier{nullptr};
 
     std::shared_ptr<ArchitectureState> architecture_state;
 
@@ -316,6 +378,48 @@ class ISS : public QThread {
     void printExitStats(bool silent = false);
 
     std::shared_ptr<CommandVPRO> gen_io_vpro_command() const;
+    std::shared_ptr<CommandDMA> gen_io_dma_command(bool loc_to_ext) const;
+
+    // complete simulator state (simCheckpoint.cpp), also the start of a command trace
+    void saveCheckpoint(QDataStream& out);
+    bool restoreCheckpoint(QDataStream& in, char const* file_name);
+
+    // command trace recording (simTrace.cpp)
+    QFile* trace_file{nullptr};
+    QDataStream* trace_stream{nullptr};
+    // nesting of io accesses, only the outermost one (application) is recorded
+    int trace_depth{0};
+    uint32_t trace_pending_steps{0};
+    // sim_init arguments --record-trace=<file> / --replay-trace=<file>
+    QString trace_record_file;
+    QString trace_replay_file;
+    // sim_init argument --timeline=<file.json>
+    QString timeline_file;
+    // sim_init argument --cluster-threads: tick the units of each cluster on its own thread
+    bool cluster_threads{false};
+    // sim_init argument --state-digest: print a digest of the simulation result at exit
+    bool state_digest{false};
+    // sim_init argument --benchmark: print the throughput summary (#SIM_BENCHMARK) at exit
+    bool benchmark{false};
+    // sim_init argument --functional: lanes evaluate whole commands without pipeline timing
+    // (Unit::VectorLane::tickFunctional), cycle counts / statistics of the VPRO are not meaningful
+    bool functional_vpro{false};
+
+    // simulated / host time at the start of the application (benchmark summary, host profile)
+    double sim_start_time{0};
+    QElapsedTimer host_timer;
+
+    [[nodiscard]] bool isTracing() const {
+        return trace_stream != nullptr && trace_depth == 0;
+    }
+    void traceFlushSteps();
+    void traceStep();
+    void traceIoWrite(uint32_t addr, uint32_t value);
+    void traceIoRead(uint32_t addr, uint32_t value);
+    void traceIoWait(uint32_t addr, uint32_t mask, bool risc_step);
+    void traceWaiting(bool waiting);
+    void traceMemWrite(uint64_t addr, const uint8_t* data, uint64_t size);
+    void traceMemSet(uint64_t addr, uint8_t value, uint64_t size);
 
     // internal functions to control the simulation process, called from gui (e.g.)
     void simPause() {
@@ -426,6 +530,41 @@ class ISS : public QThread {
      */
     void runUntilRiscReadyForCmd();
 
+    /**
+     * no component (clusters, dcma, dma looper/block extractor) can change its state
+     * until the risc issues a new command
+     */
+    bool isIdle();
+
+    /**
+     * Event driven time advance (EVENT_DRIVEN_TIME_ADVANCE). Only if the simulation is running windowless,
+     * without tick debug output and isIdle()
+     */
+    bool isIdleSkipPossible();
+
+    /**
+     * advances time by risc_cycles risc clock ticks while isIdle().
+     * steps the clock domains like run() / runUntilRiscReadyForCmd() but without ticking the
+     * components. The skipped ticks are accounted afterwards (statistics, counters)
+     * @param risc_cycles number of risc clock ticks to skip
+     */
+    void skipIdleRiscCycles(uint32_t risc_cycles);
+
+    /**
+     * Event driven time advance while only the main memory latency is pending: units, dma looper
+     * and dma block extractor idle, the DCMA waits for the main memory (line fill / write back) and
+     * each busy DMA is stalled on a cache miss (Cluster::isWaiting)
+     */
+    bool isWaitSkipPossible();
+
+    /**
+     * advances time until the next event (completion of the main memory transfer,
+     * NonBlockingMainMemory::ticksUntilCompletion) or by risc_cycles risc clock ticks,
+     * whichever is first, while isWaitSkipPossible(). Cycle-identical to ticking each component
+     * @return number of skipped risc clock ticks
+     */
+    uint32_t skipWaitRiscCycles(uint32_t risc_cycles);
+
     /**
      * creates a copy of all cmds in list and emits the update to visualization.
      */
@@ -465,6 +604,11 @@ class ISS : public QThread {
      */
     void sim_stop(bool silent = false);
 
+    /**
+     * ends the cluster worker threads (--cluster-threads), clusters are ticked sequentially after
+     */
+    void stopClusterWorkers();
+
     /**
      * ISS performance measuring.
      * This Timeout will print cycles of last period (Cycles / second)
@@ -476,6 +620,12 @@ class ISS : public QThread {
 
     void dbgMemRead(intptr_t dst_addr, uint8_t* data_ptr) const;
 
+    /**
+     * host pointer to size bytes of the simulated main memory at addr (no copy, not traced)
+     * @return nullptr if out of range or the bus has no host backed memory
+     */
+    uint8_t* dbgMemPtr(intptr_t addr, uint64_t size) const;
+
     void sim_stats_reset();
 
     void gen_direct_dma_instruction(const uint8_t dcache_data_struct[32]);
@@ -0,0 +1,105 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file checkpoint.h
+ *
+ * Raw (host byte order) serialization helpers for simulator checkpoints (ISS::sim_checkpoint_save)
+ * a checkpoint is only valid for the same build (architecture configuration) on the same host
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <QDataStream>
+#include <cstdint>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+namespace Checkpoint {
+
+// containers may be nested (e.g., vector of maps)
+template <typename T>
+void write(QDataStream& out, const std::vector<T>& vector);
+template <typename T>
+void read(QDataStream& in, std::vector<T>& vector);
+template <typename K, typename V>
+void write(QDataStream& out, const std::map<K, V>& map);
+template <typename K, typename V>
+void read(QDataStream& in, std::map<K, V>& map);
+
+template <typename T>
+void write(QDataStream& out, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "raw checkpoint data only");
+    out.writeRawData(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void read(QDataStream& in, T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "raw checkpoint data only");
+    in.readRawData(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(QDataStream& out, const T* data, uint64_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "raw checkpoint data only");
+    out.writeRawData(reinterpret_cast<const char*>(data), int(count * sizeof(T)));
+}
+
+template <typename T>
+void readArray(QDataStream& in, T* data, uint64_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "raw checkpoint data only");
+    in.readRawData(reinterpret_cast<char*>(data), int(count * sizeof(T)));
+}
+
+// vectors are stored with their size, restored vectors are resized
+template <typename T>
+void write(QDataStream& out, const std::vector<T>& vector) {
+    write(out, uint64_t(vector.size()));
+    for (const T& value : vector) write(out, value);
+}
+
+template <typename T>
+void read(QDataStream& in, std::vector<T>& vector) {
+    uint64_t size = 0;
+    read(in, size);
+    vector.resize(size);
+    for (uint64_t i = 0; i < size; i++) {
+        T value;
+        read(in, value);
+        vector[i] = value;
+    }
+}
+
+template <typename K, typename V>
+void write(QDataStream& out, const std::map<K, V>& map) {
+    write(out, uint64_t(map.size()));
+    for (const auto& entry : map) {
+        write(out, entry.first);
+        write(out, entry.second);
+    }
+}
+
+template <typename K, typename V>
+void read(QDataStream& in, std::map<K, V>& map) {
+    uint64_t size = 0;
+    read(in, size);
+    map.clear();
+    for (uint64_t i = 0; i < size; i++) {
+        K key;
+        read(in, key);
+        read(in, map[key]);
+    }
+}
+
+}  // namespace Checkpoint
+
+#endif  // CHECKPOINT_H
@@ -0,0 +1,105 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file commandTrace.h
+ *
+ * Binary command trace of the risc side of a simulation
+ * (ISS::sim_trace_record / ISS::sim_trace_replay)
+ *
+ * Trace := TraceHeader, checkpoint (simulator state at the start of the recording), records, END
+ * Record := RECORD type (1 byte), record struct of this type (raw, host byte order) [, data]
+ *
+ * Only accesses of the application are recorded (nested io_read/io_write of the simulator are not).
+ * VPRO and DMA commands are stored decoded (register set of the trigger), writes to the command
+ * parameter registers only as the risc cycles they took. A trace is only valid for the same build
+ * (architecture configuration) and hardware parameters on the same host, like a checkpoint.
+ */
+
+#ifndef COMMAND_TRACE_H
+#define COMMAND_TRACE_H
+
+#include <cstdint>
+
+namespace CommandTrace {
+
+// "V2PT" + format version
+static constexpr uint32_t MAGIC = 0x54503256;
+static constexpr uint32_t VERSION = 1;
+
+struct TraceHeader {
+    uint32_t magic{MAGIC};
+    uint32_t version{VERSION};
+};
+
+enum RECORD : uint8_t {
+    IO_WRITE = 0,   // IoWrite: io_write (config registers, DCMA, DMA cascade, ...)
+    IO_READ = 1,    // IoRead: io_read, value is compared on replay
+    IO_WAIT = 2,    // IoWait: polling loop until (register & mask) == 0 (sync, fsm idle)
+    RISC_STEP = 3,  // RiscStep: runUntilRiscReadyForCmd (io access without own record, aux wait)
+    VPRO_CMD = 4,   // ISS::io_vpro_cmd_register_t at the trigger
+    DMA_CMD = 5,    // DmaCmd + ISS::io_dma_cmd_register_t at the trigger
+    DMA_BLOCK = 6,  // DmaBlock [+ size * 32 bytes of DMA commands if read from host memory]
+    MM_WRITE = 7,   // MmWrite + size bytes: bin_file_send, dbgMemWrite
+    MM_SET = 8,     // MmSet: aux_memset
+    WAITING = 9,    // Waiting: setWaitingToFinish (risc in a sync, riscv enabled counter)
+    END = 10,       // sim_stop / end of the recording
+};
+
+struct IoWrite {
+    uint32_t addr;
+    uint32_t value;
+};
+
+struct IoRead {
+    uint32_t addr;
+    uint32_t value;
+};
+
+struct IoWait {
+    uint32_t addr;
+    uint32_t mask;
+    uint8_t risc_step;  // additional runUntilRiscReadyForCmd per poll
+};
+
+// consecutive risc steps are merged
+struct RiscStep {
+    uint32_t count;
+};
+
+struct DmaCmd {
+    uint32_t trigger_addr;  // IDMA_EXT_BASE_ADDR_E2L_ADDR / IDMA_EXT_BASE_ADDR_L2E_ADDR
+};
+
+// DMA command block (dma_block_addr_trigger) or single DMA command (dma_dcache_short_command)
+struct DmaBlock {
+    uint64_t addr;  // main memory address or host pointer (> 32-bit)
+    uint32_t size;  // number of 32 byte DMA commands
+    uint8_t host;   // commands follow in the trace (host memory is not part of the checkpoint)
+};
+
+struct MmWrite {
+    uint64_t addr;
+    uint64_t size;
+};
+
+struct Waiting {
+    uint8_t waiting;
+};
+
+struct MmSet {
+    uint64_t addr;
+    uint64_t size;
+    uint8_t value;
+};
+
+}  // namespace CommandTrace
+
+#endif  // COMMAND_TRACE_H
@@ -0,0 +1,90 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file hostProfile.cpp
+ *
+ * Accounting blocks and report of the host profile (see hostProfile.h)
+ */
+
+#include "hostProfile.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include "debugHelper.h"
+
+HostProfile::Block* HostProfile::registerBlock() {
+    std::lock_guard<std::mutex> lock(mutex);
+    blocks.push_back(std::make_unique<Block>());
+    return blocks.back().get();
+}
+
+void HostProfile::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& block : blocks) {
+        *block = Block();
+    }
+    start_time = std::chrono::steady_clock::now();
+    start_counter = now();
+}
+
+void HostProfile::print(double risc_cycles) {
+    static const char* names[COMPONENT::end] = {"Cluster (VPRO)",
+        "Unit tick",
+        "Unit update",
+        "DMA tick",
+        "DCMA tick",
+        "AXI tick",
+        "io_write"};
+
+    double host_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start_time)
+                         .count();
+    uint64_t counter = now() - start_counter;
+    if (host_ns <= 0 || counter == 0) return;
+    double ns_per_count = host_ns / double(counter);
+
+    Block sum;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& block : blocks) {
+            for (int c = 0; c < COMPONENT::end; c++) {
+                sum.self[c] += block->self[c];
+                sum.calls[c] += block->calls[c];
+            }
+        }
+    }
+
+    printf_info("Host Profile (self time, worker threads summed up):\n");
+    printf("  %-16s %16s %7s %14s %16s\n", "Component", "Host [ns]", "Share", "Calls",
+        "Calls / host s");
+    double profiled_ns = 0;
+    for (int c = 0; c < COMPONENT::end; c++) {
+        double ns = double(sum.self[c]) * ns_per_count;
+        profiled_ns += ns;
+        printf("  %-16s %16.0f %6.2f%% %14" PRIu64 " %16.0f\n",
+            names[c],
+            ns,
+            100. * ns / host_ns,
+            sum.calls[c],
+            ns > 0 ? double(sum.calls[c]) * 1e9 / ns : 0.);
+    }
+    double other_ns = std::max(0., host_ns - profiled_ns);
+    printf("  %-16s %16.0f %6.2f%%   (risc application, event loop, scheduling, ...)\n",
+        "Other",
+        other_ns,
+        100. * other_ns / host_ns);
+    printf("  %-16s %16.0f %6.2f%% %14.0f %16.0f (simulated risc cycles)\n",
+        "Total",
+        host_ns,
+        100.,
+        risc_cycles,
+        risc_cycles * 1e9 / host_ns);
+}
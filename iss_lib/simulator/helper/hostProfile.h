@@ -0,0 +1,125 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file hostProfile.h
+ *
+ * Host time of the simulator by component (setting.h: HOST_PROFILING)
+ *
+ * HostTimer measures the time stamp counter around a scope. Nested timers are subtracted from the
+ * enclosing one (self time), e.g. the simulation inside ISS::io_write is not counted for io_write.
+ * Each thread accounts into its own block (cluster worker threads), summed up by print().
+ * Without HOST_PROFILING the timers are empty.
+ */
+
+#ifndef HOST_PROFILE_H
+#define HOST_PROFILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../setting.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class HostProfile {
+   public:
+    enum COMPONENT : uint8_t {
+        CLUSTER_VPRO = 0,  // Cluster::tickVPRO without the units
+        UNIT_TICK = 1,     // VectorUnit::tick of all units of a cluster
+        UNIT_UPDATE = 2,   // VectorUnit::update of all units of a cluster
+        DMA_TICK = 3,
+        DCMA_TICK = 4,
+        AXI_TICK = 5,
+        IO_WRITE = 6,  // ISS::io_write without the simulation until the risc is ready
+        end
+    };
+
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    struct Block {
+        uint64_t self[COMPONENT::end]{};
+        uint64_t calls[COMPONENT::end]{};
+    };
+
+    // accounting block of the calling thread
+    static Block& block() {
+        thread_local Block* local = registerBlock();
+        return *local;
+    }
+
+    // start of the measurement (sim_init), calibrates the counter with the steady clock
+    static void start();
+
+    /**
+     * per component: host ns (self), share of the host time since start(),
+     * simulated cycles (calls) per host second
+     * @param risc_cycles simulated risc cycles since start() (overall simulated cycles / s)
+     */
+    static void print(double risc_cycles);
+
+   private:
+    static Block* registerBlock();
+
+    static inline std::mutex mutex;
+    static inline std::vector<std::unique_ptr<Block>> blocks;
+    static inline uint64_t start_counter{0};
+    static inline std::chrono::steady_clock::time_point start_time;
+};
+
+/**
+ * scoped timer of one component
+ */
+class HostTimer {
+   public:
+    explicit HostTimer(HostProfile::COMPONENT component) : component(component) {
+        if constexpr (HOST_PROFILING) {
+            parent = current;
+            current = this;
+            begin = HostProfile::now();
+        }
+    }
+
+    ~HostTimer() {
+        if constexpr (HOST_PROFILING) {
+            uint64_t elapsed = HostProfile::now() - begin;
+            auto& block = HostProfile::block();
+            block.self[component] += elapsed - children;
+            block.calls[component]++;
+            if (parent != nullptr) parent->children += elapsed;
+            current = parent;
+        }
+    }
+
+    HostTimer(HostTimer const&) = delete;
+    void operator=(HostTimer const&) = delete;
+
+   private:
+    static inline thread_local HostTimer* current{nullptr};
+
+    HostProfile::COMPONENT component;
+    HostTimer* parent{nullptr};
+    uint64_t begin{0};
+    uint64_t children{0};
+};
+
+#endif  // HOST_PROFILE_H
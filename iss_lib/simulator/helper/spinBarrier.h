@@ -0,0 +1,71 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file spinBarrier.h
+ *
+ * Sense reversing spin barrier to run the clusters (threads) in lockstep with the main thread.
+ * Waiting threads spin first, then block on a condition variable (e.g., while the main thread
+ * executes the risc application or the simulation is paused / finished)
+ */
+
+#ifndef SPIN_BARRIER_H
+#define SPIN_BARRIER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+class SpinBarrier {
+   public:
+    explicit SpinBarrier(int participants) : participants(participants), waiting(participants) {}
+
+    /**
+     * blocks until all participants have called wait()
+     * the last arriving thread releases the others by flipping the sense
+     */
+    void wait() {
+        // sense of this episode (only flipped by the last thread of the previous episode)
+        bool local_sense = !sense.load(std::memory_order_relaxed);
+        if (waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            waiting.store(participants, std::memory_order_relaxed);
+            sense.store(local_sense, std::memory_order_seq_cst);
+            if (sleepers.load(std::memory_order_seq_cst) > 0) {
+                // a sleeper checks the sense with the mutex held -> no lost wake up
+                { std::lock_guard<std::mutex> lock(mutex); }
+                wake.notify_all();
+            }
+            return;
+        }
+        for (int spins = 0; spins < SPINS_BEFORE_BLOCK; spins++) {
+            if (sense.load(std::memory_order_acquire) == local_sense) return;
+        }
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return sense.load(std::memory_order_seq_cst) == local_sense; });
+        }
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr int SPINS_BEFORE_BLOCK = 4096;
+
+    const int participants;
+    std::atomic<int> waiting;
+    std::atomic<bool> sense{false};
+
+    // threads blocked on wake (spin budget exceeded)
+    std::atomic<int> sleepers{0};
+    std::mutex mutex;
+    std::condition_variable wake;
+};
+
+#endif  // SPIN_BARRIER_H
@@ -0,0 +1,288 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file timeline.cpp
+ *
+ * Ring buffers and JSON writer of the simulation timeline (see timeline.h)
+ */
+
+#include "timeline.h"
+#include <chrono>
+#include <cinttypes>
+#include "../../model/commands/CommandDMA.h"
+#include "../../model/commands/CommandVPRO.h"
+#include "debugHelper.h"
+
+// JSON string content of s (names are written with "%s")
+static std::string jsonEscape(const std::string& s) {
+    std::string escaped;
+    escaped.reserve(s.size());
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (uint8_t(c) < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", unsigned(uint8_t(c)));
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+int Timeline::open(const char* file_name,
+    const double& time,
+    double vpro_clock_period,
+    uint32_t clusters,
+    uint32_t units,
+    uint32_t lanes) {
+    if (enabled) {
+        printf_error("#SIM: Timeline already open!\n");
+        return -1;
+    }
+    file = fopen(file_name, "w");
+    if (file == nullptr) {
+        printf_error("#SIM: Timeline: Unable to open file %s!\n", file_name);
+        return -1;
+    }
+    setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    this->time = &time;
+    this->vpro_clock_period = vpro_clock_period;
+    this->clusters = clusters;
+    this->units = units;
+    this->lanes = lanes;
+
+    vpro_names.clear();
+    for (int t = 0; t < CommandVPRO::enumTypeEnd; t++) {
+        vpro_names.push_back(
+            jsonEscape(CommandVPRO::getType(CommandVPRO::TYPE(t)).trimmed().toStdString()));
+    }
+    dma_names.clear();
+    for (int t = 0; t < CommandDMA::enumTypeEnd; t++) {
+        dma_names.push_back(
+            jsonEscape(CommandDMA::getType(CommandDMA::TYPE(t)).trimmed().toStdString()));
+    }
+
+    rings.clear();
+    for (uint32_t r = 0; r <= clusters; r++) {
+        rings.push_back(std::make_unique<Ring>());
+    }
+    named_tracks.clear();
+    marker_stack.clear();
+    written = 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (uint32_t c = 0; c <= clusters; c++) {
+        char name[32];
+        if (c < clusters) {
+            snprintf(name, sizeof(name), "Cluster %u", c);
+        } else {
+            snprintf(name, sizeof(name), "DCMA / AXI");
+        }
+        // keep the clusters in order, DCMA / AXI below
+        fprintf(file,
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"%s\"}},\n"
+            "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%u,"
+            "\"args\":{\"sort_index\":%u}},\n",
+            c,
+            name,
+            c,
+            c);
+    }
+
+    running = true;
+    writer = std::thread(&Timeline::writerLoop, this);
+    enabled = true;
+    printf_info("#SIM: Timeline to %s\n", file_name);
+    return 0;
+}
+
+void Timeline::close() {
+    if (!enabled) return;
+    enabled = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeup.notify_one();
+    writer.join();
+
+    // metadata as last event (no trailing comma)
+    fprintf(file,
+        "{\"name\":\"timeline\",\"ph\":\"M\",\"pid\":0,\"args\":{\"spans\":%" PRIu64 "}}\n]}\n",
+        written);
+    fclose(file);
+    file = nullptr;
+    printf_info("#SIM: Timeline closed (%" PRIu64 " spans)\n", written);
+}
+
+void Timeline::span(
+    KIND kind, uint16_t pid, uint16_t tid, uint32_t name, double begin, double end, uint64_t arg) {
+    Ring& ring = (kind == VPRO) ? *rings[pid] : *rings[clusters];
+    push(ring, Event{begin, end, arg, name, pid, tid, kind});
+}
+
+void Timeline::push(Ring& ring, const Event& event) {
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t fill = head - ring.tail.load(std::memory_order_acquire);
+    if (fill >= RING_SIZE) {
+        // simulation is faster than the writer
+        wakeup.notify_one();
+        while (head - ring.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            std::this_thread::yield();
+        }
+    } else if (fill == RING_SIZE / 2) {
+        wakeup.notify_one();
+    }
+    ring.buffer[head & (RING_SIZE - 1)] = event;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Timeline::markerBegin(const char* name) {
+    uint32_t id;
+    std::string escaped = jsonEscape(name);
+    {
+        std::lock_guard<std::mutex> lock(marker_mutex);
+        id = uint32_t(marker_names.size());
+        for (uint32_t i = 0; i < marker_names.size(); i++) {
+            if (marker_names[i] == escaped) {
+                id = i;
+                break;
+            }
+        }
+        if (id == marker_names.size()) marker_names.push_back(escaped);
+    }
+    marker_stack.emplace_back(id, now());
+}
+
+void Timeline::markerEnd() {
+    if (marker_stack.empty()) {
+        printf_warning("#SIM: Timeline: marker end without begin!\n");
+        return;
+    }
+    auto [name, begin] = marker_stack.back();
+    marker_stack.pop_back();
+    span(MARKER, systemPid(), MARKER_TRACK, name, begin, now());
+}
+
+void Timeline::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        wakeup.wait_for(lock, std::chrono::milliseconds(100));
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+    lock.unlock();
+    drain();
+}
+
+void Timeline::drain() {
+    for (auto& ring : rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            write(ring->buffer[tail & (RING_SIZE - 1)]);
+            // free the slot for the producer
+            ring->tail.store(tail + 1, std::memory_order_release);
+        }
+    }
+}
+
+void Timeline::writeTrackName(uint16_t pid, uint16_t tid) {
+    if (!named_tracks.insert(uint32_t(pid) << 16 | tid).second) return;
+
+    char name[32];
+    if (pid < clusters) {
+        if (tid == dmaTrack()) {
+            snprintf(name, sizeof(name), "DMA");
+        } else if (tid % (lanes + 1) == lanes) {
+            snprintf(name, sizeof(name), "U%u LS", tid / (lanes + 1));
+        } else {
+            snprintf(name, sizeof(name), "U%u L%u", tid / (lanes + 1), tid % (lanes + 1));
+        }
+    } else if (tid == DCMA_TRACK) {
+        snprintf(name, sizeof(name), "DCMA");
+    } else if (tid == MARKER_TRACK) {
+        snprintf(name, sizeof(name), "Runtime");
+    } else {
+        snprintf(name, sizeof(name), "AXI Initiator %u", tid - axiTrack(0));
+    }
+    fprintf(file,
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,"
+        "\"args\":{\"name\":\"%s\"}},\n"
+        "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,"
+        "\"args\":{\"sort_index\":%u}},\n",
+        pid,
+        tid,
+        name,
+        pid,
+        tid,
+        tid);
+}
+
+void Timeline::write(const Event& event) {
+    writeTrackName(event.pid, event.tid);
+
+    // ts / dur in us
+    fprintf(file,
+        "{\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,",
+        event.pid,
+        event.tid,
+        event.begin / 1000.,
+        (event.end - event.begin) / 1000.);
+    switch (event.kind) {
+        case VPRO:
+            fprintf(file,
+                "\"cat\":\"vpro\",\"name\":\"%s\",\"args\":{\"queued_ns\":%.3f}},\n",
+                vpro_names[event.name].c_str(),
+                double(event.arg) / 1000.);
+            break;
+        case DMA:
+            fprintf(file,
+                "\"cat\":\"dma\",\"name\":\"%s\",\"args\":{\"ext_addr\":\"0x%" PRIx64 "\"}},\n",
+                dma_names[event.name].c_str(),
+                event.arg);
+            break;
+        case DCMA_MISS:
+        case DCMA_PREFETCH:
+            fprintf(file,
+                "\"cat\":\"dcma\",\"name\":\"%s\","
+                "\"args\":{\"cluster\":%u,\"line\":\"0x%" PRIx64 "\"}},\n",
+                event.kind == DCMA_MISS ? "miss" : "prefetch",
+                event.name,
+                event.arg);
+            break;
+        case DCMA_FLUSH:
+            fprintf(file, "\"cat\":\"dcma\",\"name\":\"flush\"},\n");
+            break;
+        case AXI_READ:
+        case AXI_WRITE:
+            fprintf(file,
+                "\"cat\":\"axi\",\"name\":\"%s\","
+                "\"args\":{\"addr\":\"0x%" PRIx64 "\",\"burst\":%u}},\n",
+                event.kind == AXI_READ ? "read" : "write",
+                event.arg,
+                event.name);
+            break;
+        case MARKER: {
+            std::lock_guard<std::mutex> lock(marker_mutex);
+            fprintf(file,
+                "\"cat\":\"runtime\",\"name\":\"%s\"},\n",
+                marker_names[event.name].c_str());
+            break;
+        }
+    }
+    written++;
+}
@@ -0,0 +1,173 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file timeline.h
+ *
+ * Timeline of the simulated hardware activity in the Chrome trace event format (JSON), to be opened
+ * in ui.perfetto.dev or chrome://tracing. Spans on one (simulated) time axis:
+ * - VPRO commands per lane (first element until the write back of the last one, queue time as arg)
+ * - DMA commands per cluster
+ * - DCMA cache line misses (download incl. write back of a dirty line) and flushes
+ * - main memory (AXI) transfers per initiator
+ * - runtime markers of the application (sim_timeline_begin / sim_timeline_end, e.g. layers)
+ *
+ * Producers append fixed size events to a single producer ring buffer (one per cluster for its
+ * lanes, those may run on the cluster worker threads; one for all sequentially ticked components).
+ * A writer thread drains the rings in the background and formats the JSON, a full ring blocks its
+ * producer.
+ * Enabled by the sim_init argument --timeline=<file.json>. Disabled, each hook tests one flag.
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Timeline {
+   public:
+    enum KIND : uint8_t {
+        VPRO = 0,        // pid: cluster, tid: lane track, name: CommandVPRO::TYPE, arg: queue ps
+        DMA = 1,         // pid: cluster, name: CommandDMA::TYPE, arg: external address
+        DCMA_MISS = 2,   // name: requesting cluster, arg: cache line address
+        DCMA_FLUSH = 3,  // name: -, arg: -
+        AXI_READ = 4,    // tid: axiTrack(initiator), name: burst length, arg: address
+        AXI_WRITE = 5,
+        MARKER = 6,      // name: interned marker string
+        DCMA_PREFETCH = 7,  // name: cluster of the predicting dma stream, arg: cache line address
+    };
+
+    struct Event {
+        double begin;  // ns
+        double end;    // ns
+        uint64_t arg;
+        uint32_t name;
+        uint16_t pid;
+        uint16_t tid;
+        KIND kind;
+    };
+
+    static Timeline& get() {
+        static Timeline instance;
+        return instance;
+    }
+
+    Timeline(Timeline const&) = delete;
+    void operator=(Timeline const&) = delete;
+
+    // tested by all hooks
+    static inline bool enabled{false};
+
+    /**
+     * starts the writer thread
+     * @param time simulated time (ISS), read by the producers
+     * @return 0 on success
+     */
+    int open(const char* file_name,
+        const double& time,
+        double vpro_clock_period,
+        uint32_t clusters,
+        uint32_t units,
+        uint32_t lanes);
+
+    // drains the rings, completes the JSON and joins the writer thread
+    void close();
+
+    [[nodiscard]] double now() const {
+        return *time;
+    }
+
+    [[nodiscard]] double getVPROClockPeriod() const {
+        return vpro_clock_period;
+    }
+
+    // track of a lane (LS lane: lane >= lanes) inside the process of its cluster
+    [[nodiscard]] uint16_t laneTrack(uint32_t unit, uint32_t lane) const {
+        return uint16_t(unit * (lanes + 1) + std::min(lane, lanes));
+    }
+
+    [[nodiscard]] uint16_t dmaTrack() const {
+        return uint16_t(units * (lanes + 1));
+    }
+
+    // process for DCMA, AXI and markers
+    [[nodiscard]] uint16_t systemPid() const {
+        return uint16_t(clusters);
+    }
+
+    static constexpr uint16_t DCMA_TRACK = 0;
+    static constexpr uint16_t MARKER_TRACK = 1;
+    static uint16_t axiTrack(uint32_t initiator) {
+        return uint16_t(2 + initiator);
+    }
+
+    /**
+     * appends a span. VPRO spans are only allowed on the thread which ticks this cluster,
+     * all others on the main (simulation) thread
+     */
+    void span(KIND kind, uint16_t pid, uint16_t tid, uint32_t name, double begin, double end,
+        uint64_t arg = 0);
+
+    // nested markers on the runtime track (main thread)
+    void markerBegin(const char* name);
+    void markerEnd();
+
+   private:
+    Timeline() = default;
+
+    static constexpr uint64_t RING_SIZE = 1u << 14;  // events per ring, power of 2
+
+    struct Ring {
+        std::vector<Event> buffer = std::vector<Event>(RING_SIZE);
+        std::atomic<uint64_t> head{0};  // written by the producer
+        std::atomic<uint64_t> tail{0};  // written by the writer thread
+    };
+
+    void push(Ring& ring, const Event& event);
+    void writerLoop();
+    void drain();
+    void write(const Event& event);
+    void writeTrackName(uint16_t pid, uint16_t tid);
+
+    const double* time{nullptr};
+    double vpro_clock_period{1};
+    uint32_t clusters{0}, units{0}, lanes{0};
+
+    // [0, clusters): lanes of cluster, [clusters]: sequentially ticked components
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool running{false};
+
+    // writer thread
+    FILE* file{nullptr};
+    uint64_t written{0};
+    std::set<uint32_t> named_tracks;
+    std::vector<std::string> vpro_names, dma_names;  // JSON escaped
+
+    // markers: names are interned JSON escaped (mutex, rare), open markers (main thread)
+    std::vector<std::string> marker_names;
+    std::mutex marker_mutex;
+    std::vector<std::pair<uint32_t, double>> marker_stack;
+};
+
+#endif  // TIMELINE_H
@@ -0,0 +1,279 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+
+#include "hwConfig.h"
+#include <QFile>
+#include <QStringList>
+#include "helper/debugHelper.h"
+#include "helper/mathHelper.h"
+#include "vpro/vpro_cmd_defs.h"
+
+static const QStringList keys = {"clusters",
+    "units",
+    "lanes",
+    "lm_size",
+    "rf_size",
+    "mm_size",
+    "dcma_line_size",
+    "dcma_associativity",
+    "dcma_nr_brams",
+    "dcma_bram_size",
+    "dcma_prefetch_degree",
+    "dcma_replacement",
+    "dcma_miss_classification",
+    "risc_clock_period",
+    "axi_clock_period",
+    "dcma_clock_period",
+    "vpro_clock_period",
+    "dma_clock_period",
+    "mm_read_latency",
+    "mm_write_latency",
+    "mm_dram",
+    "dram_banks",
+    "dram_row_size",
+    "dram_t_rcd",
+    "dram_t_rp",
+    "dram_t_refi",
+    "dram_t_rfc",
+    "dram_queue_depth",
+    "dram_bytes_per_cycle"};
+
+// order of Cache::ReplacementPolicy
+static const QStringList replacement_policies = {"fifo", "lru", "lfu", "random", "plru"};
+
+static bool isPowerOfTwo(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+bool HWConfig::set(const QString& key, const QString& value) {
+    bool ok = false;
+    // integers may be given in hex (0x...)
+    if (key == "clusters") {
+        clusters = value.toUInt(&ok, 0);
+    } else if (key == "units") {
+        units = value.toUInt(&ok, 0);
+    } else if (key == "lanes") {
+        lanes = value.toUInt(&ok, 0);
+    } else if (key == "lm_size") {
+        lm_size = value.toUInt(&ok, 0);
+    } else if (key == "rf_size") {
+        rf_size = value.toUInt(&ok, 0);
+    } else if (key == "mm_size") {
+        mm_size = value.toULongLong(&ok, 0);
+    } else if (key == "dcma_line_size") {
+        dcma_line_size = value.toUInt(&ok, 0);
+    } else if (key == "dcma_associativity") {
+        dcma_associativity = value.toUInt(&ok, 0);
+    } else if (key == "dcma_nr_brams") {
+        dcma_nr_brams = value.toUInt(&ok, 0);
+    } else if (key == "dcma_bram_size") {
+        dcma_bram_size = value.toUInt(&ok, 0);
+    } else if (key == "dcma_prefetch_degree") {
+        dcma_prefetch_degree = value.toUInt(&ok, 0);
+    } else if (key == "dcma_replacement") {
+        int policy = replacement_policies.indexOf(value.toLower());
+        ok = policy >= 0;
+        if (ok) dcma_replacement = policy;
+    } else if (key == "dcma_miss_classification") {
+        dcma_miss_classification = value.toUInt(&ok, 0) != 0;
+    } else if (key == "risc_clock_period") {
+        risc_clock_period = value.toDouble(&ok);
+    } else if (key == "axi_clock_period") {
+        axi_clock_period = value.toDouble(&ok);
+    } else if (key == "dcma_clock_period") {
+        dcma_clock_period = value.toDouble(&ok);
+    } else if (key == "vpro_clock_period") {
+        vpro_clock_period = value.toDouble(&ok);
+    } else if (key == "dma_clock_period") {
+        dma_clock_period = value.toDouble(&ok);
+    } else if (key == "mm_read_latency") {
+        mm_timing.read_latency = value.toUInt(&ok, 0);
+    } else if (key == "mm_write_latency") {
+        mm_timing.write_latency = value.toUInt(&ok, 0);
+    } else if (key == "mm_dram") {
+        mm_timing.dram = value.toUInt(&ok, 0) != 0;
+    } else if (key == "dram_banks") {
+        mm_timing.banks = value.toUInt(&ok, 0);
+    } else if (key == "dram_row_size") {
+        mm_timing.row_size = value.toUInt(&ok, 0);
+    } else if (key == "dram_t_rcd") {
+        mm_timing.t_rcd = value.toUInt(&ok, 0);
+    } else if (key == "dram_t_rp") {
+        mm_timing.t_rp = value.toUInt(&ok, 0);
+    } else if (key == "dram_t_refi") {
+        mm_timing.t_refi = value.toUInt(&ok, 0);
+    } else if (key == "dram_t_rfc") {
+        mm_timing.t_rfc = value.toUInt(&ok, 0);
+    } else if (key == "dram_queue_depth") {
+        mm_timing.queue_depth = value.toUInt(&ok, 0);
+    } else if (key == "dram_bytes_per_cycle") {
+        mm_timing.bytes_per_cycle = value.toUInt(&ok, 0);
+    } else {
+        printf_error("[HW Config] Unknown parameter '%s'\n", key.toStdString().c_str());
+        return false;
+    }
+    if (!ok) {
+        printf_error("[HW Config] Invalid value '%s' for %s\n",
+            value.toStdString().c_str(),
+            key.toStdString().c_str());
+    }
+    return ok;
+}
+
+bool HWConfig::load(const QString& file_name) {
+    QFile file(file_name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printf_error("[HW Config] Unable to open file %s!\n", file_name.toStdString().c_str());
+        return false;
+    }
+    bool ok = true;
+    while (!file.atEnd()) {
+        QString line = QString(file.readLine()).simplified();
+        if (line.startsWith(";") || line.startsWith("#") || line.isEmpty()) continue;
+        auto items = line.split("=");
+        if (items.size() != 2) {
+            printf_error("[HW Config] %s: line '%s' is not 'key = value'\n",
+                file_name.toStdString().c_str(),
+                line.toStdString().c_str());
+            ok = false;
+            continue;
+        }
+        ok &= set(items[0].trimmed(), items[1].trimmed());
+    }
+    return ok;
+}
+
+QString HWConfig::toString() const {
+    QString text;
+    auto line = [&text](const char* key, const QString& value) {
+        text += QString(key) + " = " + value + "\n";
+    };
+    line("clusters", QString::number(clusters));
+    line("units", QString::number(units));
+    line("lanes", QString::number(lanes));
+    line("lm_size", QString::number(lm_size));
+    line("rf_size", QString::number(rf_size));
+    line("mm_size", QString::number(mm_size));
+    line("dcma_line_size", QString::number(dcma_line_size));
+    line("dcma_associativity", QString::number(dcma_associativity));
+    line("dcma_nr_brams", QString::number(dcma_nr_brams));
+    line("dcma_bram_size", QString::number(dcma_bram_size));
+    line("dcma_prefetch_degree", QString::number(dcma_prefetch_degree));
+    line("dcma_replacement", replacement_policies.value(int(dcma_replacement)));
+    line("dcma_miss_classification", QString::number(int(dcma_miss_classification)));
+    line("risc_clock_period", QString::number(risc_clock_period, 'g', 10));
+    line("axi_clock_period", QString::number(axi_clock_period, 'g', 10));
+    line("dcma_clock_period", QString::number(dcma_clock_period, 'g', 10));
+    line("vpro_clock_period", QString::number(vpro_clock_period, 'g', 10));
+    line("dma_clock_period", QString::number(dma_clock_period, 'g', 10));
+    line("mm_read_latency", QString::number(mm_timing.read_latency));
+    line("mm_write_latency", QString::number(mm_timing.write_latency));
+    line("mm_dram", QString::number(int(mm_timing.dram)));
+    line("dram_banks", QString::number(mm_timing.banks));
+    line("dram_row_size", QString::number(mm_timing.row_size));
+    line("dram_t_rcd", QString::number(mm_timing.t_rcd));
+    line("dram_t_rp", QString::number(mm_timing.t_rp));
+    line("dram_t_refi", QString::number(mm_timing.t_refi));
+    line("dram_t_rfc", QString::number(mm_timing.t_rfc));
+    line("dram_queue_depth", QString::number(mm_timing.queue_depth));
+    line("dram_bytes_per_cycle", QString::number(mm_timing.bytes_per_cycle));
+    return text;
+}
+
+bool HWConfig::parseArguments(int& argc, char* argv[]) {
+    bool ok = true;
+    int remaining = 1;
+    for (int i = 1; i < argc; ++i) {
+        QString arg(argv[i]);
+        int separator = arg.indexOf('=');
+        QString key = arg.mid(2, separator - 2);
+        QString value = arg.mid(separator + 1);
+        // other arguments are kept for the application
+        if (!arg.startsWith("--") || separator < 0 ||
+            (key != "hw-config" && !keys.contains(key))) {
+            argv[remaining++] = argv[i];
+            continue;
+        }
+        if (key == "hw-config") {
+            ok &= load(value);
+        } else {
+            ok &= set(key, value);
+        }
+    }
+    argc = remaining;
+    argv[argc] = nullptr;
+    return ok;
+}
+
+bool HWConfig::isValid() const {
+    bool valid = true;
+    if (clusters == 0 || clusters > 32 || units == 0 || units > 32) {
+        printf_error("[HW Config] 1 ... 32 clusters and units per cluster (32-bit masks)!\n");
+        valid = false;
+    }
+    // lane mask: one bit per processing lane, LS lane directly above (vpro_cmd_defs.h, LANE)
+    // -> the number of processing lanes is fixed by the encoding
+    uint32_t encodable_lanes = __builtin_ctz(uint32_t(LS));
+    if (lanes != encodable_lanes) {
+        printf_error("[HW Config] lanes = %u: the lane mask (L0 ... LS = 0x%x) encodes exactly %u "
+                     "processing lanes, the number of lanes can not be changed!\n",
+            lanes,
+            uint32_t(LS),
+            encodable_lanes);
+        valid = false;
+    }
+    if (lm_size == 0 || rf_size == 0) {
+        printf_error("[HW Config] Local memory and register file size have to be > 0!\n");
+        valid = false;
+    }
+    if (!isPowerOfTwo(dcma_line_size) || !isPowerOfTwo(dcma_associativity) ||
+        !isPowerOfTwo(dcma_nr_brams) || !isPowerOfTwo(dcma_bram_size)) {
+        printf_error("[HW Config] DCMA line size, associativity, #rams and ram size have to be "
+                     "powers of two!\n");
+        valid = false;
+    } else if (uint64_t(dcma_bram_size) * dcma_nr_brams <
+               uint64_t(dcma_line_size) * dcma_associativity) {
+        printf_error("[HW Config] DCMA too small for a single set (#rams * ram size < line size * "
+                     "associativity)!\n");
+        valid = false;
+    }
+    if (mm_size == 0) {
+        printf_error("[HW Config] Main memory size is 0!\n");
+        valid = false;
+    }
+    if (risc_clock_period <= 0 || axi_clock_period <= 0 || dcma_clock_period <= 0 ||
+        vpro_clock_period <= 0 || dma_clock_period <= 0) {
+        printf_error("[HW Config] Clock periods have to be > 0!\n");
+        valid = false;
+    } else if (findGCD(risc_clock_period,
+                   axi_clock_period,
+                   dcma_clock_period,
+                   vpro_clock_period,
+                   dma_clock_period) <= 0) {
+        printf_error("[HW Config] Clock periods have to be multiples of 0.01 ns!\n");
+        valid = false;
+    }
+    if (mm_timing.dram) {
+        if (!isPowerOfTwo(mm_timing.banks) || !isPowerOfTwo(mm_timing.row_size)) {
+            printf_error("[HW Config] DRAM banks and row size have to be powers of two!\n");
+            valid = false;
+        }
+        if (mm_timing.queue_depth == 0 || mm_timing.bytes_per_cycle == 0) {
+            printf_error("[HW Config] DRAM queue depth and bytes per cycle have to be > 0!\n");
+            valid = false;
+        }
+        if (mm_timing.t_refi > 0 && mm_timing.t_refi <= mm_timing.t_rfc) {
+            printf_error("[HW Config] DRAM refresh interval has to exceed the refresh time!\n");
+            valid = false;
+        }
+    }
+    return valid;
+}
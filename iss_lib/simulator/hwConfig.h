@@ -0,0 +1,105 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file hwConfig.h
+ *
+ * Hardware parameters of the simulated system which are selected at simulator start (no rebuild),
+ * e.g., for design space sweeps of the DCMA geometry or the clock frequencies.
+ * Defaults are the CONF_* values of the build (vpro_globals.h).
+ *
+ * The array geometry (clusters, units, lm_size, rf_size) sizes the ISS model. lanes is fixed by the
+ * lane mask encoding (L0, L1, LS), other values are rejected. The application is still compiled
+ * with VPRO_CFG (masks, loop bounds, work distribution): a geometry other than the build's one
+ * runs, but the application has to distribute its work by the runtime values (hardware info
+ * registers). The apps in this repository use VPRO_CFG -> rebuild them for another geometry
+ * (make CLUSTERS=.. UNITS=..), sim_init prints a warning on a mismatch.
+ *
+ * Sources (later overwrites earlier):
+ *  - file given by --hw-config=<file>, one "key = value" per line ('#' / ';' comments)
+ *  - command line --<key>=<value>, e.g. --clusters=4 --dcma_nr_brams=16 --vpro_clock_period=2.0
+ *
+ * DCMA: dcma_replacement=plru selects the replacement policy (fifo, lru, lfu, random, plru),
+ * dcma_miss_classification=1 the miss classification statistic (StatisticDcma)
+ *
+ * Main memory timing (MainMemoryTiming.h, AXI cycles): mm_read_latency, mm_write_latency,
+ * mm_dram=1 enables the DRAM model with dram_banks, dram_row_size, dram_t_rcd, dram_t_rp,
+ * dram_t_refi, dram_t_rfc, dram_queue_depth and dram_bytes_per_cycle
+ */
+
+#ifndef VPRO_HW_CONFIG_H
+#define VPRO_HW_CONFIG_H
+
+#include <QString>
+#include <cstdint>
+#include "../model/architecture/MainMemoryTiming.h"
+#include "vpro/vpro_globals.h"
+
+struct HWConfig {
+    uint32_t clusters{VPRO_CFG::CLUSTERS};
+    uint32_t units{VPRO_CFG::UNITS};  // per cluster
+    uint32_t lanes{VPRO_CFG::LANES};  // processing lanes per unit (without LS lane)
+    uint32_t lm_size{VPRO_CFG::LM_SIZE};  // in 16-bit words
+    uint32_t rf_size{VPRO_CFG::RF_SIZE};  // in 24-bit words
+
+    uint64_t mm_size{VPRO_CFG::MM_SIZE};  // in bytes
+
+    uint32_t dcma_line_size{VPRO_CFG::DCMA_LINE_SIZE};  // in bytes
+    uint32_t dcma_associativity{VPRO_CFG::DCMA_ASSOCIATIVITY};
+    uint32_t dcma_nr_brams{VPRO_CFG::DCMA_NR_BRAMS};
+    uint32_t dcma_bram_size{VPRO_CFG::DCMA_BRAM_SIZE};  // in bytes
+    uint32_t dcma_prefetch_degree{0};  // lines predicted per dma stream, 0: no prefetcher
+    // Cache::ReplacementPolicy, given by name: fifo, lru, lfu, random or plru
+    uint32_t dcma_replacement{0};
+    // compulsory / capacity / conflict miss statistic (shadow tag store, no timing effect)
+    bool dcma_miss_classification{false};
+
+    // in ns
+    double risc_clock_period{5};
+    double axi_clock_period{5};
+    double dcma_clock_period{5};
+    double vpro_clock_period{2.5};
+    double dma_clock_period{5};
+
+    MainMemoryTiming mm_timing;
+
+    /**
+     * @return false if key is unknown or value is not a valid number
+     */
+    bool set(const QString& key, const QString& value);
+
+    /**
+     * reads "key = value" lines of file_name
+     * @return false if file is not readable or contains an invalid line
+     */
+    bool load(const QString& file_name);
+
+    /**
+     * all parameters as "key = value" lines (format of load(), fixed order), e.g. to identify the
+     * simulated hardware of a measurement
+     */
+    QString toString() const;
+
+    /**
+     * applies and removes --hw-config=<file> and --<key>=<value> arguments (argc / argv are updated,
+     * remaining arguments keep their order)
+     * @return false if an argument is invalid
+     */
+    bool parseArguments(int& argc, char* argv[]);
+
+    /**
+     * array geometry (cluster / unit masks: at most 32, lanes: fixed by the lane mask incl. LS),
+     * DCMA geometry (powers of two, at least one set), clock periods (> 0) and DRAM parameters
+     * (powers of two, refresh interval longer than refresh) usable
+     */
+    bool isValid() const;
+};
+
+#endif  // VPRO_HW_CONFIG_H
@@ -71,14 +71,31 @@ constexpr int UNITS_COMMAND_QUEUE_MAX_SIZE = 32;
 constexpr bool simulationSpeedMeasurement = true;
 
 /**
- * Whether to seperate Cluster, Units or Lanes into threads...
- * more sense on high content tick functions (cluster...)
- *
- * constexpr bool THREAD_CLUSTER = true;   // if #cluster  >= 2 && units   >= 4    (more means more tick time)
- *
- * no big influence on simulated cycles / s !??? => maybe some bug somewhere? should speed it up...
+ * Host time by component (helper/hostProfile.h) in the exit statistics
+ * time stamp counter around cluster, unit, DMA, DCMA and AXI ticks and io_write (self time),
+ * costs two counter reads per tick of each component
+ */
+constexpr bool HOST_PROFILING = false;
+
+/**
+ * Event driven time advance (ISS Standalone, windowless)
+ * if no component can change its state until the risc issues a new command (all lanes, DMAs, DCMA and
+ * DMA Looper idle; e.g. during aux_wait_cycles), the time jumps directly to the next risc tick
+ * instead of ticking each cluster/lane. Skipped ticks are accounted in bulk -> cycle-identical results
+ * while the lanes are idle and the DMAs only wait for a line fill (DCMA miss), the time jumps to the
+ * completion of the pending main memory transfer (next event), the stalls are accounted in bulk
  */
-//#define THREAD_CLUSTER
+constexpr bool EVENT_DRIVEN_TIME_ADVANCE = true;
+
+/**
+ * Idle aware ticking of units and lanes
+ * a lane without command (none in queue for it, empty pipeline, empty chaining fifo) skips its tick() and
+ * update() and is accounted by tickIdle() instead. A unit skips completely if all of its lanes do.
+ * -> host time scales with the active part of the architecture, cycle-identical results
+ * (disabled while per lane debug prints are enabled)
+ */
+constexpr bool SKIP_IDLE_LANE_TICKS = true;
+
 
 /**
  * Log files for CMD history (
@@ -94,12 +111,9 @@ extern QFile* CMD_HISTORY_FILE;
 class QTextStream;
 extern QTextStream* CMD_HISTORY_FILE_STREAM;
 
-// sim_exit()
-const QString dumpFileSuffix = QString::number(VPRO_CFG::CLUSTERS) + "C" +
-                               QString::number(VPRO_CFG::UNITS) + "U" +
-                               QString::number(VPRO_CFG::LANES) + "L";
-const QString dumpFileName = "../statistics/statistic_detail_" + dumpFileSuffix + ".log";
-const QString dumpJSONFileName = "../statistics/statistics_detail_" + dumpFileSuffix + ".json";
+// sim_exit(), + "<clusters>C<units>U<lanes>L" of the runtime geometry + ".log" / ".json"
+const QString dumpFileName = "../statistics/statistic_detail_";
+const QString dumpJSONFileName = "../statistics/statistics_detail_";
 
 extern QFile* PRE_GEN_FILE;
 class QDataStream;
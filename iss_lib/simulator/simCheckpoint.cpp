@@ -0,0 +1,192 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file simCheckpoint.cpp
+ *
+ * VPRO instruction & system simulation library
+ * Checkpoint (save / restore) of the complete simulator state to resume a simulation,
+ * e.g., to simulate a single layer of a net without re-simulating the previous ones
+ */
+
+#include <QDataStream>
+#include <QFile>
+
+#include "../model/architecture/stats/Statistics.h"
+#include "ISS.h"
+#include "helper/checkpoint.h"
+#include "helper/debugHelper.h"
+
+// "V2PC" + format version
+static constexpr uint32_t CHECKPOINT_MAGIC = 0x43503256;
+static constexpr uint32_t CHECKPOINT_VERSION = 8;
+
+/**
+ * configuration the checkpoint has been created with, has to match on restore
+ */
+struct CheckpointConfig {
+    uint32_t magic{CHECKPOINT_MAGIC};
+    uint32_t version{CHECKPOINT_VERSION};
+    // runtime hardware parameters (sim_init), incl. the array geometry
+    HWConfig hw;
+
+    explicit CheckpointConfig(const HWConfig& hw) : hw(hw) {}
+
+    bool operator==(const CheckpointConfig& ref) const {
+        return magic == ref.magic && version == ref.version && hw.clusters == ref.hw.clusters &&
+               hw.units == ref.hw.units && hw.lanes == ref.hw.lanes &&
+               hw.lm_size == ref.hw.lm_size && hw.rf_size == ref.hw.rf_size &&
+               hw.mm_size == ref.hw.mm_size &&
+               hw.dcma_line_size == ref.hw.dcma_line_size &&
+               hw.dcma_associativity == ref.hw.dcma_associativity &&
+               hw.dcma_nr_brams == ref.hw.dcma_nr_brams &&
+               hw.dcma_bram_size == ref.hw.dcma_bram_size &&
+               hw.dcma_prefetch_degree == ref.hw.dcma_prefetch_degree &&
+               hw.dcma_replacement == ref.hw.dcma_replacement &&
+               hw.dcma_miss_classification == ref.hw.dcma_miss_classification &&
+               hw.risc_clock_period == ref.hw.risc_clock_period &&
+               hw.axi_clock_period == ref.hw.axi_clock_period &&
+               hw.dcma_clock_period == ref.hw.dcma_clock_period &&
+               hw.vpro_clock_period == ref.hw.vpro_clock_period &&
+               hw.dma_clock_period == ref.hw.dma_clock_period &&
+               hw.mm_timing == ref.hw.mm_timing;
+    }
+};
+
+int ISS::sim_checkpoint_save(char const* file_name) {
+    if (!isIdle()) {
+        printf_error(
+            "#SIM: sim_checkpoint_save: VPRO/DMA busy! Call vpro_sync() before the checkpoint.\n");
+        return -1;
+    }
+
+    QFile file(file_name);
+    if (!file.open(QIODevice::WriteOnly)) {
+        printf_error("#SIM: sim_checkpoint_save: Unable to open file %s!\n", file_name);
+        return -1;
+    }
+    QDataStream out(&file);
+    saveCheckpoint(out);
+
+    if (out.status() != QDataStream::Ok) {
+        printf_error("#SIM: sim_checkpoint_save: Failed to write %s!\n", file_name);
+        return -1;
+    }
+    printf_info("#SIM: Checkpoint saved to %s (%lli Bytes) @Time %.0lf ns\n",
+        file_name,
+        file.size(),
+        time);
+    return 0;
+}
+
+int ISS::sim_checkpoint_restore(char const* file_name) {
+    if (!isIdle()) {
+        printf_error(
+            "#SIM: sim_checkpoint_restore: VPRO/DMA busy! Call vpro_sync() before the restore.\n");
+        return -1;
+    }
+    if (trace_stream) {
+        printf_warning(
+            "#SIM: sim_checkpoint_restore: not part of the command trace, recording stopped\n");
+        sim_trace_record_stop();
+    }
+
+    QFile file(file_name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printf_error("#SIM: sim_checkpoint_restore: Unable to open file %s!\n", file_name);
+        return -1;
+    }
+    QDataStream in(&file);
+    if (!restoreCheckpoint(in, file_name)) return -1;
+
+    printf_info("#SIM: Checkpoint restored from %s @Time %.0lf ns\n", file_name, time);
+    return 0;
+}
+
+void ISS::saveCheckpoint(QDataStream& out) {
+    Checkpoint::write(out, CheckpointConfig(hw_config));
+
+    // time of all clock domains and risc visible counters / registers
+    Checkpoint::write(out, time);
+    Checkpoint::write(out, risc_time);
+    Checkpoint::write(out, axi_time);
+    Checkpoint::write(out, dcma_time);
+    Checkpoint::write(out, aux_cnt_lane_act);
+    Checkpoint::write(out, aux_cnt_dma_act);
+    Checkpoint::write(out, aux_cnt_both_act);
+    Checkpoint::write(out, aux_cnt_vpro_total);
+    Checkpoint::write(out, aux_cnt_riscv_total);
+    Checkpoint::write(out, aux_cnt_riscv_enabled);
+    Checkpoint::write(out, aux_sys_time);
+    Checkpoint::write(out, aux_cycle_counter);
+    Checkpoint::write(out, dma_access_counter_cluster_pointer);
+    Checkpoint::write(out, io_vpro_cmd_register);
+    Checkpoint::write(out, io_dma_cmd_register);
+    Checkpoint::write(out, *architecture_state);
+
+    for (auto cluster : clusters) {
+        cluster->saveCheckpoint(out);
+    }
+    dcma->saveCheckpoint(out);
+#ifdef ISS_STANDALONE
+    reinterpret_cast<NonBlockingMainMemory*>(bus)->saveCheckpoint(out);
+#else
+    printf_warning("#SIM: sim_checkpoint_save: main memory is external (not in checkpoint)\n");
+#endif
+    Statistics::get().saveCheckpoint(out);
+}
+
+bool ISS::restoreCheckpoint(QDataStream& in, char const* file_name) {
+    CheckpointConfig config(hw_config);
+    Checkpoint::read(in, config);
+    if (!(config == CheckpointConfig(hw_config))) {
+        printf_error(
+            "#SIM: sim_checkpoint_restore: %s does not match this simulator (version / "
+            "configuration %iC%iU%iL)!\n",
+            file_name,
+            config.hw.clusters,
+            config.hw.units,
+            config.hw.lanes);
+        return false;
+    }
+
+    Checkpoint::read(in, time);
+    Checkpoint::read(in, risc_time);
+    Checkpoint::read(in, axi_time);
+    Checkpoint::read(in, dcma_time);
+    Checkpoint::read(in, aux_cnt_lane_act);
+    Checkpoint::read(in, aux_cnt_dma_act);
+    Checkpoint::read(in, aux_cnt_both_act);
+    Checkpoint::read(in, aux_cnt_vpro_total);
+    Checkpoint::read(in, aux_cnt_riscv_total);
+    Checkpoint::read(in, aux_cnt_riscv_enabled);
+    Checkpoint::read(in, aux_sys_time);
+    Checkpoint::read(in, aux_cycle_counter);
+    Checkpoint::read(in, dma_access_counter_cluster_pointer);
+    Checkpoint::read(in, io_vpro_cmd_register);
+    Checkpoint::read(in, io_dma_cmd_register);
+    Checkpoint::read(in, *architecture_state);
+
+    for (auto cluster : clusters) {
+        cluster->restoreCheckpoint(in);
+    }
+    dcma->restoreCheckpoint(in);
+#ifdef ISS_STANDALONE
+    reinterpret_cast<NonBlockingMainMemory*>(bus)->restoreCheckpoint(in);
+#endif
+    Statistics::get().restoreCheckpoint(in);
+
+    if (in.status() != QDataStream::Ok) {
+        printf_error("#SIM: sim_checkpoint_restore: %s is incomplete! Simulator state is invalid.\n",
+            file_name);
+        return false;
+    }
+    return true;
+}
@@ -18,6 +18,7 @@
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #include <QApplication>
 #include <QCoreApplication>
@@ -28,8 +29,10 @@
 #include <QThread>
 #include <QtConcurrent/QtConcurrent>
 #include <QtCore/QFuture>
+#include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -43,6 +46,8 @@
 #include "ISS.h"
 #include "VectorMain.h"
 #include "helper/debugHelper.h"
+#include "helper/hostProfile.h"
+#include "helper/timeline.h"
 
 QFile* CMD_HISTORY_FILE;
 QFile* PRE_GEN_FILE;
@@ -103,11 +108,95 @@ void ISS::openTraceFile(const char* tracefilename) {
 // Simulator Environment
 // ###############################################################################################################################
 
+/**
+ * splits size bytes of a file into contiguous main memory blocks (input.cfg / output.cfg format):
+ * skip_len[si] bytes are skipped in MM every skip_pos[si] bytes of the file
+ * @param block called with (file offset, mm address, length) of each block
+ */
+static void forEachMMBlock(uint64_t address,
+    uint64_t size,
+    const QVector<int64_t>& skip_pos,
+    const QVector<int64_t>& skip_len,
+    const std::function<void(uint64_t, uint64_t, uint64_t)>& block) {
+    uint64_t mm_addr = address;
+    uint64_t i = 0;
+    while (i < size) {
+        uint64_t end = size;
+        for (int si = 0; si < skip_pos.size(); si++) {
+            if (skip_pos[si] > 0) end = std::min(end, (i / skip_pos[si] + 1) * skip_pos[si]);
+        }
+        block(i, mm_addr, end - i);
+        mm_addr += end - i;
+        for (int si = 0; si < skip_pos.size(); si++) {
+            if (skip_pos[si] > 0 && end % skip_pos[si] == 0) mm_addr += skip_len[si];
+        }
+        i = end;
+    }
+}
+
 // ---------------------------------------------------------------------------------
 // Initialize simulation environment
 // ---------------------------------------------------------------------------------
 int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
     if (windowThread) {
+        // removes the hardware parameters from argv (before the positional input / output cfg)
+        if (!hw_config.parseArguments(argc, argv) || !hw_config.isValid()) {
+            printf_error("#SIM: Invalid hardware configuration! Aborting.\n");
+            exit(1);
+        }
+        if (hw_config.clusters != VPRO_CFG::CLUSTERS || hw_config.units != VPRO_CFG::UNITS ||
+            hw_config.lanes != VPRO_CFG::LANES || hw_config.lm_size != VPRO_CFG::LM_SIZE ||
+            hw_config.rf_size != VPRO_CFG::RF_SIZE) {
+            printf_warning("#SIM: application built for %uC%uU%uL (LM %u, RF %u), simulating "
+                           "%uC%uU%uL (LM %u, RF %u): VPRO_CFG based masks / work distribution of "
+                           "the application do not match!\n",
+                VPRO_CFG::CLUSTERS,
+                VPRO_CFG::UNITS,
+                VPRO_CFG::LANES,
+                VPRO_CFG::LM_SIZE,
+                VPRO_CFG::RF_SIZE,
+                hw_config.clusters,
+                hw_config.units,
+                hw_config.lanes,
+                hw_config.lm_size,
+                hw_config.rf_size);
+        }
+        risc_clock_period = hw_config.risc_clock_period;
+        axi_clock_period = hw_config.axi_clock_period;
+        dcma_clock_period = hw_config.dcma_clock_period;
+        vpro_clock_period = hw_config.vpro_clock_period;
+        dma_clock_period = hw_config.dma_clock_period;
+        iss_clock_tick_period = findGCD(dcma_clock_period,
+            axi_clock_period,
+            risc_clock_period,
+            vpro_clock_period,
+            dma_clock_period);
+
+        // command trace / timeline files (removed from argv as well)
+        int remaining = 1;
+        for (int i = 1; i < argc; ++i) {
+            QString arg(argv[i]);
+            if (arg.startsWith("--record-trace=")) {
+                trace_record_file = arg.section('=', 1);
+            } else if (arg.startsWith("--replay-trace=")) {
+                trace_replay_file = arg.section('=', 1);
+            } else if (arg.startsWith("--timeline=")) {
+                timeline_file = arg.section('=', 1);
+            } else if (arg == "--cluster-threads") {
+                cluster_threads = true;
+            } else if (arg == "--state-digest") {
+                state_digest = true;
+            } else if (arg == "--benchmark") {
+                benchmark = true;
+            } else if (arg == "--functional") {
+                functional_vpro = true;
+            } else {
+                argv[remaining++] = argv[i];
+            }
+        }
+        argc = remaining;
+        argv[argc] = nullptr;
+
         for (int i = 1; i < argc; ++i) {
             if (!qstrcmp(argv[i], "--windowless") || !qstrcmp(argv[i], "--silent")) {
                 printf_warning("Gonna run silent, without windows [--windowless]\n");
@@ -132,43 +221,44 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
             "---------------------------------------------------------------------------------\n");
         printf("# VPRO Array Configuration:\n");
         printf("#  Clusters:  %3d, Units (per Cl): %3d, Processing Lanes (per VU): %3d\n",
-            VPRO_CFG::CLUSTERS,
-            VPRO_CFG::UNITS,
-            VPRO_CFG::LANES);
+            hw_config.clusters,
+            hw_config.units,
+            hw_config.lanes);
         printf("#                       Total VUs: %3d, Total Processing Lanes:    %3d \n",
-            VPRO_CFG::UNITS * VPRO_CFG::CLUSTERS,
-            VPRO_CFG::CLUSTERS * VPRO_CFG::UNITS * VPRO_CFG::LANES);
+            hw_config.units * hw_config.clusters,
+            hw_config.clusters * hw_config.units * hw_config.lanes);
         printf("#\n");
         printf("# DCMA Configuration:\n");
-        printf("#  #Rams:  %3d, Cache Line Size in Bytes:  %3d, \n", VPRO_CFG::DCMA_NR_BRAMS, VPRO_CFG::DCMA_LINE_SIZE);
+        printf("#  #Rams:  %3d, Cache Line Size in Bytes:  %3d, \n", hw_config.dcma_nr_brams, hw_config.dcma_line_size);
         printf("#                       VPRO_CFG::DCMA_ASSOCIATIVITY: %3d, Ram Size in Bytes:    %3d \n",
-            VPRO_CFG::DCMA_ASSOCIATIVITY,
-            VPRO_CFG::DCMA_BRAM_SIZE);
+            hw_config.dcma_associativity,
+            hw_config.dcma_bram_size);
         printf("#\n");
         printf("# ISS Memories:\n");
 #ifdef ISS_STANDALONE
         string str;
-        double msize = VPRO_CFG::MM_SIZE;
-        if (VPRO_CFG::MM_SIZE <= 1024) {
+        uint64_t mm_size = hw_config.mm_size;
+        double msize = mm_size;
+        if (mm_size <= 1024) {
             str = "B ";
-            msize = VPRO_CFG::MM_SIZE;
-        } else if (VPRO_CFG::MM_SIZE <= 1024 * 1024) {
+            msize = mm_size;
+        } else if (mm_size <= 1024 * 1024) {
             str = "KB";
-            msize = VPRO_CFG::MM_SIZE / 1024.;
-        } else if (VPRO_CFG::MM_SIZE <= 1024 * 1024 * 1024) {
+            msize = mm_size / 1024.;
+        } else if (mm_size <= 1024 * 1024 * 1024) {
             str = "MB";
-            msize = VPRO_CFG::MM_SIZE / 1024. / 1024.;
+            msize = mm_size / 1024. / 1024.;
         } else {
             str = "GB";
-            msize = VPRO_CFG::MM_SIZE / 1024. / 1024. / 1024.;
+            msize = mm_size / 1024. / 1024. / 1024.;
         }
         printf("#  Main Memory (Non Blocking):    8-bit x %lu (%3.f %s)\n",
-            VPRO_CFG::MM_SIZE,
+            mm_size,
             msize,
             str.c_str());
 #endif
-        printf("#  Local Memory:  16-bit x %6lu\n", VPRO_CFG::LM_SIZE);
-        printf("#  Register File: 24-bit x %6lu\n", VPRO_CFG::RF_SIZE);
+        printf("#  Local Memory:  16-bit x %6u\n", hw_config.lm_size);
+        printf("#  Register File: 24-bit x %6u\n", hw_config.rf_size);
         printf("#\n");
         printf("# Clocks:\n");
         printf("#   Risc-V (only ISS functions calls): %s%04.2lf MHz%s (%02.2lf ns Period)\n",
@@ -203,10 +293,19 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
             "---------------------------------------------------------------------------------\n");
 
 #ifdef ISS_STANDALONE
-        bus = new NonBlockingMainMemory(VPRO_CFG::MM_SIZE);
+        bus = new NonBlockingMainMemory(hw_config.mm_size, hw_config.mm_timing);
 #endif
 
-        dcma = new DCMA(this, bus, VPRO_CFG::CLUSTERS, VPRO_CFG::DCMA_LINE_SIZE, VPRO_CFG::DCMA_ASSOCIATIVITY, VPRO_CFG::DCMA_NR_BRAMS, VPRO_CFG::DCMA_BRAM_SIZE);
+        dcma = new DCMA(this,
+            bus,
+            hw_config.clusters,
+            hw_config.dcma_line_size,
+            hw_config.dcma_associativity,
+            hw_config.dcma_nr_brams,
+            hw_config.dcma_bram_size,
+            hw_config.dcma_prefetch_degree,
+            Cache::ReplacementPolicy(hw_config.dcma_replacement),
+            hw_config.dcma_miss_classification);
 
         printf_info("# Calling initialization Script %s ... ", initscript.toStdString().c_str());
         std::ifstream init_script(initscript.toStdString().c_str());
@@ -264,29 +363,30 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
                     "Input could not be opened! [File: %s]\n", input_file.toStdString().c_str());
                 continue;
             }
+            int64_t input_size = input.size();
+            if (size > 0) input_size = std::min(size, input_size);
+            // block copy to MM directly from the mapped file (read as fallback)
             QByteArray input_data;
-            if (size <= 0) {
-                input_data = input.readAll();
-            } else {
-                input_data = input.read(size);
-            }
-            uint64_t mm_addr = address;
-            for (int i = 0; i < input_data.size(); i++) {
-                auto writedata = uint8_t(input_data.at(i));
-                bus->dbgWrite(mm_addr, &writedata);
-                mm_addr++;
-                for (int si = 0; si < skip_pos.size(); si++) {
-                    if ((i + 1) % skip_pos[si] == 0) {
-                        mm_addr += skip_len[si];
-                    }
-                }
+            const uint8_t* input_ptr = input_size > 0 ? input.map(0, input_size) : nullptr;
+            if (input_ptr == nullptr) {
+                input_data = input.read(input_size);
+                input_size = input_data.size();
+                input_ptr = reinterpret_cast<const uint8_t*>(input_data.constData());
             }
+            forEachMMBlock(address,
+                input_size,
+                skip_pos,
+                skip_len,
+                [&](uint64_t offset, uint64_t mm_addr, uint64_t length) {
+                    bus->dbgWriteBlock(mm_addr, &input_ptr[offset], length);
+                });
+            input.close();
             if (if_debug(DEBUG_DUMP_FLAGS))
                 printf_info("\tFile %s was read to MM [%u (Dez) / 0x%x (Hex)]\t Size: %i\n",
                     input_file.toStdString().c_str(),
                     address,
                     address,
-                    input_data.size());
+                    int(input_size));
         }
 
         // ########################################################################
@@ -304,10 +404,8 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
                 globals.seekg(0, globals.beg);
                 char* buffer = new char[length];  // allocate buffer
                 globals.read(buffer, length);     //read file
-                for (int i = 0; i < length; i++) {
-                    uint8_t writedata = uint8_t(buffer[i]);
-                    bus->dbgWrite(i, &writedata);
-                }
+                bus->dbgWriteBlock(0, reinterpret_cast<uint8_t*>(buffer), length);
+                delete[] buffer;
                 printf(
                     "#SIM: Loaded all Global Variables to main_memory start [address: 0] (Size: "
                     "%i)\n",
@@ -345,15 +443,15 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
                     ptr = strtok(NULL, delimiter);
                     name = ptr;
                 }
-                if (address < VPRO_CFG::MM_SIZE) {
+                if (address < hw_config.mm_size) {
                     printf_error(
                         "\tObject Failed: external Object inside main memory [0 ... %li] (not "
                         "addressable) -- name: %s @%i [size: %i]\n",
-                        VPRO_CFG::MM_SIZE,
+                        hw_config.mm_size,
                         name,
                         address,
                         size);
-                } else if (address >= VPRO_CFG::MM_SIZE && (debug & DEBUG_GLOBAL_VARIABLE_CHECK)) {
+                } else if (address >= hw_config.mm_size && (debug & DEBUG_GLOBAL_VARIABLE_CHECK)) {
                     QMap<int, QString> object;
                     object[size] = name;
                     // TODO
@@ -361,7 +459,7 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
                     printf_info(
                         "\tObject Passed: external Object outside main memory [0 ... %li] "
                         "(addressable)     -- name: %s @%i [size: %i]\n",
-                        VPRO_CFG::MM_SIZE,
+                        hw_config.mm_size,
                         name,
                         address,
                         size);
@@ -374,7 +472,7 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
         // Create Cluster
         // ########################################################################
         printf("\n");
-        for (int i = 0; i < VPRO_CFG::CLUSTERS; i++) {
+        for (int i = 0; i < hw_config.clusters; i++) {
             clusters.push_back(new Cluster(this,
                 i,
                 architecture_state,
@@ -414,16 +512,37 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
             w->setVproSpecialRegisters(v);
         }
 
-#ifdef THREAD_CLUSTER
-        //        busythreads.release(VPRO_CFG::CLUSTERS);
-        if (VPRO_CFG::CLUSTERS >= 2 && VPRO_CFG::UNITS >= 2) {
-            for (Cluster* cluster : clusters) {
-                cluster->tick_en.lock();
-                cluster->tick_done.lock();
-                cluster->start();
+        if (functional_vpro) {
+            // no pipeline timing -> no lane spans
+            if (!timeline_file.isEmpty()) {
+                printf_warning("[--functional] no timeline of the functional VPRO execution\n");
+                timeline_file.clear();
+            }
+            for (auto cluster : clusters) {
+                for (auto unit : cluster->getUnits()) {
+                    unit->setFunctional(true);
+                }
+            }
+        }
+
+        // one persistent worker per cluster, cluster 0 is ticked by this thread
+        // the units tick + update of all clusters runs in parallel, synchronized by a spinning
+        // barrier twice per clock tick. DMAs, DCMA and statistics are ticked sequentially ->
+        // results are identical to the sequential simulation (compare with --state-digest)
+        if (cluster_threads && hw_config.clusters >= 2) {
+            if (!timeline_file.isEmpty() ||
+                (debug & (DEBUG_INSTRUCTIONS | DEBUG_PIPELINE | DEBUG_PIPELINE_9 |
+                             DEBUG_FIFO_MSG | DEBUG_LANE_STALLS))) {
+                // lanes write timeline spans / debug output shared by all clusters
+                printf_warning("[--cluster-threads] not with timeline or lane debug output, "
+                               "clusters are ticked sequentially\n");
+            } else {
+                cluster_barrier = new SpinBarrier(hw_config.clusters);
+                for (size_t c = 1; c < clusters.size(); c++) {
+                    clusters[c]->startWorker(cluster_barrier);
+                }
             }
         }
-#endif
         if (CREATE_CMD_HISTORY_FILE) {
             QFileInfo fi(CMD_HISTORY_FILE_NAME);
             CMD_HISTORY_FILE = new QFile(CMD_HISTORY_FILE_NAME);
@@ -471,7 +590,21 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
             "# "
             "---------------------------------------------------------------------------------\n");
         Statistics::get().initialize(this);
+        sim_start_time = time;
+        host_timer.start();
+        if (HOST_PROFILING) HostProfile::start();
         isCompletelyInitialized = true;
+        if (!trace_record_file.isEmpty()) {
+            sim_trace_record(trace_record_file.toStdString().c_str());
+        }
+        if (!timeline_file.isEmpty()) {
+            Timeline::get().open(timeline_file.toStdString().c_str(),
+                time,
+                vpro_clock_period,
+                hw_config.clusters,
+                hw_config.units,
+                hw_config.lanes);
+        }
         // return to main and simulate program in this thread
         return 0;
     }
@@ -517,7 +650,7 @@ int ISS::sim_init(int (*main_fkt)(int, char**), int& argc, char* argv[]) {
     connect(this, &ISS::simIsResumed, this, &ISS::sendSimUpdate);
 
     if (!windowless) {
-        w = new CommandWindow(VPRO_CFG::CLUSTERS, VPRO_CFG::UNITS, VPRO_CFG::LANES);
+        w = new CommandWindow(hw_config.clusters, hw_config.units, hw_config.lanes);
         connect(this, SIGNAL(dataUpdate(CommandWindow::Data)),
             w, SLOT(dataUpdate(CommandWindow::Data)));
         connect(this, SIGNAL(simIsFinished()), w, SLOT(simIsFinished()));
@@ -599,8 +732,34 @@ void ISS::sim_stats_reset() {
     emit stat_reset(time, stat_log);
 }
 
+void ISS::sim_timeline_begin(char const* name) {
+    if (Timeline::enabled) Timeline::get().markerBegin(name);
+    // miss classification per marker (e.g. layer)
+    if (hw_config.dcma_miss_classification) Statistics::get().getDCMAStat()->markerBegin(name);
+}
+
+void ISS::sim_timeline_end() {
+    if (Timeline::enabled) Timeline::get().markerEnd();
+    if (hw_config.dcma_miss_classification) Statistics::get().getDCMAStat()->markerEnd();
+}
+
+void ISS::stopClusterWorkers() {
+    if (cluster_barrier == nullptr) return;
+    for (size_t c = 1; c < clusters.size(); c++) {
+        clusters[c]->stopWorker();
+    }
+    // workers wait at the tick start, released once more to see the stop flag
+    cluster_barrier->wait();
+    for (size_t c = 1; c < clusters.size(); c++) {
+        clusters[c]->wait();
+    }
+    delete cluster_barrier;
+    cluster_barrier = nullptr;
+}
+
 void ISS::sim_stop(bool silent) {
     printf_info("Sim stop!\n");
+    if (trace_stream) sim_trace_record_stop();
     while (!sim_finished) {
         bool cluster_busy = false;
         for (auto cluster : clusters) {
@@ -612,6 +771,8 @@ void ISS::sim_stop(bool silent) {
         }
         break;
     }
+    stopClusterWorkers();
+    Timeline::get().close();
     sendSimUpdate();
     simPause();
 
@@ -697,7 +858,7 @@ void ISS::run() {
                 run();
                 return;
             }
-            if (((VPRO_CFG::CLUSTERS * VPRO_CFG::UNITS) < 10 && long(time) % 50000 == 0) ||
+            if (((hw_config.clusters * hw_config.units) < 10 && long(time) % 50000 == 0) ||
                 long(time) % 10000 == 0) {  // update gui clock every x ns
                 sendSimUpdate();
             }
@@ -730,6 +891,24 @@ void ISS::runUntilReadyForCmd() {
 #endif
     bool clusterClocking = false;
     while (true) {
+        if (isIdleSkipPossible()) {
+            // idle clusters are ready, next risc tick accepts the command
+            for (auto c : clusters) {
+                c->isReadyForCommand();
+            }
+            skipIdleRiscCycles(1);
+            break;
+        }
+        if (isWaitSkipPossible()) {
+            // readiness does not change until the memory transfer completes
+            clusterClocking = false;
+            for (auto c : clusters) {
+                clusterClocking |= !c->isReadyForCommand();
+            }
+            if (skipWaitRiscCycles(clusterClocking ? UINT32_MAX : 1) == 1 && !clusterClocking)
+                break;
+            continue;
+        }
         run();
 
         // check if any cluster is rdy for a cmd (queue not full, no dma|vpro wait_busy, loop not blocking)
@@ -766,8 +945,19 @@ void ISS::runUntilRiscReadyForCmd() {
 #ifndef ISS_STANDALONE
     printf_error("[ERROR] runUntilRiscReadyForCmd should never be called from SystemC VP!\n");
 #endif
+    if (isTracing()) traceStep();
     uint32_t io_cycle_counter = 0;
     while (true) {
+        if (isIdleSkipPossible()) {
+            skipIdleRiscCycles(uint32_t(risc_io_access_cycles) - io_cycle_counter);
+            break;
+        }
+        if (isWaitSkipPossible()) {
+            io_cycle_counter +=
+                skipWaitRiscCycles(uint32_t(risc_io_access_cycles) - io_cycle_counter);
+            if (io_cycle_counter == risc_io_access_cycles) break;
+            continue;
+        }
         run();
         if (risc_time > time) {
             continue;
@@ -812,6 +1002,139 @@ void ISS::risc_counter_tick() {
     if (!riscv_sync_waiting) aux_cnt_riscv_enabled++;
 }
 
+bool ISS::isIdle() {
+    if (!dmalooper->isIdle() || dmablock->isBusy()) return false;
+    if (!dcma->isIdle()) return false;
+    for (auto cluster : clusters) {
+        if (!cluster->isIdle()) return false;
+    }
+    return true;
+}
+
+bool ISS::isIdleSkipPossible() {
+#ifdef ISS_STANDALONE
+    if (!EVENT_DRIVEN_TIME_ADVANCE) return false;
+    if (!isCompletelyInitialized || sim_finished || !windowless || !isSimRunning()) return false;
+    if (debug & (DEBUG_TICK | DEBUG_GLOBAL_TICK)) return false;
+    return isIdle();
+#else
+    return false;
+#endif
+}
+
+void ISS::skipIdleRiscCycles(uint32_t risc_cycles) {
+#ifdef ISS_STANDALONE
+    uint64_t dcma_ticks = 0, axi_ticks = 0, risc_ticks = 0;
+    // same time stepping as in clk_tick() (floating point time compare)
+    while (risc_ticks < risc_cycles) {
+        time += iss_clock_tick_period;
+        for (auto cluster : clusters) {
+            cluster->tickIdle();
+        }
+        if (dcma_time <= time) {
+            dcma_time += dcma_clock_period;
+            dcma_ticks++;
+        }
+        if (axi_time <= time) {
+            axi_time += axi_clock_period;
+            axi_ticks++;
+        }
+        if (risc_time <= time) {
+            risc_time += risc_clock_period;
+            risc_ticks++;
+        }
+    }
+
+    for (auto cluster : clusters) {
+        cluster->applyIdleTicks();
+    }
+    dcma->tickIdle(dcma_ticks);
+    Statistics::get().tickIdle(Statistics::clock_domains::DCMA, dcma_ticks);
+    reinterpret_cast<NonBlockingMainMemory*>(bus)->tick(axi_ticks);
+    Statistics::get().tickIdle(Statistics::clock_domains::AXI, axi_ticks);
+
+    // risc_counter_tick() with no lane/dma busy
+    Statistics::get().tickIdle(Statistics::clock_domains::RISC, risc_ticks);
+    aux_cnt_vpro_total += risc_ticks;
+    aux_cnt_riscv_total += risc_ticks;
+    aux_sys_time += risc_ticks;
+    aux_cycle_counter += risc_ticks;
+    if (!riscv_sync_waiting) aux_cnt_riscv_enabled += risc_ticks;
+#endif
+}
+
+bool ISS::isWaitSkipPossible() {
+#ifdef ISS_STANDALONE
+    if (!EVENT_DRIVEN_TIME_ADVANCE) return false;
+    if (!isCompletelyInitialized || sim_finished || !windowless || !isSimRunning()) return false;
+    if (debug & (DEBUG_TICK | DEBUG_GLOBAL_TICK)) return false;
+    if (!dmalooper->isIdle() || dmablock->isBusy()) return false;
+    if (!dcma->isWaitingForMemory()) return false;
+    // the DCMA is the only bus master -> the pending transfer is the one the cache waits for
+    uint64_t axi_ticks = reinterpret_cast<NonBlockingMainMemory*>(bus)->ticksUntilCompletion();
+    if (axi_ticks == 0 || axi_ticks == UINT64_MAX) return false;
+    for (auto cluster : clusters) {
+        if (!cluster->isWaiting()) return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t ISS::skipWaitRiscCycles(uint32_t risc_cycles) {
+#ifdef ISS_STANDALONE
+    auto memory = reinterpret_cast<NonBlockingMainMemory*>(bus);
+    const uint64_t axi_cycles = memory->ticksUntilCompletion();
+    uint64_t dcma_ticks = 0, axi_ticks = 0;
+    uint32_t risc_ticks = 0;
+    // same time stepping as in clk_tick(), stops before the memory tick completing the transfer
+    while (risc_ticks < risc_cycles && axi_ticks < axi_cycles) {
+        time += iss_clock_tick_period;
+        for (auto cluster : clusters) {
+            cluster->tickWait();
+        }
+        if (dcma_time <= time) {
+            dcma_time += dcma_clock_period;
+            dcma_ticks++;
+            // consumes the stalls marked by the dma ticks of this cycle
+            Statistics::get().tick(Statistics::clock_domains::DCMA);
+        }
+        if (axi_time <= time) {
+            axi_time += axi_clock_period;
+            axi_ticks++;
+        }
+        if (risc_time <= time) {
+            risc_time += risc_clock_period;
+            risc_ticks++;
+        }
+    }
+
+    for (auto cluster : clusters) {
+        cluster->applyIdleTicks();
+    }
+    dcma->tickWait(dcma_ticks);
+    memory->tick(axi_ticks);
+    Statistics::get().tickIdle(Statistics::clock_domains::AXI, axi_ticks);
+
+    // risc_counter_tick() with no lane busy
+    bool any_dma_busy = false;
+    for (auto cluster : clusters) {
+        any_dma_busy |= cluster->dma->isBusy();
+    }
+    Statistics::get().tickIdle(Statistics::clock_domains::RISC, risc_ticks);
+    aux_cnt_vpro_total += risc_ticks;
+    if (any_dma_busy) aux_cnt_dma_act += risc_ticks;
+    aux_cnt_riscv_total += risc_ticks;
+    aux_sys_time += risc_ticks;
+    aux_cycle_counter += risc_ticks;
+    if (!riscv_sync_waiting) aux_cnt_riscv_enabled += risc_ticks;
+    return risc_ticks;
+#else
+    return 0;
+#endif
+}
+
 // ---------------------------------------------------------------------------------
 // Run simulation environment (one clock tick)
 // ---------------------------------------------------------------------------------
@@ -836,21 +1159,6 @@ void ISS::clk_tick() {
 
     if (debug & DEBUG_GLOBAL_TICK) printf("Time: %.2lf\n", time);
 
-#ifdef THREAD_CLUSTER
-    if (VPRO_CFG::CLUSTERS >= 2 && VPRO_CFG::UNITS >= 2) {
-        for (auto cluster : clusters) {
-            cluster->tick_en.unlock();
-        }
-        for (auto cluster : clusters) {
-            cluster->tick_done.lock();
-        }
-    } else {
-        for (auto cluster : clusters) {
-            cluster->tick();
-        }
-    }
-#else
-
 #ifndef ISS_STANDALONE
     while (1) {
         if (!sim_running) {
@@ -862,10 +1170,24 @@ void ISS::clk_tick() {
     }
 #endif
     // cascade to Lanes and DMAs
+    bool dma_tick = false, vpro_tick = false;
+    // DMAs access the DCMA -> sequential
     for (auto cluster : clusters) {
-        cluster->tick();
+        dma_tick = cluster->tickDMA();
     }
-#endif
+    if (cluster_barrier != nullptr) {
+        // units of cluster 0 on this thread, others on their worker thread
+        cluster_barrier->wait();
+        vpro_tick = clusters.front()->tickVPRO();
+        cluster_barrier->wait();
+    } else {
+        for (auto cluster : clusters) {
+            vpro_tick = cluster->tickVPRO();
+        }
+    }
+    if (dma_tick) Statistics::get().tick(Statistics::clock_domains::DMA);
+    if (vpro_tick) Statistics::get().tick(Statistics::clock_domains::VPRO);
+
     // check if time for clock tick is up
     if (dcma_time <= time) {
         if (debug & DEBUG_TICK)
@@ -873,7 +1195,10 @@ void ISS::clk_tick() {
                 dcma_time / dcma_clock_period,
                 dcma_time);
         dcma_time += dcma_clock_period;
-        dcma->tick();
+        {
+            HostTimer timer(HostProfile::DCMA_TICK);
+            dcma->tick();
+        }
         Statistics::get().tick(Statistics::clock_domains::DCMA);
     }
 #ifdef ISS_STANDALONE
@@ -883,7 +1208,10 @@ void ISS::clk_tick() {
                 axi_time / axi_clock_period,
                 axi_time);
         axi_time += axi_clock_period;
-        reinterpret_cast<NonBlockingMainMemory*>(bus)->tick();
+        {
+            HostTimer timer(HostProfile::AXI_TICK);
+            reinterpret_cast<NonBlockingMainMemory*>(bus)->tick();
+        }
         Statistics::get().tick(Statistics::clock_domains::AXI);
     }
 #endif
@@ -1005,17 +1333,51 @@ void ISS::printExitStats(bool silent) {
             "    -> dcma_flush();\n\n");
         printf_info("Generating Statistic Report...\n");
         Statistics::get().print();
+#ifdef ISS_STANDALONE
+        reinterpret_cast<NonBlockingMainMemory*>(bus)->printStatistics();
+#endif
+        if (HOST_PROFILING) HostProfile::print((time - sim_start_time) / risc_clock_period);
+    }
+
+    // one line summary of the simulator throughput (--benchmark, parsed by apps/benchmark)
+    if (benchmark) {
+        double host_s = double(host_timer.nsecsElapsed()) / 1e9;
+        double risc_cycles = (time - sim_start_time) / risc_clock_period;
+        struct rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        printf("#SIM_BENCHMARK: {\"clusters\":%u,\"units\":%u,\"lanes\":%u,\"simulated_ns\":%.0f,"
+               "\"risc_cycles\":%.0f,\"host_s\":%.6f,\"cycles_per_s\":%.0f,\"peak_rss_kb\":%ld}\n",
+            hw_config.clusters,
+            hw_config.units,
+            hw_config.lanes,
+            time - sim_start_time,
+            risc_cycles,
+            host_s,
+            host_s > 0 ? risc_cycles / host_s : 0.,
+            long(usage.ru_maxrss));
     }
 
     // dump to file
-    QFileInfo stat_file(QDir::currentPath() + "/" + dumpFileName);
+    const QString dump_suffix = QString::number(hw_config.clusters) + "C" +
+                                QString::number(hw_config.units) + "U" +
+                                QString::number(hw_config.lanes) + "L";
+    QFileInfo stat_file(QDir::currentPath() + "/" + dumpFileName + dump_suffix + ".log");
     if (!QDir(stat_file.absoluteDir().path()).exists()) {
         QDir(stat_file.absoluteDir().path()).mkpath(".");
         printf("Created new dir for stats: %s\n",
             stat_file.absoluteDir().path().toStdString().c_str());
     }
-    Statistics::get().dumpToFile(dumpFileName);
-    Statistics::get().dumpToJSONFile(dumpJSONFileName);
+    Statistics::get().dumpToFile(dumpFileName + dump_suffix + ".log");
+    Statistics::get().dumpToJSONFile(dumpJSONFileName + dump_suffix + ".json");
+
+    // digest of the simulation result (--state-digest): 64 bit FNV-1a of the output cfg data,
+    // the simulated time, the lane statistic counters and the local memories
+    uint64_t digest = 14695981039346656037ull;
+    auto hash = [&digest](const void* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            digest = (digest ^ static_cast<const uint8_t*>(data)[i]) * 1099511628211ull;
+        }
+    };
 
     // output cfg
     QFile file(outputcfg);
@@ -1056,20 +1418,20 @@ void ISS::printExitStats(bool silent) {
                 size);
 
         QFile outputfile(output);
-        uint64_t mm_addr = offset;
         if (outputfile.open(QFile::WriteOnly | QFile::Truncate)) {
-            for (int i = 0; i < size; i++) {
-                uint8_t buffer;
-                bus->dbgRead(mm_addr, &buffer);
-                outputfile.write((char*)&buffer, sizeof(buffer));
-                mm_addr++;
-                for (int si = 0; si < skip_pos.size(); si++) {
-                    if ((i + 1) % skip_pos[si] == 0) {
-                        mm_addr += skip_len[si];
-                    }
-                }
-            }
+            // gather the MM blocks, single write to the file
+            QByteArray buffer(int(size), Qt::Uninitialized);
+            auto buffer_ptr = reinterpret_cast<uint8_t*>(buffer.data());
+            forEachMMBlock(offset,
+                size,
+                skip_pos,
+                skip_len,
+                [&](uint64_t file_offset, uint64_t mm_addr, uint64_t length) {
+                    bus->dbgReadBlock(mm_addr, &buffer_ptr[file_offset], length);
+                });
+            outputfile.write(buffer);
             outputfile.close();
+            if (state_digest) hash(buffer_ptr, size);
         } else {
             printf_error("Error opening output file!");
             QTextStream(stdout) << outputfile.errorString();
@@ -1078,6 +1440,43 @@ void ISS::printExitStats(bool silent) {
 
     file.close();
 
+    if (state_digest) {
+        double simulated = time - sim_start_time;
+        hash(&simulated, sizeof(simulated));
+        for (const auto& count : Statistics::get().getVPROStat()->getLaneCounters()) {
+            hash(count.instructions, sizeof(count.instructions));
+            hash(count.cycles, sizeof(count.cycles));
+            uint64_t states[] = {
+                count.active, count.src_stall, count.dst_stall, count.inactive, count.blocking};
+            hash(states, sizeof(states));
+        }
+        for (auto cluster : clusters) {
+            for (auto unit : cluster->getUnits()) {
+                hash(unit->getLocalMemoryPtr(),
+                    hw_config.lm_size * (Unit::VectorUnit::LOCAL_MEMORY_DATA_WIDTH / 8));
+            }
+        }
+        // compared by apps/benchmark (--check-threads)
+        printf("#SIM_DIGEST: %016" PRIx64 "\n", digest);
+    }
+
+    if (functional_vpro) {
+        uint64_t hazards = 0;
+        for (auto cluster : clusters) {
+            for (auto unit : cluster->getUnits()) {
+                for (auto lane : unit->getLanes()) {
+                    hazards += lane->functional_hazards;
+                }
+            }
+        }
+        // zero: the lanes results are identical to the cycle model
+        if (hazards > 0)
+            printf_warning("[--functional] %" PRIu64 " register reads inside the pipeline hazard "
+                           "window, results depend on the pipeline timing (may differ from the "
+                           "cycle model)\n",
+                hazards);
+    }
+
     printf_info("# Calling exit Script '%s' ... ", exitscript.toStdString().c_str());
     std::ifstream exit_script(exitscript.toStdString().c_str());
     if (!exit_script) {
@@ -1091,8 +1490,13 @@ void ISS::printExitStats(bool silent) {
 
 void ISS::dbgMemWrite(intptr_t dst_addr, uint8_t* data_ptr) {
     bus->dbgWrite(dst_addr, data_ptr);
+    if (isTracing()) traceMemWrite(dst_addr, data_ptr, 1);
 }
 
 void ISS::dbgMemRead(intptr_t dst_addr, uint8_t* data_ptr) const {
     bus->dbgRead(dst_addr, data_ptr);
 }
+
+uint8_t* ISS::dbgMemPtr(intptr_t addr, uint64_t size) const {
+    return bus->dbgHostPtr(addr, size);
+}
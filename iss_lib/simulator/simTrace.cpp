@@ -0,0 +1,350 @@
+/*
+ *  * Copyright (c) 2024 Chair for Chip Design for Embedded Computing,
+ *                    Technische Universitaet Braunschweig, Germany
+ *                    www.tu-braunschweig.de/en/eis
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT
+ *
+ */
+/**
+ * @file simTrace.cpp
+ *
+ * VPRO instruction & system simulation library
+ * Command trace (record / replay) of the risc side of a simulation: drives the simulator without
+ * the application, e.g. to benchmark / profile the simulator itself. Format: helper/commandTrace.h
+ */
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <vector>
+
+#include <vpro/vpro_defs.h>
+
+#include "ISS.h"
+#include "helper/checkpoint.h"
+#include "helper/commandTrace.h"
+#include "helper/debugHelper.h"
+
+using namespace CommandTrace;
+
+template <typename T>
+static void writeRecord(QDataStream& out, RECORD type, const T& record) {
+    Checkpoint::write(out, type);
+    Checkpoint::write(out, record);
+}
+
+int ISS::sim_trace_record(char const* file_name) {
+    if (trace_stream) {
+        printf_error("#SIM: sim_trace_record: Already recording a command trace!\n");
+        return -1;
+    }
+    if (!isIdle()) {
+        printf_error(
+            "#SIM: sim_trace_record: VPRO/DMA busy! Call vpro_sync() before the recording.\n");
+        return -1;
+    }
+
+    trace_file = new QFile(file_name);
+    if (!trace_file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        printf_error("#SIM: sim_trace_record: Unable to open file %s!\n", file_name);
+        delete trace_file;
+        trace_file = nullptr;
+        return -1;
+    }
+    trace_stream = new QDataStream(trace_file);
+    trace_pending_steps = 0;
+
+    Checkpoint::write(*trace_stream, TraceHeader());
+    saveCheckpoint(*trace_stream);
+
+    printf_info("#SIM: Recording command trace to %s @Time %.0lf ns\n", file_name, time);
+    return 0;
+}
+
+void ISS::sim_trace_record_stop() {
+    if (!trace_stream) return;
+
+    traceFlushSteps();
+    Checkpoint::write(*trace_stream, END);
+
+    if (trace_stream->status() != QDataStream::Ok) {
+        printf_error("#SIM: sim_trace_record: Failed to write %s!\n",
+            trace_file->fileName().toStdString().c_str());
+    } else {
+        printf_info("#SIM: Command trace %s recorded (%lli Bytes) @Time %.0lf ns\n",
+            trace_file->fileName().toStdString().c_str(),
+            trace_file->size(),
+            time);
+    }
+    delete trace_stream;
+    trace_stream = nullptr;
+    trace_file->close();
+    delete trace_file;
+    trace_file = nullptr;
+}
+
+void ISS::traceFlushSteps() {
+    if (trace_pending_steps == 0) return;
+    writeRecord(*trace_stream, RISC_STEP, RiscStep{trace_pending_steps});
+    trace_pending_steps = 0;
+}
+
+void ISS::traceStep() {
+    trace_pending_steps++;
+}
+
+void ISS::traceIoWrite(uint32_t addr, uint32_t value) {
+    switch (addr) {
+        // command parameters: only the risc cycle of the io access, the command is recorded decoded
+        case VPRO_CMD_REGISTER_3_0_ADDR:
+        case VPRO_CMD_REGISTER_3_1_ADDR:
+        case VPRO_CMD_REGISTER_4_2_ADDR:
+        case IDMA_UNIT_MASK_ADDR:
+        case IDMA_CLUSTER_MASK_ADDR:
+        case IDMA_LOC_ADDR_ADDR:
+        case IDMA_X_BLOCK_SIZE_ADDR:
+        case IDMA_Y_BLOCK_SIZE_ADDR:
+        case IDMA_X_STRIDE_ADDR:
+        case IDMA_PAD_ACTIVATION_ADDR:
+        case IDMA_COMMAND_BLOCK_SIZE_ADDR:
+            traceStep();
+            break;
+
+        // upper 32-bit of host addresses (no risc cycle), part of the triggered command
+        case IDMA_EXT_BASE_ADDR_E2L_ADDR + 1:
+        case IDMA_EXT_BASE_ADDR_L2E_ADDR + 1:
+        case IDMA_COMMAND_BLOCK_ADDR_TRIGGER_ADDR + 1:
+        case IDMA_COMMAND_DCACHE_ADDR + 1:
+            break;
+
+        case VPRO_CMD_REGISTER_3_2_ADDR:
+        case VPRO_CMD_REGISTER_4_3_ADDR:
+            traceFlushSteps();
+            writeRecord(*trace_stream, VPRO_CMD, io_vpro_cmd_register);
+            break;
+
+        case IDMA_EXT_BASE_ADDR_E2L_ADDR:
+        case IDMA_EXT_BASE_ADDR_L2E_ADDR:
+            traceFlushSteps();
+            writeRecord(*trace_stream, DMA_CMD, DmaCmd{addr});
+            Checkpoint::write(*trace_stream, io_dma_cmd_register);
+            if (uint64_t(io_dma_cmd_register.ext) >= hw_config.mm_size) {
+                printf_warning(
+                    "#SIM: command trace: DMA of host memory (0x%lx) is not part of the trace!\n",
+                    uint64_t(io_dma_cmd_register.ext));
+            }
+            break;
+
+        case IDMA_COMMAND_BLOCK_ADDR_TRIGGER_ADDR:
+        case IDMA_COMMAND_DCACHE_ADDR: {
+            DmaBlock block{
+                dmablock->getAddr(), dmablock->getSize(), (dmablock->getAddr() >> 32) != 0};
+            traceFlushSteps();
+            writeRecord(*trace_stream, DMA_BLOCK, block);
+            if (block.host) {
+                // commands in host memory (e.g. the eisvblob), read lazily by the block extractor
+                Checkpoint::writeArray(
+                    *trace_stream, (const uint8_t*)block.addr, uint64_t(block.size) * 32);
+            }
+            break;
+        }
+
+        default:
+            traceFlushSteps();
+            writeRecord(*trace_stream, IO_WRITE, IoWrite{addr, value});
+            break;
+    }
+}
+
+void ISS::traceIoRead(uint32_t addr, uint32_t value) {
+    traceFlushSteps();
+    writeRecord(*trace_stream, IO_READ, IoRead{addr, value});
+}
+
+void ISS::traceIoWait(uint32_t addr, uint32_t mask, bool risc_step) {
+    traceFlushSteps();
+    writeRecord(*trace_stream, IO_WAIT, IoWait{addr, mask, risc_step});
+}
+
+void ISS::traceWaiting(bool waiting) {
+    traceFlushSteps();
+    writeRecord(*trace_stream, WAITING, Waiting{waiting});
+}
+
+void ISS::traceMemWrite(uint64_t addr, const uint8_t* data, uint64_t size) {
+    traceFlushSteps();
+    writeRecord(*trace_stream, MM_WRITE, MmWrite{addr, size});
+    Checkpoint::writeArray(*trace_stream, data, size);
+}
+
+void ISS::traceMemSet(uint64_t addr, uint8_t value, uint64_t size) {
+    traceFlushSteps();
+    writeRecord(*trace_stream, MM_SET, MmSet{addr, size, value});
+}
+
+int ISS::sim_trace_replay(char const* file_name) {
+    QString name = (file_name != nullptr) ? QString(file_name) : trace_replay_file;
+    if (name.isEmpty()) {
+        printf_error("#SIM: sim_trace_replay: No trace file (--replay-trace=<file>)!\n");
+        return -1;
+    }
+    if (trace_stream) {
+        printf_error("#SIM: sim_trace_replay: Not possible while recording a command trace!\n");
+        return -1;
+    }
+    if (!isIdle()) {
+        printf_error(
+            "#SIM: sim_trace_replay: VPRO/DMA busy! Call vpro_sync() before the replay.\n");
+        return -1;
+    }
+
+    QFile file(name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printf_error(
+            "#SIM: sim_trace_replay: Unable to open file %s!\n", name.toStdString().c_str());
+        return -1;
+    }
+    QDataStream in(&file);
+
+    TraceHeader header;
+    Checkpoint::read(in, header);
+    if (header.magic != MAGIC || header.version != VERSION) {
+        printf_error("#SIM: sim_trace_replay: %s is no command trace of this version!\n",
+            name.toStdString().c_str());
+        return -1;
+    }
+    if (!restoreCheckpoint(in, name.toStdString().c_str())) return -1;
+
+    printf_info(
+        "#SIM: Replaying command trace %s @Time %.0lf ns\n", name.toStdString().c_str(), time);
+    const double start_time = time;
+    QElapsedTimer wall;
+    wall.start();
+
+    // DMA commands from host memory, read lazily by the block extractor
+    std::vector<std::vector<uint8_t>> host_commands;
+    uint64_t records = 0, vpro_cmds = 0, dma_cmds = 0, read_mismatches = 0;
+    bool end = false;
+    while (!end) {
+        RECORD type;
+        Checkpoint::read(in, type);
+        if (in.status() != QDataStream::Ok) {
+            printf_error("#SIM: sim_trace_replay: %s is incomplete (no END record)!\n",
+                name.toStdString().c_str());
+            return -1;
+        }
+        records++;
+
+        switch (type) {
+            case IO_WRITE: {
+                IoWrite r{};
+                Checkpoint::read(in, r);
+                io_write(r.addr, r.value);
+                break;
+            }
+            case IO_READ: {
+                IoRead r{};
+                Checkpoint::read(in, r);
+                if (io_read(r.addr) != r.value) read_mismatches++;
+                break;
+            }
+            case IO_WAIT: {
+                IoWait r{};
+                Checkpoint::read(in, r);
+                io_wait(r.addr, r.mask, r.risc_step);
+                break;
+            }
+            case RISC_STEP: {
+                RiscStep r{};
+                Checkpoint::read(in, r);
+                for (uint32_t i = 0; i < r.count; i++) runUntilRiscReadyForCmd();
+                break;
+            }
+            case VPRO_CMD: {
+                Checkpoint::read(in, io_vpro_cmd_register);
+                runUntilRiscReadyForCmd();
+                run_vpro_instruction(gen_io_vpro_command());
+                vpro_cmds++;
+                break;
+            }
+            case DMA_CMD: {
+                DmaCmd r{};
+                Checkpoint::read(in, r);
+                Checkpoint::read(in, io_dma_cmd_register);
+                runUntilRiscReadyForCmd();
+                run_dma_instruction(
+                    gen_io_dma_command(r.trigger_addr == IDMA_EXT_BASE_ADDR_L2E_ADDR));
+                dma_cmds++;
+                break;
+            }
+            case DMA_BLOCK: {
+                DmaBlock r{};
+                Checkpoint::read(in, r);
+                uint64_t addr = r.addr;
+                if (r.host) {
+                    host_commands.emplace_back(uint64_t(r.size) * 32);
+                    auto& commands = host_commands.back();
+                    Checkpoint::readArray(in, commands.data(), commands.size());
+                    addr = uint64_t(intptr_t(commands.data()));
+                    assert((addr >> 32) != 0 && "host pointer in the 32-bit main memory range");
+                }
+                runUntilRiscReadyForCmd();
+                dmablock->newSize(r.size);
+                dmablock->newAddrTrigger(uint32_t(addr >> 32), 32);
+                dmablock->newAddrTrigger(uint32_t(addr), 0);
+                dma_cmds += r.size;
+                break;
+            }
+            case MM_WRITE: {
+                MmWrite r{};
+                Checkpoint::read(in, r);
+                std::vector<uint8_t> data(r.size);
+                Checkpoint::readArray(in, data.data(), r.size);
+                bus->dbgWriteBlock(intptr_t(r.addr), data.data(), r.size);
+                break;
+            }
+            case MM_SET: {
+                MmSet r{};
+                Checkpoint::read(in, r);
+                std::vector<uint8_t> data(r.size, r.value);
+                bus->dbgWriteBlock(intptr_t(r.addr), data.data(), r.size);
+                break;
+            }
+            case WAITING: {
+                Waiting r{};
+                Checkpoint::read(in, r);
+                setWaitingToFinish(r.waiting);
+                break;
+            }
+            case END:
+                end = true;
+                break;
+            default:
+                printf_error("#SIM: sim_trace_replay: Unknown record type %i in %s!\n",
+                    int(type),
+                    name.toStdString().c_str());
+                return -1;
+        }
+    }
+
+    const double seconds = double(wall.nsecsElapsed()) * 1e-9;
+    const double risc_cycles = (time - start_time) / risc_clock_period;
+    printf_info(
+        "#SIM: Command trace replayed: %lu records (%lu VPRO, %lu DMA commands), %.0lf ns "
+        "simulated (%.0lf risc cycles) in %.3lf s wall time = %.0lf risc cycles/s\n",
+        records,
+        vpro_cmds,
+        dma_cmds,
+        time - start_time,
+        risc_cycles,
+        seconds,
+        seconds > 0 ? risc_cycles / seconds : 0.);
+    if (read_mismatches) {
+        printf_warning("#SIM: sim_trace_replay: %lu io reads differ from the recording!\n",
+            read_mismatches);
+    }
+    return 0;
+}